@@ -0,0 +1,270 @@
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include <tiny_gltf.h>
+
+#include "animation/animation_manager.h"
+#include "animation/animator.h"
+
+#include "bench.h"
+
+static int addFloatAccessor(tinygltf::Model &model, const std::vector<float> &values, int type, size_t count)
+{
+    std::vector<unsigned char> &data = model.buffers[0].data;
+
+    tinygltf::BufferView view;
+    view.buffer = 0;
+    view.byteOffset = data.size();
+    view.byteLength = values.size() * sizeof(float);
+    data.resize(data.size() + view.byteLength);
+    memcpy(data.data() + view.byteOffset, values.data(), view.byteLength);
+    model.bufferViews.push_back(view);
+
+    tinygltf::Accessor accessor;
+    accessor.bufferView = (int)model.bufferViews.size() - 1;
+    accessor.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+    accessor.type = type;
+    accessor.count = count;
+    model.accessors.push_back(accessor);
+
+    return (int)model.accessors.size() - 1;
+}
+
+static void addChannel(tinygltf::Model &model, tinygltf::Animation &animation, int node, const char *path, int times, int values)
+{
+    tinygltf::AnimationSampler sampler;
+    sampler.input = times;
+    sampler.output = values;
+    animation.samplers.push_back(sampler);
+
+    tinygltf::AnimationChannel channel;
+    channel.sampler = (int)animation.samplers.size() - 1;
+    channel.target_node = node;
+    channel.target_path = path;
+    animation.channels.push_back(channel);
+}
+
+// Binary tree skeleton with one skin, every clip animates TRS of every joint over one second
+static tinygltf::Model makeSkinnedModel(int boneCount, int clipCount, int keyCount)
+{
+    tinygltf::Model model;
+    model.buffers.resize(1);
+
+    tinygltf::Skin skin;
+    skin.skeleton = 0;
+    for (int i = 0; i < boneCount; i++)
+    {
+        tinygltf::Node node;
+        node.name = "bone_" + std::to_string(i);
+        node.translation = {0.0, 0.1, 0.0};
+        model.nodes.push_back(node);
+        skin.joints.push_back(i);
+
+        if (i > 0)
+            model.nodes[(i - 1) / 2].children.push_back(i);
+    }
+    model.skins.push_back(skin);
+
+    tinygltf::Scene scene;
+    scene.nodes.push_back(0);
+    model.scenes.push_back(scene);
+    model.defaultScene = 0;
+
+    for (int c = 0; c < clipCount; c++)
+    {
+        tinygltf::Animation animation;
+        animation.name = "clip_" + std::to_string(c);
+
+        std::vector<float> times(keyCount);
+        for (int k = 0; k < keyCount; k++)
+            times[k] = keyCount > 1 ? (float)k / (keyCount - 1) : 0.f;
+        int timeAccessor = addFloatAccessor(model, times, TINYGLTF_TYPE_SCALAR, keyCount);
+
+        for (int b = 0; b < boneCount; b++)
+        {
+            std::vector<float> translations, rotations, scales;
+            for (int k = 0; k < keyCount; k++)
+            {
+                float phase = times[k] * 6.283f + b * 0.1f + c;
+                translations.insert(translations.end(), {std::sin(phase) * 0.1f, 0.1f, 0.f});
+
+                glm::quat q = glm::angleAxis(std::sin(phase), glm::normalize(glm::vec3(1.f, 0.5f, 0.25f)));
+                rotations.insert(rotations.end(), {q.x, q.y, q.z, q.w});
+                scales.insert(scales.end(), {1.f, 1.f + 0.1f * std::cos(phase), 1.f});
+            }
+
+            addChannel(model, animation, b, "translation", timeAccessor, addFloatAccessor(model, translations, TINYGLTF_TYPE_VEC3, keyCount));
+            addChannel(model, animation, b, "rotation", timeAccessor, addFloatAccessor(model, rotations, TINYGLTF_TYPE_VEC4, keyCount));
+            addChannel(model, animation, b, "scale", timeAccessor, addFloatAccessor(model, scales, TINYGLTF_TYPE_VEC3, keyCount));
+        }
+
+        model.animations.push_back(animation);
+    }
+
+    return model;
+}
+
+static std::vector<Animation *> makeAnimations(const tinygltf::Model &model)
+{
+    std::vector<Animation *> animations;
+    for (int i = 0; i < (int)model.animations.size(); i++)
+        animations.push_back(new Animation(model, i, 0));
+    return animations;
+}
+
+static void benchAnimator(Bench &bench, int boneCount, int clipCount)
+{
+    tinygltf::Model model = makeSkinnedModel(boneCount, clipCount, 32);
+    std::vector<Animation *> animations = makeAnimations(model);
+
+    Animator animator(animations);
+    for (Animation *animation : animations)
+        animator.addStateAnimation(animation)->m_blendFactor = 1.f / clipCount;
+
+    std::string suffix = " bones=" + std::to_string(boneCount) + " clips=" + std::to_string(clipCount);
+
+    bench.run("Animator::update" + suffix, 1, [&]() {
+        animator.update(1.f / 60.f);
+        doNotOptimize(animator.m_finalBoneMatrices[0]);
+    });
+
+    bench.run("Animator::calculateBoneTransforms" + suffix, 1, [&]() {
+        animator.calculateBoneTransforms();
+        doNotOptimize(animator.m_finalBoneMatrices[0]);
+    });
+
+    for (Animation *animation : animations)
+        delete animation;
+}
+
+// Characters of one rig at different phases, as in a crowd
+static void benchAnimationManager(Bench &bench, int characterCount)
+{
+    tinygltf::Model model = makeSkinnedModel(64, 2, 32);
+    std::vector<Animation *> animations = makeAnimations(model);
+
+    AnimationManager manager;
+    std::vector<Animator *> animators;
+    for (int i = 0; i < characterCount; i++)
+    {
+        Animator *animator = new Animator(animations);
+        animator->m_startOffset = i * 0.01f;
+        for (Animation *animation : animations)
+            animator->addStateAnimation(animation)->m_blendFactor = 0.5f;
+        animator->update(i * 0.01f);
+
+        manager.add(animator);
+        animators.push_back(animator);
+    }
+
+    std::string suffix = " characters=" + std::to_string(characterCount);
+
+    manager.m_parallel = false;
+    bench.run("AnimationManager::update serial" + suffix, characterCount, [&]() {
+        manager.update(1.f / 60.f);
+        doNotOptimize(animators[0]->m_finalBoneMatrices[0]);
+    });
+
+    manager.m_parallel = true;
+    bench.run("AnimationManager::update parallel" + suffix, characterCount, [&]() {
+        manager.update(1.f / 60.f);
+        doNotOptimize(animators[0]->m_finalBoneMatrices[0]);
+    });
+
+    for (Animator *animator : animators)
+        delete animator;
+    for (Animation *animation : animations)
+        delete animation;
+}
+
+static void benchBone(Bench &bench, int keyCount)
+{
+    tinygltf::Model model = makeSkinnedModel(1, 1, keyCount);
+    std::vector<Animation *> animations = makeAnimations(model);
+    const Bone *bone = animations[0]->getBone("bone_0");
+
+    // Random access, as with many characters at different phases
+    const int sampleCount = 4096;
+    std::vector<float> samples(sampleCount);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(0.f, animations[0]->m_duration);
+    for (float &t : samples)
+        t = dist(rng);
+
+    std::string suffix = " keys=" + std::to_string(keyCount);
+
+    bench.run("Bone::interpolatePosition" + suffix, sampleCount, [&]() {
+        for (float t : samples)
+            doNotOptimize(bone->interpolatePosition(t));
+    });
+
+    bench.run("Bone::interpolateRotation" + suffix, sampleCount, [&]() {
+        for (float t : samples)
+            doNotOptimize(bone->interpolateRotation(t));
+    });
+
+    bench.run("Bone::interpolateScaling" + suffix, sampleCount, [&]() {
+        for (float t : samples)
+            doNotOptimize(bone->interpolateScaling(t));
+    });
+
+    // Playback order, every lookup is at or just after the previous one
+    std::vector<float> sequence(sampleCount);
+    for (int i = 0; i < sampleCount; i++)
+        sequence[i] = animations[0]->m_duration * i / sampleCount;
+
+    bench.run("Bone::interpolateRotation sequential" + suffix, sampleCount, [&]() {
+        for (float t : sequence)
+            doNotOptimize(bone->interpolateRotation(t));
+    });
+
+    bench.run("Bone::interpolateRotation cursor" + suffix, sampleCount, [&]() {
+        int cursor = 0;
+        for (float t : sequence)
+            doNotOptimize(bone->interpolateRotation(t, &cursor));
+    });
+
+    AnimationImportSettings settings;
+    settings.sampleRate = 30.f;
+    Animation resampled(model, 0, 0, settings);
+    const Bone *resampledBone = resampled.getBone("bone_0");
+
+    bench.run("Bone::interpolateRotation resampled=30" + suffix, sampleCount, [&]() {
+        for (float t : samples)
+            doNotOptimize(resampledBone->interpolateRotation(t));
+    });
+
+    settings = AnimationImportSettings();
+    settings.compress = true;
+    Animation compressed(model, 0, 0, settings);
+    const Bone *compressedBone = compressed.getBone("bone_0");
+
+    bench.run("Bone::interpolateRotation compressed" + suffix, sampleCount, [&]() {
+        for (float t : samples)
+            doNotOptimize(compressedBone->interpolateRotation(t));
+    });
+
+    bench.run("Bone::interpolateRotation compressed cursor" + suffix, sampleCount, [&]() {
+        int cursor = 0;
+        for (float t : sequence)
+            doNotOptimize(compressedBone->interpolateRotation(t, &cursor));
+    });
+
+    delete animations[0];
+}
+
+void runAnimationBenchmarks(Bench &bench)
+{
+    for (int boneCount : {16, 64, 128})
+    {
+        for (int clipCount : {1, 2, 4})
+            benchAnimator(bench, boneCount, clipCount);
+    }
+
+    for (int characterCount : {16, 256})
+        benchAnimationManager(bench, characterCount);
+
+    for (int keyCount : {4, 64, 1024})
+        benchBone(bench, keyCount);
+}
@@ -0,0 +1,43 @@
+#include "bench.h"
+
+#include <cstdio>
+
+#include <SDL3/SDL_timer.h>
+
+void Bench::run(const std::string &name, Uint64 opsPerBatch, const std::function<void()> &batch)
+{
+    if (!m_filter.empty() && name.find(m_filter) == std::string::npos)
+        return;
+
+    // Warm up caches and lazy allocations
+    batch();
+
+    Uint64 batches = 1;
+    Uint64 elapsed = 0;
+    while (true)
+    {
+        Uint64 start = SDL_GetTicksNS();
+        for (Uint64 i = 0; i < batches; i++)
+            batch();
+        elapsed = SDL_GetTicksNS() - start;
+
+        if (elapsed >= (Uint64)(m_minTime * 1e9) || batches >= (1ull << 30))
+            break;
+        batches *= 2;
+    }
+
+    double ops = (double)batches * opsPerBatch;
+    BenchResult result;
+    result.name = name;
+    result.nsPerOp = elapsed / ops;
+    result.opsPerSecond = ops / (elapsed / 1e9);
+    m_results.push_back(result);
+
+    printf("%-56s %12.2f ns/op %12.3f Mops/s\n", name.c_str(), result.nsPerOp, result.opsPerSecond / 1e6);
+    fflush(stdout);
+}
+
+void Bench::printSummary() const
+{
+    printf("%d benchmarks\n", (int)m_results.size());
+}
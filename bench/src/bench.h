@@ -0,0 +1,43 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+struct BenchResult
+{
+    std::string name;
+    double nsPerOp;
+    double opsPerSecond;
+};
+
+// Runs each benchmark in growing batches until it took at least m_minTime
+class Bench
+{
+public:
+    std::string m_filter; // substring of the names to run
+    double m_minTime = 0.25; // seconds
+    std::vector<BenchResult> m_results;
+
+    // batch performs opsPerBatch operations
+    void run(const std::string &name, Uint64 opsPerBatch, const std::function<void()> &batch);
+    void printSummary() const;
+};
+
+// Keeps the compiler from dropping a computation whose result is unused
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+void runAnimationBenchmarks(Bench &bench);
+void runGeometryBenchmarks(Bench &bench);
+void runShadowBenchmarks(Bench &bench);
@@ -0,0 +1,141 @@
+#include <cstdint>
+#include <random>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "frustum.h"
+#include "post_process/screen_mask.h"
+#include "resource_manager/resource_manager.h"
+
+#include "bench.h"
+
+static void benchFrustum(Bench &bench)
+{
+    const int count = 65536;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-100.f, 100.f);
+    std::uniform_real_distribution<float> extent(0.1f, 5.f);
+
+    std::vector<glm::vec3> centers(count);
+    std::vector<float> radii(count);
+    for (int i = 0; i < count; i++)
+    {
+        centers[i] = glm::vec3(position(rng), position(rng), position(rng));
+        radii[i] = extent(rng);
+    }
+
+    const glm::mat4 projection = glm::perspective(glm::radians(45.f), 16.f / 9.f, 0.1f, 1000.f);
+    const int matrixCount = 1024;
+    std::vector<glm::mat4> viewProjections(matrixCount);
+    for (int i = 0; i < matrixCount; i++)
+    {
+        float angle = i * 0.01f;
+        glm::vec3 eye(glm::sin(angle) * 50.f, 10.f, glm::cos(angle) * 50.f);
+        viewProjections[i] = projection * glm::lookAt(eye, glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+    }
+
+    bench.run("Frustum::fromMatrix", matrixCount, [&]() {
+        for (const glm::mat4 &vp : viewProjections)
+            doNotOptimize(Frustum::fromMatrix(vp));
+    });
+
+    const Frustum frustum = Frustum::fromMatrix(viewProjections[0]);
+
+    bench.run("Frustum::intersectsSphere", count, [&]() {
+        int visible = 0;
+        for (int i = 0; i < count; i++)
+            visible += frustum.intersectsSphere(centers[i], radii[i]);
+        doNotOptimize(visible);
+    });
+
+    bench.run("Frustum::intersectsAABB", count, [&]() {
+        int visible = 0;
+        for (int i = 0; i < count; i++)
+            visible += frustum.intersectsAABB(centers[i] - radii[i], centers[i] + radii[i]);
+        doNotOptimize(visible);
+    });
+}
+
+static void benchTangents(Bench &bench)
+{
+    // Grid mesh, vertex count is the op count
+    const int size = 256;
+    std::vector<Vertex> vertices(size * size);
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            Vertex &v = vertices[y * size + x];
+            v.position = glm::vec3(x, glm::sin(x * 0.1f) * glm::cos(y * 0.1f), y);
+            v.normal = glm::vec3(0.f, 1.f, 0.f);
+            v.uv = glm::vec2(x, y) / (float)size;
+        }
+    }
+
+    std::vector<uint32_t> indices;
+    for (int y = 0; y + 1 < size; y++)
+    {
+        for (int x = 0; x + 1 < size; x++)
+        {
+            uint32_t i = y * size + x;
+            indices.insert(indices.end(), {i, i + size, i + 1, i + 1, i + size, i + size + 1});
+        }
+    }
+
+    bench.run("CalculateTangents vertices=65536", vertices.size(), [&]() {
+        CalculateTangents(vertices, indices);
+        doNotOptimize(vertices[0].tangent);
+    });
+}
+
+static void benchConvertToRGBA(Bench &bench)
+{
+    const int width = 1024;
+    const int height = 1024;
+    std::vector<uint8_t> source(width * height * 3);
+    for (size_t i = 0; i < source.size(); i++)
+        source[i] = (uint8_t)(i * 31);
+
+    for (int components : {1, 3})
+    {
+        bench.run("ConvertToRGBA components=" + std::to_string(components), width * height, [&]() {
+            std::vector<uint8_t> rgba = ConvertToRGBA(source.data(), width, height, components);
+            doNotOptimize(rgba.data());
+        });
+    }
+}
+
+static void benchScreenMask(Bench &bench)
+{
+    const int count = 1024;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-20.f, 20.f);
+    std::uniform_real_distribution<float> extent(0.1f, 3.f);
+
+    std::vector<glm::vec3> mins(count), maxs(count);
+    for (int i = 0; i < count; i++)
+    {
+        mins[i] = glm::vec3(position(rng), position(rng), position(rng));
+        maxs[i] = mins[i] + glm::vec3(extent(rng), extent(rng), extent(rng));
+    }
+
+    const glm::mat4 viewProjection = glm::perspective(glm::radians(45.f), 16.f / 9.f, 0.1f, 1000.f) *
+                                     glm::lookAt(glm::vec3(0.f, 5.f, 40.f), glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+
+    MaskTexture<64, 64> mask;
+    bench.run("MaskTexture<64, 64>::fillProjectedAABB", count, [&]() {
+        mask.clear(0);
+        for (int i = 0; i < count; i++)
+            mask.fillProjectedAABB(glm::value_ptr(viewProjection), glm::value_ptr(mins[i]), glm::value_ptr(maxs[i]));
+        doNotOptimize(mask.getData()[0]);
+    });
+}
+
+void runGeometryBenchmarks(Bench &bench)
+{
+    benchFrustum(bench);
+    benchTangents(bench);
+    benchConvertToRGBA(bench);
+    benchScreenMask(bench);
+}
@@ -0,0 +1,26 @@
+#include <cstdlib>
+#include <cstring>
+
+#include "bench.h"
+
+// CPU kernels in isolation on synthetic inputs, no window or GPU needed
+// Usage: bench [--filter <substring>] [--min-time <seconds>]
+int main(int argc, char **argv)
+{
+    Bench bench;
+
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "--filter") == 0)
+            bench.m_filter = argv[++i];
+        else if (strcmp(argv[i], "--min-time") == 0)
+            bench.m_minTime = atof(argv[++i]);
+    }
+
+    runAnimationBenchmarks(bench);
+    runGeometryBenchmarks(bench);
+    runShadowBenchmarks(bench);
+
+    bench.printSummary();
+    return 0;
+}
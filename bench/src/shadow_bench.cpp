@@ -0,0 +1,33 @@
+#include <SDL3/SDL_log.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "shadow_manager/shadow_manager.h"
+
+#include "bench.h"
+
+void runShadowBenchmarks(Bench &bench)
+{
+    // Without a device the GPU resources fail to create, the cascade math does not use them
+    SDL_SetLogPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_CRITICAL);
+    ShadowManager shadowManager;
+    SDL_ResetLogPriorities();
+
+    Camera camera;
+    const float aspect = 16.f / 9.f;
+    camera.projection = glm::perspective(glm::radians(camera.fov), aspect, camera.near, camera.far);
+
+    const glm::vec3 lightDir = glm::normalize(glm::vec3(-0.3f, -1.f, -0.2f));
+    int frame = 0;
+
+    bench.run("ShadowManager::updateCascades", 1, [&]() {
+        // Moving camera, so the cascades are not skipped as unchanged
+        float angle = (frame++ % 360) * 0.0174533f;
+        camera.position = glm::vec3(glm::sin(angle) * 10.f, 2.f, glm::cos(angle) * 10.f);
+        camera.front = glm::normalize(-camera.position);
+        glm::mat4 view = glm::lookAt(camera.position, camera.position + camera.front, camera.up);
+
+        shadowManager.updateCascades(&camera, view, lightDir, aspect);
+        doNotOptimize(shadowManager.m_cascades[0].view);
+    });
+}
@@ -5,6 +5,7 @@
 
 #include "default_runner.h"
 
+#include "benchmark/benchmark.h"
 #include "render_manager/render_manager.h"
 #include "resource_manager/renderable_model.h"
 #include "resource_manager/resource_manager.h"
@@ -48,14 +49,17 @@ SDL_AppResult SDL_AppInit(void **appstate, int argc, char **argv)
     g_hdrTexture = resourceManager->loadTextureFromFile(params, std::string(exePath + "/" + hdriPath));
     renderManager->m_pbrManager->updateEnvironmentTexture(g_hdrTexture.id);
 
-    // load asset
-    const char *modelPath = "assets/models/DamagedHelmet.glb";
-    ModelData *model = resourceManager->loadModel(std::string(exePath + "/" + modelPath).c_str());
+    // load asset, benchmarks may replay another scene
+    std::string modelPath = exePath + "/assets/models/DamagedHelmet.glb";
+    if (runner->m_benchmark && !runner->m_benchmark->m_settings.scenePath.empty())
+        modelPath = runner->m_benchmark->m_settings.scenePath;
+    ModelData *model = resourceManager->loadModel(modelPath);
 
     // create RenderableModel instance
     if (model)
     {
         RenderableModel *renderable = new RenderableModel(model, renderManager);
+        renderable->m_staticShadowCaster = true;
         renderManager->addRenderable(renderable);
         g_renderableModels.push_back(renderable);
     }
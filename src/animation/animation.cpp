@@ -36,7 +36,8 @@ glm::mat4 GetLocalMatrix(const tinygltf::Node &node)
 
 Animation::Animation(const tinygltf::Model &model,
                      int animationIndex,
-                     int skinIndex)
+                     int skinIndex,
+                     const AnimationImportSettings &settings)
 {
     const tinygltf::Animation &anim = model.animations[animationIndex];
     const tinygltf::Skin &skin = model.skins[skinIndex];
@@ -73,6 +74,8 @@ Animation::Animation(const tinygltf::Model &model,
     for (auto &[name, ptr] : nodeMap)
         m_nodes[name] = reinterpret_cast<GltfNodeData *>(ptr);
 
+    buildSkeleton(m_rootNode, -1);
+
     // 3) Build Bone objects from animation channels
     // Build node name -> index map once (outside this loop if possible)
     std::unordered_map<std::string, int> nodeNameToIndex;
@@ -90,7 +93,23 @@ Animation::Animation(const tinygltf::Model &model,
         if (it == nodeNameToIndex.end())
             continue;
 
-        m_bones[boneName] = new Bone(boneName, boneInfo.id, model, anim, it->second);
+        Bone *bone = new Bone(boneName, boneInfo.id, model, anim, it->second);
+        bone->resample(settings.sampleRate, m_duration);
+        m_bones[boneName] = bone;
+    }
+
+    if (settings.compress)
+    {
+        m_clip.m_duration = m_duration;
+        for (auto &[boneName, bone] : m_bones)
+            bone->compress(m_clip, settings.positionTolerance, settings.rotationTolerance, settings.scaleTolerance);
+        m_clip.finish();
+
+        // Evaluation only needs the skeleton
+        for (auto &[name, node] : m_nodes)
+            delete node;
+        m_nodes.clear();
+        m_rootNode = nullptr;
     }
 }
 
@@ -193,6 +212,22 @@ void Animation::ReadHierarchyFromGltf(GltfNodeData *dest,
     }
 }
 
+void Animation::buildSkeleton(const GltfNodeData *node, int parent)
+{
+    // Depth first, so a parent is always evaluated before its children
+    int index = m_skeleton.size();
+    m_skeleton.m_names.push_back(node->name);
+    m_skeleton.m_parents.push_back(parent);
+    m_skeleton.m_localTransforms.push_back(node->transformation);
+
+    auto it = m_boneInfoMap.find(node->name);
+    m_skeleton.m_boneIds.push_back(it != m_boneInfoMap.end() ? it->second.id : -1);
+    m_skeleton.m_offsets.push_back(it != m_boneInfoMap.end() ? it->second.offset : glm::mat4(1.0f));
+
+    for (const GltfNodeData *child : node->children)
+        buildSkeleton(child, index);
+}
+
 void Animation::setBlendMask(std::unordered_map<std::string, float> blendMask, float defaultValue)
 {
     m_blendMask = blendMask;
@@ -28,12 +28,34 @@ struct BoneInfo
     glm::mat4 offset;
 };
 
+// The node hierarchy flattened at load, parents come before their children
+struct Skeleton
+{
+    std::vector<std::string> m_names;
+    std::vector<int> m_parents; // -1 for the root
+    std::vector<glm::mat4> m_localTransforms;
+    std::vector<int> m_boneIds; // skin joint, -1 for nodes that are not joints
+    std::vector<glm::mat4> m_offsets;
+
+    int size() const { return (int)m_parents.size(); }
+};
+
+struct AnimationImportSettings
+{
+    float sampleRate = 0.0f; // resamples every track to this many keys per second, 0 keeps the authored keys
+    bool compress = false;   // see CompressedClip, also drops the node tree once the skeleton is built
+    float positionTolerance = 0.0005f;
+    float rotationTolerance = 0.001f; // radians
+    float scaleTolerance = 0.0005f;
+};
+
 class Animation
 {
 public:
     Animation(const tinygltf::Model &model,
               int animationIndex,
-              int skinIndex);
+              int skinIndex,
+              const AnimationImportSettings &settings = AnimationImportSettings());
     ~Animation();
 
     std::string m_name;
@@ -41,6 +63,8 @@ public:
 
     GltfNodeData *m_rootNode;
     std::map<std::string, GltfNodeData *> m_nodes;
+    Skeleton m_skeleton;
+    CompressedClip m_clip; // empty unless imported compressed
 
     std::unordered_map<std::string, Bone *> m_bones;
     std::unordered_map<std::string, BoneInfo> m_boneInfoMap;
@@ -58,5 +82,7 @@ public:
         int nodeIndex,
         std::unordered_map<std::string, GltfNodeData *> &nodeMap);
 
+    void buildSkeleton(const GltfNodeData *node, int parent);
+
     void setBlendMask(std::unordered_map<std::string, float> blendMask, float defaultValue);
 };
@@ -0,0 +1,87 @@
+#include <algorithm>
+
+#include "animation_manager.h"
+
+#include "../job_system/job_system.h"
+
+static const Skeleton *getSkeleton(const Animator *animator)
+{
+    return &animator->m_animations[0]->m_skeleton;
+}
+
+AnimationManager::AnimationManager()
+{
+}
+
+AnimationManager::~AnimationManager()
+{
+}
+
+void AnimationManager::update(float deltaTime)
+{
+    if (!m_grouped)
+        group();
+
+    auto evaluate = [&](int batch) {
+        for (int i = m_batches[batch].begin; i < m_batches[batch].end; i++)
+            m_animators[i]->update(deltaTime);
+    };
+
+    if (m_parallel)
+    {
+        JobSystem::getInstance().parallelFor((int)m_batches.size(), evaluate);
+    }
+    else
+    {
+        for (int i = 0; i < (int)m_batches.size(); i++)
+            evaluate(i);
+    }
+}
+
+void AnimationManager::add(Animator *animator)
+{
+    // Models sharing an animator update it once, it stays until the last one removes it
+    if (m_references[animator]++ > 0)
+        return;
+
+    m_animators.push_back(animator);
+    m_grouped = false;
+}
+
+void AnimationManager::remove(Animator *animator)
+{
+    auto reference = m_references.find(animator);
+    if (reference == m_references.end() || --reference->second > 0)
+        return;
+    m_references.erase(reference);
+
+    auto it = std::find(m_animators.begin(), m_animators.end(), animator);
+    if (it != m_animators.end())
+    {
+        m_animators.erase(it);
+        m_grouped = false;
+    }
+}
+
+void AnimationManager::group()
+{
+    std::stable_sort(m_animators.begin(), m_animators.end(), [](const Animator *a, const Animator *b) {
+        return getSkeleton(a) < getSkeleton(b);
+    });
+
+    // A batch never spans two rigs
+    m_batches.clear();
+    int batchSize = std::max(m_batchSize, 1);
+    for (int begin = 0; begin < (int)m_animators.size();)
+    {
+        const Skeleton *skeleton = getSkeleton(m_animators[begin]);
+        int end = begin + 1;
+        while (end < (int)m_animators.size() && end - begin < batchSize && getSkeleton(m_animators[end]) == skeleton)
+            end++;
+
+        m_batches.push_back({begin, end});
+        begin = end;
+    }
+
+    m_grouped = true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "animator.h"
+
+// Updates the registered animators once per frame on the job system, before any pass
+// reads m_finalBoneMatrices. Animators are grouped by skeleton and every job evaluates
+// a run of characters of one rig, so the joint hierarchy and clips stay in cache.
+class AnimationManager
+{
+public:
+    AnimationManager();
+    ~AnimationManager();
+
+    bool m_parallel = true;
+    int m_batchSize = 4; // characters per job
+
+    void update(float deltaTime);
+    void add(Animator *animator);
+    void remove(Animator *animator);
+
+private:
+    struct Batch
+    {
+        int begin;
+        int end;
+    };
+
+    std::vector<Animator *> m_animators; // sorted by skeleton once grouped
+    std::vector<Batch> m_batches;
+    std::unordered_map<Animator *, int> m_references; // models using each animator
+    bool m_grouped = true;
+
+    void group();
+};
@@ -7,6 +7,7 @@ Animator::Animator(std::vector<Animation *> animations)
 {
     m_finalBoneMatrices.resize(MAX_JOINTS, glm::mat4(1.0f));
     m_globalMatrices.resize(MAX_JOINTS, glm::mat4(1.0f));
+    m_jointMatrices.resize(m_animations[0]->m_skeleton.size(), glm::mat4(1.0f));
 }
 
 Animator::~Animator()
@@ -28,106 +29,114 @@ void Animator::update(float deltaTime)
     for (int i = 0; i < m_state.poses.size(); i++)
         m_state.poses[i]->updateTimer(deltaTime, m_startOffset);
 
-    calculateBoneTransform(m_animations[0]->m_rootNode, glm::mat4(1.0f));
+    calculateBoneTransforms();
 }
 
-void Animator::calculateBoneTransform(const GltfNodeData *node, glm::mat4 parentTransform)
+// Bones are only sampled, so animators sharing clips can be evaluated on different threads
+void Animator::calculateBoneTransforms()
 {
-    std::string nodeName = node->name;
-    glm::mat4 nodeTransform = node->transformation;
-
-    glm::vec3 blendedT;
-    glm::quat blendedR;
-    glm::vec3 blendedS;
+    // TODO: always first index is correct?
+    const Skeleton &skeleton = m_animations[0]->m_skeleton;
 
-    bool boneProcessed = false;
-    float totalWeight = 0.0f;
-    for (int i = 0; i < m_state.animations.size(); i++)
+    for (int joint = 0; joint < skeleton.size(); joint++)
     {
-        Anim *anim = m_state.animations[i];
-        Bone *bone = anim->m_animation->getBone(nodeName);
-
-        if (!bone)
-            continue;
+        glm::mat4 nodeTransform = skeleton.m_localTransforms[joint];
 
-        float blendWeight = anim->m_blendFactor * bone->m_blendFactor;
+        glm::vec3 blendedT;
+        glm::quat blendedR;
+        glm::vec3 blendedS;
 
-        if (blendWeight == 0.0f)
-            continue;
-
-        bone->update(anim->m_timer);
-
-        totalWeight += blendWeight;
-
-        // TODO: blend weight influence
-        if (!boneProcessed) // first bone
+        bool boneProcessed = false;
+        float totalWeight = 0.0f;
+        for (int i = 0; i < m_state.animations.size(); i++)
         {
-            blendedT = bone->m_translation;
-            blendedR = bone->m_rotation;
-            blendedS = bone->m_scale;
+            Anim *anim = m_state.animations[i];
+            Bone *bone = anim->m_tracks[joint];
+
+            if (!bone)
+                continue;
+
+            float blendWeight = anim->m_blendFactor * bone->m_blendFactor;
+
+            if (blendWeight == 0.0f)
+                continue;
+
+            glm::vec3 t(0.0f);
+            glm::quat r(1.0f, 0.0f, 0.0f, 0.0f);
+            glm::vec3 s(1.0f);
+            bone->sample(anim->m_timer, &anim->m_cursors[joint], t, r, s);
+
+            totalWeight += blendWeight;
+
+            // TODO: blend weight influence
+            if (!boneProcessed) // first bone
+            {
+                blendedT = t;
+                blendedR = r;
+                blendedS = s;
+            }
+            else
+            {
+                float weight = blendWeight / totalWeight;
+                if (isnan(weight))
+                    weight = 1.0f;
+
+                blendedT = glm::mix(blendedT, t, weight);
+                blendedR = glm::slerp(blendedR, r, weight);
+                blendedS = glm::mix(blendedS, s, weight);
+            }
+
+            boneProcessed = true;
         }
-        else
-        {
-            float weight = blendWeight / totalWeight;
-            if (isnan(weight))
-                weight = 1.0f;
 
-            blendedT = glm::mix(blendedT, bone->m_translation, weight);
-            blendedR = glm::slerp(blendedR, bone->m_rotation, weight);
-            blendedS = glm::mix(blendedS, bone->m_scale, weight);
-        }
-
-        boneProcessed = true;
-    }
-
-    // pose influence
-    for (int i = 0; i < m_state.poses.size(); i++)
-    {
-        Anim *anim = m_state.poses[i];
-        Animation *animation = anim->m_animation;
-        Bone *bone = animation->getBone(nodeName);
+        // pose influence
+        for (int i = 0; i < m_state.poses.size(); i++)
+        {
+            Anim *anim = m_state.poses[i];
+            Bone *bone = anim->m_tracks[joint];
 
-        if (!bone)
-            continue;
+            if (!bone)
+                continue;
 
-        float blendWeight = anim->m_blendFactor * bone->m_blendFactor;
+            float blendWeight = anim->m_blendFactor * bone->m_blendFactor;
 
-        if (blendWeight == 0.0f)
-            continue;
+            if (blendWeight == 0.0f)
+                continue;
 
-        bone->update(anim->m_timer);
+            glm::vec3 t(0.0f);
+            glm::quat r(1.0f, 0.0f, 0.0f, 0.0f);
+            glm::vec3 s(1.0f);
+            bone->sample(anim->m_timer, &anim->m_cursors[joint], t, r, s);
 
-        blendedT = glm::mix(blendedT, bone->m_translation, blendWeight);
-        blendedR = glm::slerp(blendedR, bone->m_rotation, blendWeight);
-        blendedS = glm::mix(blendedS, bone->m_scale, blendWeight);
-    }
+            blendedT = glm::mix(blendedT, t, blendWeight);
+            blendedR = glm::slerp(blendedR, r, blendWeight);
+            blendedS = glm::mix(blendedS, s, blendWeight);
+        }
 
-    if (boneProcessed)
-    {
-        nodeTransform = glm::translate(glm::mat4(1), blendedT) *
-                        glm::toMat4(glm::normalize(blendedR)) *
-                        glm::scale(glm::mat4(1), blendedS);
-    }
+        if (boneProcessed)
+        {
+            nodeTransform = glm::translate(glm::mat4(1), blendedT) *
+                            glm::toMat4(glm::normalize(blendedR)) *
+                            glm::scale(glm::mat4(1), blendedS);
+        }
 
-    glm::mat4 globalTransformation = parentTransform * nodeTransform;
+        int parent = skeleton.m_parents[joint];
+        glm::mat4 globalTransformation = parent >= 0 ? m_jointMatrices[parent] * nodeTransform : nodeTransform;
+        m_jointMatrices[joint] = globalTransformation;
 
-    // TODO: always first index is correct?
-    auto boneInfoMap = m_animations[0]->m_boneInfoMap;
-    if (boneInfoMap.find(nodeName) != boneInfoMap.end())
-    {
-        int index = boneInfoMap[nodeName].id;
-        glm::mat4 offset = boneInfoMap[nodeName].offset;
-        m_finalBoneMatrices[index] = globalTransformation * offset;
-        m_globalMatrices[index] = globalTransformation;
+        int index = skeleton.m_boneIds[joint];
+        if (index >= 0)
+        {
+            m_finalBoneMatrices[index] = globalTransformation * skeleton.m_offsets[joint];
+            m_globalMatrices[index] = globalTransformation;
+        }
     }
-
-    for (int i = 0; i < node->children.size(); i++)
-        calculateBoneTransform(node->children[i], globalTransformation);
 }
 
 Anim *Animator::addStateAnimation(Animation *animation)
 {
     Anim *anim = new Anim(animation);
+    bindTracks(anim);
     m_state.animations.push_back(anim);
 
     return anim;
@@ -136,11 +145,22 @@ Anim *Animator::addStateAnimation(Animation *animation)
 Anim *Animator::addPoseAnimation(Animation *animation)
 {
     Anim *anim = new Anim(animation);
+    bindTracks(anim);
     m_state.poses.push_back(anim);
 
     return anim;
 }
 
+void Animator::bindTracks(Anim *anim)
+{
+    const Skeleton &skeleton = m_animations[0]->m_skeleton;
+
+    anim->m_tracks.resize(skeleton.size());
+    anim->m_cursors.assign(skeleton.size(), BoneCursor());
+    for (int joint = 0; joint < skeleton.size(); joint++)
+        anim->m_tracks[joint] = anim->m_animation->getBone(skeleton.m_names[joint]);
+}
+
 // Anim
 
 Anim::Anim(Animation *animation)
@@ -19,6 +19,8 @@ public:
     float m_playbackSpeed;
     bool m_timerActive;
     float m_timer;
+    std::vector<Bone *> m_tracks; // per skeleton joint, null where the clip has no bone
+    std::vector<BoneCursor> m_cursors;
 
     void updateTimer(float deltaTime, float startOffset);
 };
@@ -34,6 +36,7 @@ class Animator
 public:
     std::vector<glm::mat4> m_finalBoneMatrices;
     std::vector<glm::mat4> m_globalMatrices;
+    std::vector<glm::mat4> m_jointMatrices; // global transform of every skeleton joint
     std::vector<Animation *> m_animations;
     AnimatorState m_state;
     float m_startOffset = 0.f;
@@ -41,7 +44,11 @@ public:
     Animator(std::vector<Animation *> animations);
     ~Animator();
     void update(float deltaTime);
-    void calculateBoneTransform(const GltfNodeData *node, glm::mat4 parentTransform);
+    void calculateBoneTransforms();
     Anim *addStateAnimation(Animation *animation);
     Anim *addPoseAnimation(Animation *animation);
+
+private:
+    // Resolves the clip's bones by name once, clips of other models with the same names work too
+    void bindTracks(Anim *anim);
 };
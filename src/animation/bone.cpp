@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include <glm/glm.hpp>
@@ -138,13 +140,29 @@ Bone::~Bone()
 {
 }
 
-void Bone::update(float animationTime)
+void Bone::update(float animationTime, BoneCursor *cursor)
 {
-    // Use .size() and check <= 1 to handle poses
-    if (m_positions.size() <= 1 && m_rotations.size() <= 1 && m_scales.size() <= 1)
-        updatePose();
-    else
-        updateCycle(animationTime);
+    sample(animationTime, cursor, m_translation, m_rotation, m_scale);
+}
+
+void Bone::sample(float animationTime, BoneCursor *cursor, glm::vec3 &translation, glm::quat &rotation, glm::vec3 &scale) const
+{
+    // Use .size() and check <= 1 to handle poses, compressed tracks always animate
+    bool compressed = m_compressedPositions.keyCount || m_compressedRotations.keyCount || m_compressedScales.keyCount;
+    if (!compressed && m_positions.size() <= 1 && m_rotations.size() <= 1 && m_scales.size() <= 1)
+    {
+        if (!m_positions.empty())
+            translation = m_positions[0].value;
+        if (!m_rotations.empty())
+            rotation = m_rotations[0].value;
+        if (!m_scales.empty())
+            scale = m_scales[0].value;
+        return;
+    }
+
+    translation = interpolatePosition(animationTime, cursor ? &cursor->position : nullptr);
+    rotation = interpolateRotation(animationTime, cursor ? &cursor->rotation : nullptr);
+    scale = interpolateScaling(animationTime, cursor ? &cursor->scale : nullptr);
 }
 
 void Bone::updatePose()
@@ -158,53 +176,204 @@ void Bone::updatePose()
         m_scale = m_scales[0].value;
 }
 
-void Bone::updateCycle(float animationTime)
+void Bone::updateCycle(float animationTime, BoneCursor *cursor)
+{
+    m_translation = interpolatePosition(animationTime, cursor ? &cursor->position : nullptr);
+    m_rotation = interpolateRotation(animationTime, cursor ? &cursor->rotation : nullptr);
+    m_scale = interpolateScaling(animationTime, cursor ? &cursor->scale : nullptr);
+}
+
+void Bone::resample(float sampleRate, float duration)
 {
-    m_translation = interpolatePosition(animationTime);
-    m_rotation = interpolateRotation(animationTime);
-    m_scale = interpolateScaling(animationTime);
+    if (sampleRate <= 0.0f || duration <= 0.0f)
+        return;
+
+    // Sampled from the authored keys, so all three are built before any is replaced
+    int count = std::max((int)std::ceil(duration * sampleRate) + 1, 2);
+    std::vector<KeyVec3> positions, scales;
+    std::vector<KeyQuat> rotations;
+    for (int i = 0; i < count; i++)
+    {
+        float time = i / sampleRate;
+        float sampleTime = std::min(time, duration);
+        if (m_positions.size() > 1)
+            positions.push_back({time, interpolatePosition(sampleTime)});
+        if (m_rotations.size() > 1)
+            rotations.push_back({time, interpolateRotation(sampleTime)});
+        if (m_scales.size() > 1)
+            scales.push_back({time, interpolateScaling(sampleTime)});
+    }
+
+    // Single key tracks stay as they are, they need no lookup
+    if (!positions.empty())
+        m_positions = std::move(positions);
+    if (!rotations.empty())
+        m_rotations = std::move(rotations);
+    if (!scales.empty())
+        m_scales = std::move(scales);
+    m_sampleRate = sampleRate;
 }
 
-int Bone::getPositionIndex(float animationTime) const
+// Indices of the keys to keep, a key is dropped while interpolating between the kept
+// neighbours reproduces every dropped key within the tolerance
+template <typename Key, typename Lerp, typename Error>
+static std::vector<int> reduceKeys(const std::vector<Key> &keys, float tolerance, Lerp lerp, Error error)
 {
+    int count = (int)keys.size();
+    std::vector<int> kept = {0};
+
+    int anchor = 0;
+    for (int end = 2; end < count && tolerance > 0.0f; end++)
+    {
+        bool fits = true;
+        for (int i = anchor + 1; i < end && fits; i++)
+        {
+            float span = keys[end].timestamp - keys[anchor].timestamp;
+            float t = span > 0.0f ? (keys[i].timestamp - keys[anchor].timestamp) / span : 0.0f;
+            fits = error(lerp(keys[anchor].value, keys[end].value, t), keys[i].value) <= tolerance;
+        }
+
+        if (!fits)
+        {
+            anchor = end - 1;
+            kept.push_back(anchor);
+        }
+    }
+
+    // Without a tolerance every key is kept
+    if (tolerance <= 0.0f)
+    {
+        for (int i = 1; i < count - 1; i++)
+            kept.push_back(i);
+    }
+    kept.push_back(count - 1);
+    return kept;
+}
+
+void Bone::compress(CompressedClip &clip, float positionTolerance, float rotationTolerance, float scaleTolerance)
+{
+    auto mixVec3 = [](const glm::vec3 &a, const glm::vec3 &b, float t) { return glm::mix(a, b, t); };
+    auto distance = [](const glm::vec3 &a, const glm::vec3 &b) { return glm::length(a - b); };
+
+    auto compressVec3 = [&](std::vector<KeyVec3> &keys, float tolerance) {
+        CompressedTrack track;
+        if (keys.size() <= 1)
+            return track;
+
+        std::vector<float> times;
+        std::vector<glm::vec3> values;
+        for (int i : reduceKeys(keys, tolerance, mixVec3, distance))
+        {
+            times.push_back(keys[i].timestamp);
+            values.push_back(keys[i].value);
+        }
+        std::vector<KeyVec3>().swap(keys);
+        return clip.addVec3Track(times, values);
+    };
+
+    m_compressedPositions = compressVec3(m_positions, positionTolerance);
+    m_compressedScales = compressVec3(m_scales, scaleTolerance);
+
+    if (m_rotations.size() > 1)
+    {
+        auto slerp = [](const glm::quat &a, const glm::quat &b, float t) { return glm::normalize(glm::slerp(a, b, t)); };
+        auto angle = [](const glm::quat &a, const glm::quat &b) {
+            return 2.0f * std::acos(glm::min(std::abs(glm::dot(a, b)), 1.0f));
+        };
+
+        std::vector<float> times;
+        std::vector<glm::quat> values;
+        for (int i : reduceKeys(m_rotations, rotationTolerance, slerp, angle))
+        {
+            times.push_back(m_rotations[i].timestamp);
+            values.push_back(m_rotations[i].value);
+        }
+        std::vector<KeyQuat>().swap(m_rotations);
+        m_compressedRotations = clip.addQuatTrack(times, values);
+    }
+
+    // Dropped keys break the even spacing of resampled tracks, cursors keep lookups cheap
+    m_clip = &clip;
+    m_sampleRate = 0.0f;
+}
+
+// Index of the key before animationTime, at most count - 2 so the next key exists
+template <typename TimeAt>
+static int findKey(int count, TimeAt timeAt, float animationTime, float sampleRate, int *cursor)
+{
+    int last = count - 2;
+
+    // Resampled keys are evenly spaced from zero
+    if (sampleRate > 0.0f)
+        return glm::clamp((int)(animationTime * sampleRate), 0, last);
+
+    // Moving forward from the last lookup, a few steps before falling back to a search
+    if (cursor)
+    {
+        int index = glm::clamp(*cursor, 0, last);
+        if (animationTime >= timeAt(index))
+        {
+            for (int step = 0; step < 4 && index < last && animationTime >= timeAt(index + 1); step++)
+                index++;
+            if (index == last || animationTime < timeAt(index + 1))
+            {
+                *cursor = index;
+                return index;
+            }
+        }
+    }
+
     // Find the first keyframe with a timestamp *greater* than animationTime
-    auto it = std::upper_bound(m_positions.begin(), m_positions.end(), animationTime,
-                               [](float time, const KeyVec3 &key) {
-                                   return time < key.timestamp;
-                               });
+    int low = 0;
+    int high = count;
+    while (low < high)
+    {
+        int mid = (low + high) / 2;
+        if (animationTime < timeAt(mid))
+            high = mid;
+        else
+            low = mid + 1;
+    }
+
     // The index we want is the one *before* it
-    if (it == m_positions.begin())
-        return 0;
+    int index = low == 0 ? 0 : std::min(low - 1, last);
+    if (cursor)
+        *cursor = index;
+    return index;
+}
 
-    int index = std::distance(m_positions.begin(), it) - 1;
-    // Ensure index is not the last element, as we need index+1
-    return (index >= m_positions.size() - 1) ? (int)m_positions.size() - 2 : index;
+static int findKey(const CompressedClip *clip, const CompressedTrack &track, float animationTime, int *cursor)
+{
+    auto timeAt = [&](int i) { return clip->time(track, i); };
+    return findKey((int)track.keyCount, timeAt, animationTime, 0.0f, cursor);
+}
+
+template <typename Key>
+static int findKey(const std::vector<Key> &keys, float animationTime, float sampleRate, int *cursor)
+{
+    auto timeAt = [&](int i) { return keys[i].timestamp; };
+    return findKey((int)keys.size(), timeAt, animationTime, sampleRate, cursor);
 }
 
-int Bone::getRotationIndex(float animationTime) const
+int Bone::getPositionIndex(float animationTime, int *cursor) const
 {
-    auto it = std::upper_bound(m_rotations.begin(), m_rotations.end(), animationTime,
-                               [](float time, const KeyQuat &key) {
-                                   return time < key.timestamp;
-                               });
-    if (it == m_rotations.begin())
-        return 0;
-
-    int index = std::distance(m_rotations.begin(), it) - 1;
-    return (index >= m_rotations.size() - 1) ? (int)m_rotations.size() - 2 : index;
+    if (m_compressedPositions.keyCount)
+        return findKey(m_clip, m_compressedPositions, animationTime, cursor);
+    return findKey(m_positions, animationTime, m_sampleRate, cursor);
 }
 
-int Bone::getScaleIndex(float animationTime) const
+int Bone::getRotationIndex(float animationTime, int *cursor) const
 {
-    auto it = std::upper_bound(m_scales.begin(), m_scales.end(), animationTime,
-                               [](float time, const KeyVec3 &key) {
-                                   return time < key.timestamp;
-                               });
-    if (it == m_scales.begin())
-        return 0;
-
-    int index = std::distance(m_scales.begin(), it) - 1;
-    return (index >= m_scales.size() - 1) ? (int)m_scales.size() - 2 : index;
+    if (m_compressedRotations.keyCount)
+        return findKey(m_clip, m_compressedRotations, animationTime, cursor);
+    return findKey(m_rotations, animationTime, m_sampleRate, cursor);
+}
+
+int Bone::getScaleIndex(float animationTime, int *cursor) const
+{
+    if (m_compressedScales.keyCount)
+        return findKey(m_clip, m_compressedScales, animationTime, cursor);
+    return findKey(m_scales, animationTime, m_sampleRate, cursor);
 }
 
 float Bone::getScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime) const
@@ -218,42 +387,64 @@ float Bone::getScaleFactor(float lastTimeStamp, float nextTimeStamp, float anima
     return midWayLength / framesDiff;
 }
 
-glm::vec3 Bone::interpolatePosition(float animationTime) const
+glm::vec3 Bone::interpolatePosition(float animationTime, int *cursor) const
 {
+    // Decoded in place, only the two keys around the time
+    if (m_compressedPositions.keyCount)
+    {
+        int p0Index = getPositionIndex(animationTime, cursor);
+        float scaleFactor = getScaleFactor(m_clip->time(m_compressedPositions, p0Index), m_clip->time(m_compressedPositions, p0Index + 1), animationTime);
+        return glm::mix(m_clip->vec3(m_compressedPositions, p0Index), m_clip->vec3(m_compressedPositions, p0Index + 1), scaleFactor);
+    }
+
     // Handle single-keyframe pose
     if (m_positions.empty())
         return glm::vec3(1.0f);
     if (m_positions.size() == 1)
         return m_positions[0].value;
 
-    int p0Index = getPositionIndex(animationTime);
+    int p0Index = getPositionIndex(animationTime, cursor);
     int p1Index = p0Index + 1;
     float scaleFactor = getScaleFactor(m_positions[p0Index].timestamp, m_positions[p1Index].timestamp, animationTime);
     return glm::mix(m_positions[p0Index].value, m_positions[p1Index].value, scaleFactor);
 }
 
-glm::quat Bone::interpolateRotation(float animationTime) const
+glm::quat Bone::interpolateRotation(float animationTime, int *cursor) const
 {
+    if (m_compressedRotations.keyCount)
+    {
+        int p0Index = getRotationIndex(animationTime, cursor);
+        float scaleFactor = getScaleFactor(m_clip->time(m_compressedRotations, p0Index), m_clip->time(m_compressedRotations, p0Index + 1), animationTime);
+        return glm::normalize(glm::slerp(m_clip->quat(m_compressedRotations, p0Index), m_clip->quat(m_compressedRotations, p0Index + 1), scaleFactor));
+    }
+
     if (m_rotations.empty())
         return glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
     if (m_rotations.size() == 1)
         return m_rotations[0].value;
 
-    int p0Index = getRotationIndex(animationTime);
+    int p0Index = getRotationIndex(animationTime, cursor);
     int p1Index = p0Index + 1;
     float scaleFactor = getScaleFactor(m_rotations[p0Index].timestamp, m_rotations[p1Index].timestamp, animationTime);
     glm::quat finalRotation = glm::slerp(m_rotations[p0Index].value, m_rotations[p1Index].value, scaleFactor);
     return glm::normalize(finalRotation); // Normalizing is good practice
 }
 
-glm::vec3 Bone::interpolateScaling(float animationTime) const
+glm::vec3 Bone::interpolateScaling(float animationTime, int *cursor) const
 {
+    if (m_compressedScales.keyCount)
+    {
+        int p0Index = getScaleIndex(animationTime, cursor);
+        float scaleFactor = getScaleFactor(m_clip->time(m_compressedScales, p0Index), m_clip->time(m_compressedScales, p0Index + 1), animationTime);
+        return glm::mix(m_clip->vec3(m_compressedScales, p0Index), m_clip->vec3(m_compressedScales, p0Index + 1), scaleFactor);
+    }
+
     if (m_scales.empty())
         return glm::vec3(1.0f);
     if (m_scales.size() == 1)
         return m_scales[0].value;
 
-    int p0Index = getScaleIndex(animationTime);
+    int p0Index = getScaleIndex(animationTime, cursor);
     int p1Index = p0Index + 1;
     float scaleFactor = getScaleFactor(m_scales[p0Index].timestamp, m_scales[p1Index].timestamp, animationTime);
     return glm::mix(m_scales[p0Index].value, m_scales[p1Index].value, scaleFactor);
@@ -6,6 +6,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include "compressed_clip.h"
+
 namespace tinygltf
 {
 class Model;
@@ -25,6 +27,15 @@ struct KeyQuat
     glm::quat value;
 };
 
+// Key indices of one playback of a bone, with time moving forward the next
+// keys are found by stepping instead of searching
+struct BoneCursor
+{
+    int position = 0;
+    int rotation = 0;
+    int scale = 0;
+};
+
 class Bone
 {
 public:
@@ -41,6 +52,12 @@ public:
     std::vector<KeyQuat> m_rotations;
     std::vector<KeyVec3> m_scales;
 
+    // Set once compressed, animated tracks then live in the clip and their vectors are empty
+    const CompressedClip *m_clip = nullptr;
+    CompressedTrack m_compressedPositions;
+    CompressedTrack m_compressedRotations;
+    CompressedTrack m_compressedScales;
+
     glm::vec3 m_translation;
     glm::quat m_rotation;
     glm::vec3 m_scale;
@@ -48,20 +65,29 @@ public:
     int m_ID;
 
     float m_blendFactor = 1.0f;
+    float m_sampleRate = 0.0f; // keys per second once resampled, the key index is then computed
 
-    void update(float animationTime);
+    void update(float animationTime, BoneCursor *cursor = nullptr);
     void updatePose();
-    void updateCycle(float animationTime);
+    void updateCycle(float animationTime, BoneCursor *cursor = nullptr);
+    // Same as update without touching the bone, which is shared by every animator playing the clip
+    void sample(float animationTime, BoneCursor *cursor, glm::vec3 &translation, glm::quat &rotation, glm::vec3 &scale) const;
+
+    // Replaces the animated tracks with keys at a fixed rate over the clip
+    void resample(float sampleRate, float duration);
+    // Moves the animated tracks into the clip, dropping keys that linear interpolation
+    // reproduces within the tolerances (units and radians)
+    void compress(CompressedClip &clip, float positionTolerance, float rotationTolerance, float scaleTolerance);
 
-    int getPositionIndex(float animationTime) const;
-    int getRotationIndex(float animationTime) const;
-    int getScaleIndex(float animationTime) const;
+    int getPositionIndex(float animationTime, int *cursor = nullptr) const;
+    int getRotationIndex(float animationTime, int *cursor = nullptr) const;
+    int getScaleIndex(float animationTime, int *cursor = nullptr) const;
 
     float getScaleFactor(float lastTimeStamp, float nextTimeStamp, float animationTime) const;
 
-    glm::vec3 interpolatePosition(float animationTime) const;
-    glm::quat interpolateRotation(float animationTime) const;
-    glm::vec3 interpolateScaling(float animationTime) const;
+    glm::vec3 interpolatePosition(float animationTime, int *cursor = nullptr) const;
+    glm::quat interpolateRotation(float animationTime, int *cursor = nullptr) const;
+    glm::vec3 interpolateScaling(float animationTime, int *cursor = nullptr) const;
 
     static const float *GetFloatDataPtr(const tinygltf::Model &model,
                                         const tinygltf::Accessor &acc);
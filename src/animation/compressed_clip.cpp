@@ -0,0 +1,118 @@
+#include "compressed_clip.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Smallest three components lie within +-1/sqrt(2)
+static const float QuatRange = 0.70710678f;
+
+static uint16_t quantize(float value, float min, float extent, float steps)
+{
+    if (extent <= 0.0f)
+        return 0;
+    return (uint16_t)std::lround(glm::clamp((value - min) / extent, 0.0f, 1.0f) * steps);
+}
+
+uint32_t CompressedClip::addTimes(const std::vector<float> &times)
+{
+    std::vector<uint16_t> quantized(times.size());
+    for (size_t i = 0; i < times.size(); i++)
+        quantized[i] = quantize(times[i], 0.0f, m_duration, 65535.0f);
+
+    auto it = m_timeArrays.find(quantized);
+    if (it != m_timeArrays.end())
+        return it->second;
+
+    uint32_t offset = (uint32_t)m_data.size();
+    m_data.insert(m_data.end(), quantized.begin(), quantized.end());
+    m_timeArrays[quantized] = offset;
+    return offset;
+}
+
+CompressedTrack CompressedClip::addVec3Track(const std::vector<float> &times, const std::vector<glm::vec3> &values)
+{
+    CompressedTrack track;
+    track.keyCount = (uint32_t)values.size();
+    track.times = addTimes(times);
+
+    glm::vec3 max = values[0];
+    track.min = values[0];
+    for (const glm::vec3 &value : values)
+    {
+        track.min = glm::min(track.min, value);
+        max = glm::max(max, value);
+    }
+    track.extent = max - track.min;
+
+    track.values = (uint32_t)m_data.size();
+    for (const glm::vec3 &value : values)
+    {
+        for (int c = 0; c < 3; c++)
+            m_data.push_back(quantize(value[c], track.min[c], track.extent[c], 65535.0f));
+    }
+    return track;
+}
+
+CompressedTrack CompressedClip::addQuatTrack(const std::vector<float> &times, const std::vector<glm::quat> &values)
+{
+    CompressedTrack track;
+    track.keyCount = (uint32_t)values.size();
+    track.times = addTimes(times);
+
+    track.values = (uint32_t)m_data.size();
+    m_data.resize(m_data.size() + values.size() * 3);
+    for (size_t i = 0; i < values.size(); i++)
+        packQuat(values[i], &m_data[track.values + i * 3]);
+    return track;
+}
+
+void CompressedClip::finish()
+{
+    m_timeArrays.clear();
+    m_data.shrink_to_fit();
+}
+
+void CompressedClip::packQuat(glm::quat q, uint16_t *out)
+{
+    float components[4] = {q.x, q.y, q.z, q.w};
+
+    int largest = 0;
+    for (int i = 1; i < 4; i++)
+    {
+        if (std::abs(components[i]) > std::abs(components[largest]))
+            largest = i;
+    }
+
+    // q and -q are the same rotation, the dropped component is rebuilt as positive
+    float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+    uint16_t small[3];
+    for (int i = 0, j = 0; i < 4; i++)
+    {
+        if (i != largest)
+            small[j++] = quantize(components[i] * sign, -QuatRange, 2.0f * QuatRange, 32767.0f);
+    }
+
+    out[0] = (uint16_t)(((largest >> 1) << 15) | small[0]);
+    out[1] = (uint16_t)(((largest & 1) << 15) | small[1]);
+    out[2] = small[2];
+}
+
+glm::quat CompressedClip::unpackQuat(const uint16_t *in)
+{
+    int largest = ((in[0] >> 15) << 1) | (in[1] >> 15);
+    uint16_t small[3] = {(uint16_t)(in[0] & 0x7FFF), (uint16_t)(in[1] & 0x7FFF), in[2]};
+
+    float components[4];
+    float sum = 0.0f;
+    for (int i = 0, j = 0; i < 4; i++)
+    {
+        if (i == largest)
+            continue;
+        components[i] = small[j++] * (2.0f * QuatRange / 32767.0f) - QuatRange;
+        sum += components[i] * components[i];
+    }
+    components[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+
+    return glm::quat(components[3], components[0], components[1], components[2]);
+}
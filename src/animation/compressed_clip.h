@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// One track's keys inside a CompressedClip
+struct CompressedTrack
+{
+    uint32_t keyCount = 0; // 0 when the track is kept uncompressed
+    uint32_t times = 0;    // offsets into CompressedClip::m_data
+    uint32_t values = 0;   // three values per key
+    glm::vec3 min{0.0f};   // quantization range of translations and scales
+    glm::vec3 extent{0.0f};
+};
+
+// Keys of every bone of a clip in one block of 16 bit values:
+// times normalized to the clip duration and shared between tracks with the same keys,
+// translations and scales quantized to their range, rotations as smallest three
+class CompressedClip
+{
+public:
+    std::vector<uint16_t> m_data;
+    float m_duration = 0.0f;
+
+    float time(const CompressedTrack &track, uint32_t key) const
+    {
+        return m_data[track.times + key] * (m_duration / 65535.0f);
+    }
+
+    glm::vec3 vec3(const CompressedTrack &track, uint32_t key) const
+    {
+        const uint16_t *q = &m_data[track.values + key * 3];
+        return track.min + glm::vec3(q[0], q[1], q[2]) * (track.extent / 65535.0f);
+    }
+
+    glm::quat quat(const CompressedTrack &track, uint32_t key) const
+    {
+        return unpackQuat(&m_data[track.values + key * 3]);
+    }
+
+    CompressedTrack addVec3Track(const std::vector<float> &times, const std::vector<glm::vec3> &values);
+    CompressedTrack addQuatTrack(const std::vector<float> &times, const std::vector<glm::quat> &values);
+    // Drops the lookup used to share time arrays while building
+    void finish();
+
+    // 48 bits: the index of the dropped largest component and the other three in 15 bits each
+    static void packQuat(glm::quat q, uint16_t *out);
+    static glm::quat unpackQuat(const uint16_t *in);
+
+private:
+    std::map<std::vector<uint16_t>, uint32_t> m_timeArrays;
+
+    uint32_t addTimes(const std::vector<float> &times);
+};
@@ -0,0 +1,274 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include <glm/gtc/constants.hpp>
+
+#include <SDL3/SDL_iostream.h>
+#include <SDL3/SDL_log.h>
+
+#include "../gpu/render_stats.h"
+#include "../utils/utils.h"
+
+bool CameraPath::loadFromFile(const std::string &path)
+{
+    size_t size = 0;
+    char *data = (char *)SDL_LoadFile(path.c_str(), &size);
+    if (!data)
+    {
+        SDL_Log("Failed to load camera path %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    m_keys.clear();
+    std::istringstream stream(std::string(data, size));
+    SDL_free(data);
+
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        CameraKey key;
+        std::istringstream values(line);
+        if (values >> key.time >> key.position.x >> key.position.y >> key.position.z >> key.target.x >> key.target.y >> key.target.z)
+            m_keys.push_back(key);
+    }
+
+    std::sort(m_keys.begin(), m_keys.end(), [](const CameraKey &a, const CameraKey &b) {
+        return a.time < b.time;
+    });
+
+    if (m_keys.empty())
+    {
+        SDL_Log("Camera path %s has no keys", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void CameraPath::makeOrbit(glm::vec3 center, float radius, float height, float duration, int steps)
+{
+    m_keys.clear();
+    for (int i = 0; i <= steps; i++)
+    {
+        float t = (float)i / steps;
+        float angle = t * glm::two_pi<float>();
+
+        CameraKey key;
+        key.time = t * duration;
+        key.position = center + glm::vec3(glm::sin(angle) * radius, height, glm::cos(angle) * radius);
+        key.target = center;
+        m_keys.push_back(key);
+    }
+}
+
+void CameraPath::apply(Camera *camera, float time) const
+{
+    if (m_keys.empty())
+        return;
+
+    size_t next = 0;
+    while (next < m_keys.size() && m_keys[next].time < time)
+        next++;
+
+    glm::vec3 position, target;
+    if (next == 0 || next == m_keys.size())
+    {
+        const CameraKey &key = m_keys[next == 0 ? 0 : m_keys.size() - 1];
+        position = key.position;
+        target = key.target;
+    }
+    else
+    {
+        const CameraKey &a = m_keys[next - 1];
+        const CameraKey &b = m_keys[next];
+        float t = (time - a.time) / glm::max(b.time - a.time, 1e-6f);
+        position = glm::mix(a.position, b.position, t);
+        target = glm::mix(a.target, b.target, t);
+    }
+
+    glm::vec3 worldUp(0.f, 1.f, 0.f);
+    camera->position = position;
+    camera->front = glm::normalize(target - position);
+    camera->right = glm::normalize(glm::cross(camera->front, worldUp));
+    camera->up = glm::normalize(glm::cross(camera->right, camera->front));
+}
+
+Benchmark *Benchmark::fromArgs(int argc, char **argv)
+{
+    bool enabled = false;
+    BenchmarkSettings settings;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (strcmp(arg, "--benchmark") == 0)
+        {
+            enabled = true;
+            continue;
+        }
+        if (strcmp(arg, "--null-gpu") == 0)
+        {
+            settings.nullGPU = true;
+            continue;
+        }
+
+        if (!value)
+            break;
+
+        if (strcmp(arg, "--frames") == 0)
+            settings.frames = std::max(atoi(value), 1);
+        else if (strcmp(arg, "--warmup") == 0)
+            settings.warmupFrames = std::max(atoi(value), 0);
+        else if (strcmp(arg, "--size") == 0)
+            sscanf(value, "%dx%d", &settings.size.x, &settings.size.y);
+        else if (strcmp(arg, "--scene") == 0)
+            settings.scenePath = value;
+        else if (strcmp(arg, "--camera-path") == 0)
+            settings.cameraPathFile = value;
+        else if (strcmp(arg, "--output") == 0)
+            settings.outputPath = value;
+        else if (strcmp(arg, "--record-commands") == 0)
+            settings.commandsPath = value;
+        else
+            continue;
+        i++;
+    }
+
+    if (!enabled)
+        return nullptr;
+
+    settings.size = glm::max(settings.size, glm::ivec2(1));
+    if (settings.outputPath.empty())
+        settings.outputPath = Utils::getExecutablePath() + "/benchmark.json";
+
+    Benchmark *benchmark = new Benchmark();
+    benchmark->m_settings = settings;
+
+    // Without a path, one orbit around the origin over the recorded frames
+    if (settings.cameraPathFile.empty() || !benchmark->m_cameraPath.loadFromFile(settings.cameraPathFile))
+    {
+        Camera camera;
+        float radius = glm::length(glm::vec2(camera.position.x, camera.position.z));
+        float duration = (settings.warmupFrames + settings.frames) * settings.frameStep;
+        benchmark->m_cameraPath.makeOrbit(glm::vec3(0.f), radius, camera.position.y, duration);
+    }
+
+    return benchmark;
+}
+
+void Benchmark::addFrame(const BenchmarkFrame &frame)
+{
+    m_peakRam = std::max<Uint64>(m_peakRam, Utils::getRamUsage());
+    if (!recording())
+        return;
+
+    m_frames.push_back(frame);
+
+    // A counter first seen mid-recording was zero in the frames before
+    for (const RenderStats::Counter &counter : RenderStats::getInstance().m_counters)
+    {
+        std::vector<float> &values = m_counters[counter.name];
+        values.resize(m_frames.size() - 1, 0.f);
+        values.push_back(counter.history.last());
+    }
+}
+
+static std::string escape(const std::string &text)
+{
+    std::string result;
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            result += '\\';
+        result += c;
+    }
+    return result;
+}
+
+static void writeStats(SDL_IOStream *io, const char *name, std::vector<float> values)
+{
+    std::sort(values.begin(), values.end());
+
+    float sum = 0.f;
+    for (float value : values)
+        sum += value;
+
+    // Nearest rank
+    auto percentile = [&](float p) {
+        size_t rank = (size_t)glm::ceil(p / 100.f * values.size());
+        return values[glm::clamp<size_t>(rank, 1, values.size()) - 1];
+    };
+
+    SDL_IOprintf(io, "  \"%s\": {\"avg\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+                 name, sum / values.size(), values.front(), percentile(50.f), percentile(90.f), percentile(95.f), percentile(99.f), values.back());
+}
+
+bool Benchmark::writeReport(const std::string &deviceName) const
+{
+    if (m_frames.empty())
+    {
+        SDL_Log("Benchmark recorded no frames");
+        return false;
+    }
+
+    SDL_IOStream *io = SDL_IOFromFile(m_settings.outputPath.c_str(), "w");
+    if (!io)
+    {
+        SDL_Log("Failed to open benchmark report %s: %s", m_settings.outputPath.c_str(), SDL_GetError());
+        return false;
+    }
+
+    std::vector<float> cpuTimes, gpuTimes, drawCalls, pipelineChanges, uniformKB;
+    for (const BenchmarkFrame &frame : m_frames)
+    {
+        cpuTimes.push_back(frame.cpuTime);
+        gpuTimes.push_back(frame.gpuTime);
+        drawCalls.push_back((float)frame.gpu.drawCalls);
+        pipelineChanges.push_back((float)frame.gpu.pipelineChanges);
+        uniformKB.push_back(frame.gpu.uniformBytes / 1024.f);
+    }
+
+    SDL_IOprintf(io, "{\n");
+    SDL_IOprintf(io, "  \"device\": \"%s\",\n", escape(deviceName).c_str());
+    SDL_IOprintf(io, "  \"scene\": \"%s\",\n", escape(m_settings.scenePath).c_str());
+    SDL_IOprintf(io, "  \"width\": %d,\n  \"height\": %d,\n", m_settings.size.x, m_settings.size.y);
+    SDL_IOprintf(io, "  \"frames\": %d,\n  \"warmupFrames\": %d,\n", (int)m_frames.size(), m_settings.warmupFrames);
+    SDL_IOprintf(io, "  \"nullGPU\": %s,\n", m_settings.nullGPU ? "true" : "false");
+    writeStats(io, "cpuMs", cpuTimes);
+    SDL_IOprintf(io, ",\n");
+    writeStats(io, "gpuMs", gpuTimes);
+    SDL_IOprintf(io, ",\n");
+    writeStats(io, "drawCalls", drawCalls);
+    SDL_IOprintf(io, ",\n");
+    writeStats(io, "pipelineChanges", pipelineChanges);
+    SDL_IOprintf(io, ",\n");
+    writeStats(io, "uniformKB", uniformKB);
+    SDL_IOprintf(io, ",\n");
+
+    SDL_IOprintf(io, "  \"counters\": {\n");
+    bool first = true;
+    for (const auto &[name, values] : m_counters)
+    {
+        SDL_IOprintf(io, first ? "  " : ",\n  ");
+        writeStats(io, escape(name).c_str(), values);
+        first = false;
+    }
+    SDL_IOprintf(io, "\n  },\n");
+    SDL_IOprintf(io, "  \"memory\": {\"rssBytes\": %llu, \"peakRssBytes\": %llu, \"renderGraphPoolBytes\": %llu, \"gpuBytes\": %llu, \"gpuPeakBytes\": %llu}\n",
+                 (unsigned long long)Utils::getRamUsage(), (unsigned long long)m_peakRam, (unsigned long long)m_renderGraphBytes,
+                 (unsigned long long)GPU::memory.m_total, (unsigned long long)GPU::memory.m_peak);
+    SDL_IOprintf(io, "}\n");
+    SDL_CloseIO(io);
+
+    SDL_Log("Benchmark report written to %s", m_settings.outputPath.c_str());
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <SDL3/SDL_stdinc.h>
+
+#include "../camera.h"
+#include "../gpu/gpu.h"
+
+struct CameraKey
+{
+    float time;
+    glm::vec3 position;
+    glm::vec3 target;
+};
+
+// Keys are interpolated linearly, the path holds the last key after it ends
+class CameraPath
+{
+public:
+    std::vector<CameraKey> m_keys;
+
+    // One key per line: time px py pz tx ty tz, lines starting with # are skipped
+    bool loadFromFile(const std::string &path);
+    void makeOrbit(glm::vec3 center, float radius, float height, float duration, int steps = 32);
+    void apply(Camera *camera, float time) const;
+};
+
+struct BenchmarkSettings
+{
+    int frames = 600;
+    int warmupFrames = 30; // not recorded, lets pools, caches and history buffers settle
+    float frameStep = 1.f / 60.f;
+    glm::ivec2 size = glm::ivec2(1280, 720);
+    std::string scenePath;
+    std::string cameraPathFile;
+    std::string outputPath;
+    bool nullGPU = false;     // skip the scene's GPU commands, measures the CPU side of rendering
+    std::string commandsPath; // writes the commands of the last frame
+};
+
+struct BenchmarkFrame
+{
+    float cpuTime; // ms
+    float gpuTime;
+    GPUStats gpu;
+};
+
+// Headless runs: a fixed camera path over a scene for a number of frames, reported as JSON
+class Benchmark
+{
+public:
+    BenchmarkSettings m_settings;
+    CameraPath m_cameraPath;
+    std::vector<BenchmarkFrame> m_frames;
+    std::map<std::string, std::vector<float>> m_counters; // RenderStats of the recorded frames
+    int m_frameIndex = 0;
+    Uint64 m_peakRam = 0;
+    Uint64 m_renderGraphBytes = 0;
+
+    // Returns a benchmark when --benchmark is on the command line
+    static Benchmark *fromArgs(int argc, char **argv);
+
+    float time() const { return m_frameIndex * m_settings.frameStep; }
+    bool recording() const { return m_frameIndex >= m_settings.warmupFrames; }
+    bool done() const { return m_frameIndex >= m_settings.warmupFrames + m_settings.frames; }
+
+    void addFrame(const BenchmarkFrame &frame);
+    bool writeReport(const std::string &deviceName) const;
+};
@@ -12,6 +12,7 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #endif
 #include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/norm.hpp>
 
@@ -24,8 +25,14 @@
 #include "ui/system_monitor/system_monitor_ui.h"
 #include "utils/utils.h"
 
+#include "benchmark/benchmark.h"
+#include "gpu/gpu.h"
+#include "gpu/gpu_frame_timer.h"
+#include "gpu/render_stats.h"
 #include "input_manager/input_manager.h"
 #include "post_process/post_process.h"
+#include "profiler/profiler.h"
+#include "render_graph/render_graph.h"
 #include "render_manager/render_manager.h"
 #include "resource_manager/resource_manager.h"
 #include "shadow_manager/shadow_manager.h"
@@ -35,6 +42,7 @@ RootUI *DefaultRunner::m_rootUI = nullptr;
 ResourceManager *DefaultRunner::m_resourceManager = nullptr;
 RenderManager *DefaultRunner::m_renderManager = nullptr;
 PostProcess *DefaultRunner::m_postProcess = nullptr;
+RenderGraph *DefaultRunner::m_renderGraph = nullptr;
 UpdateManager *DefaultRunner::m_updateManager = nullptr;
 Camera *DefaultRunner::m_camera = nullptr;
 
@@ -60,12 +68,31 @@ SDL_AppResult DefaultRunner::Init(int argc, char **argv)
     const SDL_GPUShaderFormat shaderFormat = SDL_GPU_SHADERFORMAT_SPIRV;
 #endif
 
-    // Create window
-    m_window = SDL_CreateWindow("SDL_GPU_Kit", m_initWindowSize.x, m_initWindowSize.y, SDL_WINDOW_RESIZABLE);
-    if (!m_window)
+    m_benchmark = Benchmark::fromArgs(argc, argv);
+    if (m_benchmark)
     {
-        SDL_Log("Window creation failed: %s", SDL_GetError());
-        return SDL_APP_FAILURE;
+        // Vulkan is loaded through the video subsystem, the offscreen driver needs no display
+        // so software drivers like lavapipe work on machines without a GPU
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+        if (!SDL_InitSubSystem(SDL_INIT_VIDEO))
+        {
+            SDL_Log("Video init failed: %s", SDL_GetError());
+            return SDL_APP_FAILURE;
+        }
+
+        m_initWindowSize = m_benchmark->m_settings.size;
+        m_width = m_initWindowSize.x;
+        m_height = m_initWindowSize.y;
+    }
+    else
+    {
+        // Create window
+        m_window = SDL_CreateWindow("SDL_GPU_Kit", m_initWindowSize.x, m_initWindowSize.y, SDL_WINDOW_RESIZABLE);
+        if (!m_window)
+        {
+            SDL_Log("Window creation failed: %s", SDL_GetError());
+            return SDL_APP_FAILURE;
+        }
     }
 
     // Create device
@@ -76,12 +103,34 @@ SDL_AppResult DefaultRunner::Init(int argc, char **argv)
         return SDL_APP_FAILURE;
     }
 
-    SDL_ClaimWindowForGPUDevice(m_device, m_window);
+    if (m_window)
+        SDL_ClaimWindowForGPUDevice(m_device, m_window);
 
     // Initialize Global Utils
     Utils::device = m_device;
     Utils::window = m_window;
 
+    if (m_benchmark)
+    {
+        SDL_GPUTextureCreateInfo info{};
+        info.type = SDL_GPU_TEXTURETYPE_2D;
+        info.format = Utils::getPresentFormat();
+        info.width = m_width;
+        info.height = m_height;
+        info.layer_count_or_depth = 1;
+        info.num_levels = 1;
+        info.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
+        info.sample_count = SDL_GPU_SAMPLECOUNT_1;
+
+        m_offscreenTexture = GPU::createTexture(m_device, &info, GPUMemoryCategory::RenderTarget);
+        if (!m_offscreenTexture)
+        {
+            SDL_Log("Failed to create offscreen target: %s", SDL_GetError());
+            return SDL_APP_FAILURE;
+        }
+        SDL_Log("Benchmark: %d frames at %dx%d on %s", m_benchmark->m_settings.frames, m_width, m_height, SDL_GetGPUDeviceDriver(m_device));
+    }
+
     SDL_GPUSampleCount msaaSampleCount = Utils::getClosestSupportedMSAA(SDL_GPU_SAMPLECOUNT_2);
 
     // Initialize Managers
@@ -91,6 +140,8 @@ SDL_AppResult DefaultRunner::Init(int argc, char **argv)
     m_postProcess = new PostProcess(msaaSampleCount);
     m_postProcess->update(m_initWindowSize);
     m_postProcess->m_lutTex = m_renderManager->m_defaultTexture;
+    m_renderGraph = new RenderGraph();
+    m_gpuFrameTimer = new GPUFrameTimer(m_device);
     m_updateManager = new UpdateManager();
     m_camera = new Camera();
 
@@ -106,21 +157,28 @@ SDL_AppResult DefaultRunner::Init(int argc, char **argv)
     style.ScaleAllSizes(main_scale);
     style.FontScaleDpi = main_scale;
 
-    ImGui_ImplSDL3_InitForSDLGPU(m_window);
-    ImGui_ImplSDLGPU3_InitInfo init_info = {};
-    init_info.Device = m_device;
-    init_info.ColorTargetFormat = SDL_GetGPUSwapchainTextureFormat(m_device, m_window);
-    init_info.MSAASamples = SDL_GPU_SAMPLECOUNT_1;
-    init_info.SwapchainComposition = SDL_GPU_SWAPCHAINCOMPOSITION_SDR;
-    init_info.PresentMode = SDL_GPU_PRESENTMODE_VSYNC;
-    ImGui_ImplSDLGPU3_Init(&init_info);
+    // Headless runs draw no UI
+    if (m_window)
+    {
+        ImGui_ImplSDL3_InitForSDLGPU(m_window);
+        ImGui_ImplSDLGPU3_InitInfo init_info = {};
+        init_info.Device = m_device;
+        init_info.ColorTargetFormat = SDL_GetGPUSwapchainTextureFormat(m_device, m_window);
+        init_info.MSAASamples = SDL_GPU_SAMPLECOUNT_1;
+        init_info.SwapchainComposition = SDL_GPU_SWAPCHAINCOMPOSITION_SDR;
+        init_info.PresentMode = SDL_GPU_PRESENTMODE_VSYNC;
+        ImGui_ImplSDLGPU3_Init(&init_info);
+    }
 
     m_rootUI = new RootUI();
     m_systemMonitorUI = new SystemMonitorUI();
     m_rootUI->add(m_systemMonitorUI);
+    m_rootUI->add(&Profiler::getInstance());
     m_rootUI->add(m_postProcess);
+    m_rootUI->add(m_renderGraph);
     m_rootUI->add(m_renderManager);
     m_rootUI->add(m_renderManager->m_shadowManager);
+    m_rootUI->add(m_renderManager->m_lightManager);
 
     return SDL_APP_CONTINUE;
 }
@@ -131,163 +189,298 @@ SDL_AppResult DefaultRunner::Iterate()
     m_deltaTime = (currentFrame - m_lastFrame) / 1e9f;
     m_lastFrame = currentFrame;
 
+    // Fixed steps keep benchmark runs comparable
+    if (m_benchmark)
+    {
+        m_deltaTime = m_benchmark->m_settings.frameStep;
+        m_benchmark->m_cameraPath.apply(m_camera, m_benchmark->time());
+
+        const BenchmarkSettings &settings = m_benchmark->m_settings;
+        GPU::nullBackend = settings.nullGPU;
+        GPU::recording = !settings.commandsPath.empty() && m_benchmark->m_frameIndex + 1 == settings.warmupFrames + settings.frames;
+    }
+    GPU::beginFrame();
+
+    Profiler &profiler = Profiler::getInstance();
+    profiler.beginFrame();
+
     m_postProcess->m_gtaoMask.clear(1);
 
     m_camera->view = glm::lookAt(m_camera->position, m_camera->position + m_camera->front, m_camera->up);
     m_camera->projection = glm::perspective(glm::radians(m_camera->fov), (float)m_width / (float)m_height, m_camera->near, m_camera->far);
+    profiler.beginZone("Update");
     m_updateManager->update(m_deltaTime);
+    profiler.endZone();
+    // Finishes every animator before the passes read the bone matrices
+    profiler.beginZone("Animation");
+    m_renderManager->m_animationManager->update(m_deltaTime);
+    profiler.endZone();
 
     SDL_GPUCommandBuffer *commandBuffer = SDL_AcquireGPUCommandBuffer(m_device);
 
-    SDL_GPUTexture *swapchainTexture;
-    SDL_WaitAndAcquireGPUSwapchainTexture(commandBuffer, m_window, &swapchainTexture, &m_width, &m_height);
+    Uint64 acquireStart = SDL_GetTicksNS();
+    SDL_GPUTexture *swapchainTexture = m_offscreenTexture;
+    if (m_window)
+        SDL_WaitAndAcquireGPUSwapchainTexture(commandBuffer, m_window, &swapchainTexture, &m_width, &m_height);
+    Uint64 acquireTime = SDL_GetTicksNS() - acquireStart;
 
     if (swapchainTexture == NULL)
     {
         SDL_SubmitGPUCommandBuffer(commandBuffer);
+        profiler.endFrame();
         return SDL_APP_CONTINUE;
     }
 
     m_postProcess->update({m_width, m_height});
-    m_renderManager->updateResources({m_width, m_height}, m_postProcess->m_sampleCount);
+    m_renderManager->updateResources(m_postProcess->m_targetSize, m_postProcess->m_sampleCount);
+    const glm::ivec2 renderSize = m_postProcess->m_renderSize;
 
     // Camera Matrices
     const glm::mat4 &view = m_camera->view;
     const glm::mat4 &projection = m_camera->projection;
+    const glm::mat4 viewProjection = projection * view;
+
+    // TAA jitters the rasterized passes only, everything reconstructing from depth keeps the stable projection
+    m_renderManager->m_frameIndex++;
+    m_renderManager->m_jitter = m_postProcess->m_jitter;
+    const glm::mat4 jitteredProjection = glm::translate(glm::mat4(1.f), glm::vec3(m_postProcess->m_jitter, 0.f)) * projection;
     m_renderManager->m_fragmentUniforms.viewPos = m_camera->position;
     m_renderManager->m_pbrManager->m_sunUBO.sunPosition = -m_renderManager->m_fragmentUniforms.lightDir * 100000.f;
     m_renderManager->m_pbrManager->m_sunUBO.time += m_deltaTime;
 
-    // --- Shadow Pass ---
-    float aspect = static_cast<float>(m_width) / static_cast<float>(m_height);
-    m_renderManager->m_shadowManager->updateCascades(m_camera, view, -m_renderManager->m_fragmentUniforms.lightDir, aspect);
+    RenderGraph &graph = *m_renderGraph;
+    graph.begin();
+
+    RGTexture swapchain = graph.importSwapchain("Swapchain", swapchainTexture);
+    RGTexture sceneColor = graph.importTexture("Scene Color", m_postProcess->m_colorTexture);
+    RGTexture velocity = graph.importTexture("Velocity", m_postProcess->m_velocityTexture);
+    RGTexture msaaDepth = graph.importTexture("Depth", m_postProcess->m_msaaDepthTexture);
+    RGTexture depth = graph.importTexture("Resolved Depth", m_postProcess->m_depthTexture);
+    RGTexture shadowMap = graph.importTexture("Shadow Map", m_renderManager->m_shadowManager->m_shadowMapTexture);
+    RGTexture oitAccum = graph.importTexture("OIT Accum", m_renderManager->m_accumTexture);
+    RGTexture oitReveal = graph.importTexture("OIT Reveal", m_renderManager->m_revealTexture);
+
+    // --- Light Clusters ---
+    LightManager *lightManager = m_renderManager->m_lightManager;
+    graph.addPass("Light Clusters", [&](SDL_GPUCommandBuffer *cmd, RenderGraph &) {
+             lightManager->update(cmd, view, projection, m_camera->near, m_camera->far, renderSize);
+             m_renderManager->m_fragmentUniforms.cluster = lightManager->m_clusterUniforms;
+         })
+        .sideEffect();
 
+    // --- Shadow Pass ---
     ShadowManager *shadowManager = m_renderManager->m_shadowManager;
-
-    SDL_GPUColorTargetInfo colorTargetInfo{};
-    colorTargetInfo.texture = shadowManager->m_shadowMapTexture;
-    colorTargetInfo.clear_color = {1.f, 0.f, 0.f, 0.0f};
-    colorTargetInfo.load_op = SDL_GPU_LOADOP_CLEAR;
-    colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
-
-    SDL_GPUViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.w = static_cast<float>(shadowManager->m_shadowMapResolution);
-    viewport.h = static_cast<float>(shadowManager->m_shadowMapResolution);
-    viewport.min_depth = 0.0f;
-    viewport.max_depth = 1.0f;
-
-    for (int cascadeIndex = 0; cascadeIndex < NUM_CASCADES; ++cascadeIndex)
+    graph.addPass("Shadow Cascades", [&](SDL_GPUCommandBuffer *cmd, RenderGraph &) {
+             float aspect = static_cast<float>(m_width) / static_cast<float>(m_height);
+             profiler.beginZone("Cascade Setup");
+             shadowManager->updateCascades(m_camera, view, -m_renderManager->m_fragmentUniforms.lightDir, aspect);
+             profiler.endZone();
+             shadowManager->renderCascades(cmd, m_renderManager->m_renderables);
+         })
+        .write(shadowMap);
+
+    // --- Depth Prepass ---
+    // Also required by the screen-space shadow mask, which reconstructs positions from it
+    const bool depthPrepass = m_renderManager->m_depthPrepassEnabled || shadowManager->m_screenSpaceMask;
+    m_renderManager->m_depthPrepassActive = depthPrepass;
+    if (depthPrepass)
     {
-        colorTargetInfo.layer_or_depth_plane = cascadeIndex;
+        graph.addPass("Depth Prepass", [&](SDL_GPUCommandBuffer *cmd, RenderGraph &) {
+                 SDL_GPUDepthStencilTargetInfo prepassDepthInfo{};
+                 prepassDepthInfo.texture = m_postProcess->m_msaaDepthTexture;
+                 prepassDepthInfo.clear_depth = 1.0f;
+                 prepassDepthInfo.load_op = SDL_GPU_LOADOP_CLEAR;
+                 prepassDepthInfo.store_op = SDL_GPU_STOREOP_STORE;
+                 prepassDepthInfo.stencil_load_op = SDL_GPU_LOADOP_CLEAR;
+                 prepassDepthInfo.stencil_store_op = SDL_GPU_STOREOP_STORE;
+
+                 SDL_GPURenderPass *prepass = GPU::beginRenderPass(cmd, nullptr, 0, &prepassDepthInfo);
+                 m_postProcess->bindRenderViewport(cmd, prepass);
+                 m_renderManager->renderDepth(cmd, prepass, view, jitteredProjection);
+                 SDL_EndGPURenderPass(prepass);
+
+                 m_postProcess->resolveDepth(cmd);
+
+                 if (shadowManager->m_screenSpaceMask)
+                 {
+                     shadowManager->renderScreenMask(
+                         cmd,
+                         m_postProcess->m_depthTexture,
+                         m_postProcess->m_targetSize,
+                         renderSize,
+                         view,
+                         projection,
+                         m_camera->position,
+                         m_renderManager->m_fragmentUniforms.lightDir);
+                 }
+             })
+            .write(msaaDepth, true)
+            .write(depth)
+            .read(shadowMap);
+    }
 
-        SDL_GPURenderPass *shadowPass = SDL_BeginGPURenderPass(commandBuffer, &colorTargetInfo, 1, nullptr);
+    graph.addPass("Opaque", [&](SDL_GPUCommandBuffer *cmd, RenderGraph &) {
+             // 1. Setup Color Target: Render to MSAA, Resolve to Normal
+             SDL_GPUColorTargetInfo colorTargetInfo = graph.colorTarget(sceneColor);
+             colorTargetInfo.clear_color = {0.f, 0.f, 0.f, 1.0f};
+
+             // 2. Setup Depth Target
+             SDL_GPUDepthStencilTargetInfo depthInfo{};
+             depthInfo.texture = m_postProcess->m_msaaDepthTexture;
+             depthInfo.clear_depth = 1.0f;
+             depthInfo.load_op = depthPrepass ? SDL_GPU_LOADOP_LOAD : SDL_GPU_LOADOP_CLEAR;
+             depthInfo.store_op = SDL_GPU_STOREOP_STORE;
+             depthInfo.stencil_load_op = SDL_GPU_LOADOP_CLEAR;
+             depthInfo.stencil_store_op = SDL_GPU_STOREOP_STORE;
+
+             // Motion vectors, written next to the color
+             SDL_GPUColorTargetInfo velocityTargetInfo = graph.colorTarget(velocity);
+
+             // The graph's textures take the resolve, the multisampled contents are dropped
+             if (m_postProcess->m_sampleCount != SDL_GPU_SAMPLECOUNT_1)
+             {
+                 colorTargetInfo.resolve_texture = colorTargetInfo.texture;
+                 colorTargetInfo.texture = m_postProcess->m_msaaColorTexture;
+                 colorTargetInfo.store_op = SDL_GPU_STOREOP_RESOLVE;
+                 velocityTargetInfo.resolve_texture = velocityTargetInfo.texture;
+                 velocityTargetInfo.texture = m_postProcess->m_msaaVelocityTexture;
+                 velocityTargetInfo.store_op = SDL_GPU_STOREOP_RESOLVE;
+             }
+
+             SDL_GPUColorTargetInfo sceneTargets[2] = {colorTargetInfo, velocityTargetInfo};
+
+             SDL_GPURenderPass *renderPass = GPU::beginRenderPass(cmd, sceneTargets, 2, &depthInfo);
+             m_postProcess->bindRenderViewport(cmd, renderPass);
+             m_renderManager->renderOpaque(cmd, renderPass, view, jitteredProjection, m_camera->position);
+             m_renderManager->m_pbrManager->renderSkybox(cmd, renderPass, view, jitteredProjection);
+             SDL_EndGPURenderPass(renderPass);
+         })
+        .read(shadowMap)
+        .read(depthPrepass ? msaaDepth : RGTexture{})
+        .write(msaaDepth, !depthPrepass)
+        .write(sceneColor, true)
+        .write(velocity, true);
+
+    // Also feeds the SDSM readback, which nothing in the graph consumes
+    graph.addPass("Depth Resolve", [&](SDL_GPUCommandBuffer *cmd, RenderGraph &) {
+             // The prepass resolve stays valid unless alpha tested surfaces added depth
+             if (!depthPrepass || m_renderManager->m_alphaTestedDraws > 0)
+                 m_postProcess->resolveDepth(cmd);
+             shadowManager->reduceDepth(
+                 cmd, m_postProcess->m_hiZTexture, m_postProcess->m_hiZSize, m_postProcess->getHiZRegion(0));
+         })
+        .read(msaaDepth)
+        .read(depth)
+        .write(depth)
+        .sideEffect();
+
+    graph.addPass("Transparent", [&](SDL_GPUCommandBuffer *cmd, RenderGraph &) {
+             SDL_GPUColorTargetInfo oitTargets[2];
+             oitTargets[0] = graph.colorTarget(oitAccum);
+             oitTargets[1] = graph.colorTarget(oitReveal);
+             oitTargets[1].clear_color = {1, 1, 1, 1};
+
+             SDL_GPUDepthStencilTargetInfo depthInfo{};
+             depthInfo.texture = m_postProcess->m_depthTexture;
+             depthInfo.load_op = SDL_GPU_LOADOP_LOAD;
+             depthInfo.store_op = SDL_GPU_STOREOP_STORE;
+             depthInfo.stencil_load_op = SDL_GPU_LOADOP_LOAD;
+             depthInfo.stencil_store_op = SDL_GPU_STOREOP_STORE;
+
+             SDL_GPURenderPass *oitPass = GPU::beginRenderPass(cmd, oitTargets, 2, &depthInfo);
+             m_postProcess->bindRenderViewport(cmd, oitPass);
+             m_renderManager->renderTransparent(cmd, oitPass, view, jitteredProjection, m_camera->position);
+             SDL_EndGPURenderPass(oitPass);
+         })
+        .read(depth)
+        .read(shadowMap)
+        .write(oitAccum, true)
+        .write(oitReveal, true);
+
+    graph.addPass("OIT Composite", [&](SDL_GPUCommandBuffer *cmd, RenderGraph &) {
+             SDL_GPUColorTargetInfo colorTargetInfo = graph.colorTarget(sceneColor);
+
+             SDL_GPURenderPass *compPass = GPU::beginRenderPass(cmd, &colorTargetInfo, 1, nullptr);
+             m_postProcess->bindRenderViewport(cmd, compPass);
+             m_renderManager->renderComposite(cmd, compPass);
+             SDL_EndGPURenderPass(compPass);
+         })
+        .read(oitAccum)
+        .read(oitReveal)
+        .read(sceneColor)
+        .write(sceneColor);
 
-        const Cascade &cascade = shadowManager->m_cascades[cascadeIndex];
-        const glm::mat4 &lightView = cascade.view;
-        const glm::mat4 &lightProj = cascade.projection;
-        const glm::mat4 lightViewProj = lightProj * lightView;
+    // Post Processing
+    PostProcessFrame postFrame;
+    postFrame.color = sceneColor;
+    postFrame.velocity = velocity;
+    postFrame.depth = depth;
+    postFrame.swapchain = swapchain;
+    postFrame.swapchainSize = glm::ivec2(m_width, m_height);
+    postFrame.projection = projection;
+    postFrame.view = view;
+    postFrame.prevViewProjection = m_renderManager->m_prevViewProjection;
+    postFrame.nearPlane = m_camera->near;
+    postFrame.farPlane = m_camera->far;
+    m_postProcess->addPasses(graph, postFrame);
+    m_renderManager->m_prevViewProjection = viewProjection;
 
-        SDL_BindGPUGraphicsPipeline(shadowPass, shadowManager->m_shadowPipeline);
-        SDL_SetGPUViewport(shadowPass, &viewport);
+    // UI
+    if (m_window)
+    {
+        graph.addPass("UI", [&](SDL_GPUCommandBuffer *cmd, RenderGraph &) {
+                 m_rootUI->render(cmd, swapchainTexture);
+             })
+            .read(swapchain)
+            .write(swapchain)
+            .sideEffect();
+    }
 
-        const Frustum frustum = Frustum::fromMatrix(lightViewProj);
+    graph.execute(commandBuffer);
 
-        for (Renderable *r : m_renderManager->m_renderables)
-        {
-            r->renderShadow(commandBuffer, shadowPass, lightViewProj, frustum);
-        }
+    Uint64 recordEnd = SDL_GetTicksNS();
+    float cpuFrameTime = (recordEnd - currentFrame - acquireTime) / 1e6f;
+    m_postProcess->updateRenderScale(cpuFrameTime, m_gpuFrameTimer->poll());
 
-        SDL_BindGPUGraphicsPipeline(shadowPass, shadowManager->m_shadowDoubleSidedPipeline);
-        SDL_SetGPUViewport(shadowPass, &viewport);
+    m_frameSubmitTime = SDL_GetTicksNS();
 
-        for (Renderable *r : m_renderManager->m_renderables)
-        {
-            r->renderShadowDoubleSided(commandBuffer, shadowPass, lightViewProj, frustum);
-        }
+    // Depth bounds are read back next frame once this fence signals
+    if (shadowManager->m_depthReadbackPending)
+        shadowManager->setReadbackFence(SDL_SubmitGPUCommandBufferAndAcquireFence(commandBuffer));
+    else
+        SDL_SubmitGPUCommandBuffer(commandBuffer);
 
-        SDL_BindGPUGraphicsPipeline(shadowPass, shadowManager->m_shadowAnimationPipeline);
-        SDL_SetGPUViewport(shadowPass, &viewport);
+    if (m_postProcess->m_dynamicResolution)
+        m_gpuFrameTimer->endFrame(m_frameSubmitTime);
 
-        for (Renderable *r : m_renderManager->m_renderables)
-        {
-            r->renderAnimationShadow(commandBuffer, shadowPass, lightViewProj, frustum);
-        }
+    // Everything from the swapchain on was recorded into the frame's command buffer
+    if (profiler.gpuTimingsActive())
+        profiler.submitGPU(SDL_AcquireGPUCommandBuffer(m_device), "Post + UI", m_frameSubmitTime);
 
-        SDL_EndGPURenderPass(shadowPass);
-    }
+    RenderStats::getInstance().endFrame();
 
-    // 1. Setup Color Target: Render to MSAA, Resolve to Normal
-    colorTargetInfo = SDL_GPUColorTargetInfo();
-    colorTargetInfo.texture = m_postProcess->m_msaaColorTexture;
-    colorTargetInfo.clear_color = {0.f, 0.f, 0.f, 1.0f};
-    colorTargetInfo.load_op = SDL_GPU_LOADOP_CLEAR;
-    colorTargetInfo.store_op = SDL_GPU_STOREOP_RESOLVE;
-    colorTargetInfo.resolve_texture = m_postProcess->m_colorTexture;
-
-    // 2. Setup Depth Target
-    SDL_GPUDepthStencilTargetInfo depthInfo{};
-    depthInfo.texture = m_postProcess->m_msaaDepthTexture;
-    depthInfo.clear_depth = 1.0f;
-    depthInfo.load_op = SDL_GPU_LOADOP_CLEAR;
-    depthInfo.store_op = SDL_GPU_STOREOP_STORE;
-    depthInfo.stencil_load_op = SDL_GPU_LOADOP_CLEAR;
-    depthInfo.stencil_store_op = SDL_GPU_STOREOP_STORE;
-
-    if (m_postProcess->m_sampleCount == SDL_GPU_SAMPLECOUNT_1)
+    // Benchmark frames wait for the GPU, the submission lands on an idle GPU so submit to signal is its time
+    if (m_benchmark)
     {
-        colorTargetInfo.texture = m_postProcess->m_colorTexture;
-        colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
-    }
+        SDL_GPUFence *fence = SDL_SubmitGPUCommandBufferAndAcquireFence(SDL_AcquireGPUCommandBuffer(m_device));
+        SDL_WaitForGPUFences(m_device, true, &fence, 1);
+        float gpuTime = (SDL_GetTicksNS() - m_frameSubmitTime) / 1e6f;
+        SDL_ReleaseGPUFence(m_device, fence);
 
-    SDL_GPURenderPass *renderPass = SDL_BeginGPURenderPass(commandBuffer, &colorTargetInfo, 1, &depthInfo);
-    m_renderManager->renderOpaque(commandBuffer, renderPass, view, projection, m_camera->position);
-    m_renderManager->m_pbrManager->renderSkybox(commandBuffer, renderPass, view, projection);
-    SDL_EndGPURenderPass(renderPass);
-
-    m_postProcess->resolveDepth(commandBuffer);
-
-    // OIT Pass
-    SDL_GPUColorTargetInfo oitTargets[2];
-    oitTargets[0] = SDL_GPUColorTargetInfo{};
-    oitTargets[0].texture = m_renderManager->m_accumTexture;
-    oitTargets[0].load_op = SDL_GPU_LOADOP_CLEAR;
-    oitTargets[0].clear_color = {0, 0, 0, 0};
-    oitTargets[1] = SDL_GPUColorTargetInfo{};
-    oitTargets[1].texture = m_renderManager->m_revealTexture;
-    oitTargets[1].load_op = SDL_GPU_LOADOP_CLEAR;
-    oitTargets[1].clear_color = {1, 1, 1, 1};
-
-    depthInfo.texture = m_postProcess->m_depthTexture;
-    depthInfo.load_op = SDL_GPU_LOADOP_LOAD;
-    depthInfo.store_op = SDL_GPU_STOREOP_STORE;
-    depthInfo.stencil_load_op = SDL_GPU_LOADOP_LOAD;
-    depthInfo.stencil_store_op = SDL_GPU_STOREOP_STORE;
-
-    SDL_GPURenderPass *oitPass = SDL_BeginGPURenderPass(commandBuffer, oitTargets, 2, &depthInfo);
-    m_renderManager->renderTransparent(commandBuffer, oitPass, view, projection, m_camera->position);
-    SDL_EndGPURenderPass(oitPass);
-
-    // Composite pass
-    colorTargetInfo.texture = m_postProcess->m_colorTexture;
-    colorTargetInfo.load_op = SDL_GPU_LOADOP_LOAD;
-
-    SDL_GPURenderPass *compPass = SDL_BeginGPURenderPass(commandBuffer, &colorTargetInfo, 1, nullptr);
-    m_renderManager->renderComposite(commandBuffer, compPass);
-    SDL_EndGPURenderPass(compPass);
+        m_benchmark->addFrame({cpuFrameTime, gpuTime, GPU::stats});
+        m_benchmark->m_frameIndex++;
 
-    // Post Processing
-    m_postProcess->computeGTAO(commandBuffer, projection, view, m_camera->near, m_camera->far);
-    m_postProcess->downsample(commandBuffer);
-    m_postProcess->upsample(commandBuffer);
-    m_postProcess->runSMAA(commandBuffer);
-    m_postProcess->postProcess(commandBuffer, swapchainTexture, {m_width, m_height});
+        if (GPU::recording)
+            GPU::writeCommands(m_benchmark->m_settings.commandsPath);
+    }
 
-    // UI
-    m_rootUI->render(commandBuffer, swapchainTexture);
+    profiler.endFrame();
 
-    SDL_SubmitGPUCommandBuffer(commandBuffer);
+    if (m_benchmark && m_benchmark->done())
+    {
+        m_benchmark->m_renderGraphBytes = m_renderGraph->m_poolBytes;
+        return m_benchmark->writeReport(SDL_GetGPUDeviceDriver(m_device)) ? SDL_APP_SUCCESS : SDL_APP_FAILURE;
+    }
 
     return SDL_APP_CONTINUE;
 }
@@ -296,7 +489,8 @@ SDL_AppResult DefaultRunner::ProcessEvent(SDL_Event *event)
 {
     InputManager::getInstance().processEvent(*event);
 
-    ImGui_ImplSDL3_ProcessEvent(event);
+    if (m_window)
+        ImGui_ImplSDL3_ProcessEvent(event);
 
     if (event->type == SDL_EVENT_WINDOW_CLOSE_REQUESTED)
         return SDL_APP_SUCCESS;
@@ -314,6 +508,8 @@ void DefaultRunner::Quit()
         delete m_resourceManager;
     if (m_renderManager)
         delete m_renderManager;
+    if (m_renderGraph)
+        delete m_renderGraph;
     if (m_postProcess)
         delete m_postProcess;
     if (m_updateManager)
@@ -321,6 +517,13 @@ void DefaultRunner::Quit()
     if (m_camera)
         delete m_camera;
 
+    if (m_gpuFrameTimer)
+        delete m_gpuFrameTimer;
+    if (m_offscreenTexture)
+        GPU::releaseTexture(m_device, m_offscreenTexture);
+    if (m_benchmark)
+        delete m_benchmark;
+
     if (m_device)
         SDL_DestroyGPUDevice(m_device);
     if (m_window)
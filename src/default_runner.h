@@ -8,6 +8,9 @@ class SystemMonitorUI;
 class ResourceManager;
 class RenderManager;
 class PostProcess;
+class RenderGraph;
+class Benchmark;
+class GPUFrameTimer;
 struct UpdateManager;
 struct InputManager;
 
@@ -27,6 +30,14 @@ public:
     float m_deltaTime = 0.0f;
     Uint64 m_lastFrame = 0;
 
+    // Frame timing for dynamic resolution, GPU times arrive a few frames late
+    GPUFrameTimer *m_gpuFrameTimer = nullptr;
+    Uint64 m_frameSubmitTime = 0;
+
+    // Set by --benchmark, renders into the offscreen texture without a window
+    Benchmark *m_benchmark = nullptr;
+    SDL_GPUTexture *m_offscreenTexture = nullptr;
+
     // Viewport
     glm::ivec2 m_initWindowSize;
     Uint32 m_width, m_height;
@@ -37,6 +48,7 @@ public:
     static ResourceManager *m_resourceManager;
     static RenderManager *m_renderManager;
     static PostProcess *m_postProcess;
+    static RenderGraph *m_renderGraph;
     static UpdateManager *m_updateManager;
     static Camera *m_camera;
 
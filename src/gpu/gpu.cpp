@@ -0,0 +1,85 @@
+#include "gpu.h"
+
+#include <SDL3/SDL_iostream.h>
+#include <SDL3/SDL_log.h>
+
+bool GPU::nullBackend = false;
+bool GPU::recording = false;
+GPUStats GPU::stats;
+std::vector<GPUCommand> GPU::commands;
+GPUMemory GPU::memory;
+SDL_GPUGraphicsPipeline *GPU::boundPipeline = nullptr;
+SDL_GPUComputePipeline *GPU::boundComputePipeline = nullptr;
+
+static const char *commandName(GPUCommandType type)
+{
+    switch (type)
+    {
+    case GPUCommandType::BindGraphicsPipeline:
+        return "BindGraphicsPipeline";
+    case GPUCommandType::BindVertexBuffers:
+        return "BindVertexBuffers";
+    case GPUCommandType::BindIndexBuffer:
+        return "BindIndexBuffer";
+    case GPUCommandType::BindFragmentSamplers:
+        return "BindFragmentSamplers";
+    case GPUCommandType::BindFragmentStorageBuffers:
+        return "BindFragmentStorageBuffers";
+    case GPUCommandType::PushVertexUniformData:
+        return "PushVertexUniformData";
+    case GPUCommandType::PushFragmentUniformData:
+        return "PushFragmentUniformData";
+    case GPUCommandType::DrawPrimitives:
+        return "DrawPrimitives";
+    case GPUCommandType::DrawIndexedPrimitives:
+        return "DrawIndexedPrimitives";
+    case GPUCommandType::BeginComputePass:
+        return "BeginComputePass";
+    case GPUCommandType::BindComputePipeline:
+        return "BindComputePipeline";
+    case GPUCommandType::BindComputeSamplers:
+        return "BindComputeSamplers";
+    case GPUCommandType::BindComputeStorageBuffers:
+        return "BindComputeStorageBuffers";
+    case GPUCommandType::PushComputeUniformData:
+        return "PushComputeUniformData";
+    case GPUCommandType::DispatchCompute:
+        return "DispatchCompute";
+    case GPUCommandType::DispatchComputeIndirect:
+        return "DispatchComputeIndirect";
+    case GPUCommandType::SetViewport:
+        return "SetViewport";
+    case GPUCommandType::SetScissor:
+        return "SetScissor";
+    case GPUCommandType::SetStencilReference:
+        return "SetStencilReference";
+    case GPUCommandType::BlitTexture:
+        return "BlitTexture";
+    }
+    return "Unknown";
+}
+
+void GPU::beginFrame()
+{
+    stats = GPUStats();
+    commands.clear();
+    boundPipeline = nullptr;
+    boundComputePipeline = nullptr;
+}
+
+bool GPU::writeCommands(const std::string &path)
+{
+    SDL_IOStream *io = SDL_IOFromFile(path.c_str(), "w");
+    if (!io)
+    {
+        SDL_Log("Failed to open command recording %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    // One command per line: name, object, slot, count
+    for (const GPUCommand &command : commands)
+        SDL_IOprintf(io, "%s %p %u %u\n", commandName(command.type), command.object, command.slot, command.count);
+
+    SDL_CloseIO(io);
+    return true;
+}
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL_gpu.h>
+
+#include "gpu_memory.h"
+
+struct GPUStats
+{
+    Uint32 drawCalls = 0;
+    Uint64 triangles = 0; // every draw is a triangle list
+    Uint32 pipelineBinds = 0;
+    Uint32 pipelineChanges = 0; // binds of a pipeline other than the one bound in the pass
+    Uint32 vertexBufferBinds = 0;
+    Uint32 indexBufferBinds = 0;
+    Uint32 samplerBinds = 0; // bindings, not calls
+    Uint32 storageBufferBinds = 0;
+    Uint32 uniformPushes = 0;
+    Uint32 stateChanges = 0; // viewport, scissor and stencil reference
+    Uint64 uniformBytes = 0;
+    Uint32 renderPasses = 0;
+    Uint32 computePasses = 0;
+    Uint32 dispatches = 0; // direct and indirect
+    Uint32 blits = 0;
+    Uint64 uploadBytes = 0;
+    Uint32 texturesCreated = 0;
+    Uint32 buffersCreated = 0;
+    Uint32 primitivesVisible = 0; // frustum tests of the renderables
+    Uint32 primitivesCulled = 0;
+};
+
+enum class GPUCommandType
+{
+    BindGraphicsPipeline,
+    BindVertexBuffers,
+    BindIndexBuffer,
+    BindFragmentSamplers,
+    BindFragmentStorageBuffers,
+    PushVertexUniformData,
+    PushFragmentUniformData,
+    DrawPrimitives,
+    DrawIndexedPrimitives,
+    BeginComputePass,
+    BindComputePipeline,
+    BindComputeSamplers,
+    BindComputeStorageBuffers,
+    PushComputeUniformData,
+    DispatchCompute,
+    DispatchComputeIndirect,
+    SetViewport,
+    SetScissor,
+    SetStencilReference,
+    BlitTexture
+};
+
+struct GPUCommand
+{
+    GPUCommandType type;
+    const void *object; // pipeline, first buffer or first texture
+    Uint32 slot;
+    Uint32 count; // bindings, bytes, vertices, groups or texels
+};
+
+// Draw and dispatch path of the renderers: counts every call, records it on request and
+// forwards it to SDL unless the null backend is on, which keeps the whole CPU side
+// of a frame (traversal, culling, uniform packing) and drops only the GPU work.
+// Render passes, creation and uploads are only counted, allocations are tracked in memory.
+// Compute passes are not begun at all under the null backend, end them with endComputePass.
+class GPU
+{
+public:
+    static bool nullBackend;
+    static bool recording;
+    static GPUStats stats;
+    static std::vector<GPUCommand> commands;
+    static GPUMemory memory;
+
+    // Stats and the recording are per frame
+    static void beginFrame();
+    static bool writeCommands(const std::string &path);
+
+    static void bindGraphicsPipeline(SDL_GPURenderPass *pass, SDL_GPUGraphicsPipeline *pipeline)
+    {
+        stats.pipelineBinds++;
+        if (pipeline != boundPipeline)
+            stats.pipelineChanges++;
+        boundPipeline = pipeline;
+        record(GPUCommandType::BindGraphicsPipeline, pipeline, 0, 1);
+
+        if (!nullBackend)
+            SDL_BindGPUGraphicsPipeline(pass, pipeline);
+    }
+
+    static void bindVertexBuffers(SDL_GPURenderPass *pass, Uint32 firstSlot, const SDL_GPUBufferBinding *bindings, Uint32 numBindings)
+    {
+        stats.vertexBufferBinds += numBindings;
+        record(GPUCommandType::BindVertexBuffers, bindings[0].buffer, firstSlot, numBindings);
+
+        if (!nullBackend)
+            SDL_BindGPUVertexBuffers(pass, firstSlot, bindings, numBindings);
+    }
+
+    static void bindIndexBuffer(SDL_GPURenderPass *pass, const SDL_GPUBufferBinding *binding, SDL_GPUIndexElementSize indexElementSize)
+    {
+        stats.indexBufferBinds++;
+        record(GPUCommandType::BindIndexBuffer, binding->buffer, 0, 1);
+
+        if (!nullBackend)
+            SDL_BindGPUIndexBuffer(pass, binding, indexElementSize);
+    }
+
+    static void bindFragmentSamplers(SDL_GPURenderPass *pass, Uint32 firstSlot, const SDL_GPUTextureSamplerBinding *bindings, Uint32 numBindings)
+    {
+        stats.samplerBinds += numBindings;
+        record(GPUCommandType::BindFragmentSamplers, bindings[0].texture, firstSlot, numBindings);
+
+        if (!nullBackend)
+            SDL_BindGPUFragmentSamplers(pass, firstSlot, bindings, numBindings);
+    }
+
+    static void bindFragmentStorageBuffers(SDL_GPURenderPass *pass, Uint32 firstSlot, SDL_GPUBuffer *const *buffers, Uint32 numBindings)
+    {
+        stats.storageBufferBinds += numBindings;
+        record(GPUCommandType::BindFragmentStorageBuffers, buffers[0], firstSlot, numBindings);
+
+        if (!nullBackend)
+            SDL_BindGPUFragmentStorageBuffers(pass, firstSlot, buffers, numBindings);
+    }
+
+    static void pushVertexUniformData(SDL_GPUCommandBuffer *cmd, Uint32 slot, const void *data, Uint32 length)
+    {
+        stats.uniformPushes++;
+        stats.uniformBytes += length;
+        record(GPUCommandType::PushVertexUniformData, nullptr, slot, length);
+
+        if (!nullBackend)
+            SDL_PushGPUVertexUniformData(cmd, slot, data, length);
+    }
+
+    static void pushFragmentUniformData(SDL_GPUCommandBuffer *cmd, Uint32 slot, const void *data, Uint32 length)
+    {
+        stats.uniformPushes++;
+        stats.uniformBytes += length;
+        record(GPUCommandType::PushFragmentUniformData, nullptr, slot, length);
+
+        if (!nullBackend)
+            SDL_PushGPUFragmentUniformData(cmd, slot, data, length);
+    }
+
+    static void drawPrimitives(SDL_GPURenderPass *pass, Uint32 numVertices, Uint32 numInstances, Uint32 firstVertex, Uint32 firstInstance)
+    {
+        stats.drawCalls++;
+        stats.triangles += (Uint64)numVertices / 3 * numInstances;
+        record(GPUCommandType::DrawPrimitives, nullptr, 0, numVertices);
+
+        if (!nullBackend)
+            SDL_DrawGPUPrimitives(pass, numVertices, numInstances, firstVertex, firstInstance);
+    }
+
+    static void drawIndexedPrimitives(SDL_GPURenderPass *pass, Uint32 numIndices, Uint32 numInstances, Uint32 firstIndex, Sint32 vertexOffset, Uint32 firstInstance)
+    {
+        stats.drawCalls++;
+        stats.triangles += (Uint64)numIndices / 3 * numInstances;
+        record(GPUCommandType::DrawIndexedPrimitives, nullptr, 0, numIndices);
+
+        if (!nullBackend)
+            SDL_DrawGPUIndexedPrimitives(pass, numIndices, numInstances, firstIndex, vertexOffset, firstInstance);
+    }
+
+    static void setViewport(SDL_GPURenderPass *pass, const SDL_GPUViewport *viewport)
+    {
+        stats.stateChanges++;
+        record(GPUCommandType::SetViewport, nullptr, 0, 1);
+
+        if (!nullBackend)
+            SDL_SetGPUViewport(pass, viewport);
+    }
+
+    static void setScissor(SDL_GPURenderPass *pass, const SDL_Rect *scissor)
+    {
+        stats.stateChanges++;
+        record(GPUCommandType::SetScissor, nullptr, 0, 1);
+
+        if (!nullBackend)
+            SDL_SetGPUScissor(pass, scissor);
+    }
+
+    static void setStencilReference(SDL_GPURenderPass *pass, Uint8 reference)
+    {
+        stats.stateChanges++;
+        record(GPUCommandType::SetStencilReference, nullptr, 0, reference);
+
+        if (!nullBackend)
+            SDL_SetGPUStencilReference(pass, reference);
+    }
+
+    // Outside of any pass, counts the destination texels
+    static void blitTexture(SDL_GPUCommandBuffer *cmd, const SDL_GPUBlitInfo *info)
+    {
+        stats.blits++;
+        record(GPUCommandType::BlitTexture, info->destination.texture, 0, info->destination.w * info->destination.h);
+
+        if (!nullBackend)
+            SDL_BlitGPUTexture(cmd, info);
+    }
+
+    static SDL_GPURenderPass *beginRenderPass(SDL_GPUCommandBuffer *cmd, const SDL_GPUColorTargetInfo *colorTargets, Uint32 numColorTargets, const SDL_GPUDepthStencilTargetInfo *depthStencilTarget)
+    {
+        stats.renderPasses++;
+        // Nothing stays bound across passes, the first bind of each pass is a change
+        boundPipeline = nullptr;
+        return SDL_BeginGPURenderPass(cmd, colorTargets, numColorTargets, depthStencilTarget);
+    }
+
+    static SDL_GPUComputePass *beginComputePass(SDL_GPUCommandBuffer *cmd, const SDL_GPUStorageTextureReadWriteBinding *storageTextures, Uint32 numStorageTextures, const SDL_GPUStorageBufferReadWriteBinding *storageBuffers, Uint32 numStorageBuffers)
+    {
+        stats.computePasses++;
+        boundComputePipeline = nullptr;
+        record(GPUCommandType::BeginComputePass, numStorageTextures ? (const void *)storageTextures[0].texture : nullptr, 0, numStorageTextures + numStorageBuffers);
+
+        if (nullBackend)
+            return nullptr;
+        return SDL_BeginGPUComputePass(cmd, storageTextures, numStorageTextures, storageBuffers, numStorageBuffers);
+    }
+
+    static void endComputePass(SDL_GPUComputePass *pass)
+    {
+        if (!nullBackend)
+            SDL_EndGPUComputePass(pass);
+    }
+
+    static void bindComputePipeline(SDL_GPUComputePass *pass, SDL_GPUComputePipeline *pipeline)
+    {
+        stats.pipelineBinds++;
+        if (pipeline != boundComputePipeline)
+            stats.pipelineChanges++;
+        boundComputePipeline = pipeline;
+        record(GPUCommandType::BindComputePipeline, pipeline, 0, 1);
+
+        if (!nullBackend)
+            SDL_BindGPUComputePipeline(pass, pipeline);
+    }
+
+    static void bindComputeSamplers(SDL_GPUComputePass *pass, Uint32 firstSlot, const SDL_GPUTextureSamplerBinding *bindings, Uint32 numBindings)
+    {
+        stats.samplerBinds += numBindings;
+        record(GPUCommandType::BindComputeSamplers, bindings[0].texture, firstSlot, numBindings);
+
+        if (!nullBackend)
+            SDL_BindGPUComputeSamplers(pass, firstSlot, bindings, numBindings);
+    }
+
+    static void bindComputeStorageBuffers(SDL_GPUComputePass *pass, Uint32 firstSlot, SDL_GPUBuffer *const *buffers, Uint32 numBindings)
+    {
+        stats.storageBufferBinds += numBindings;
+        record(GPUCommandType::BindComputeStorageBuffers, buffers[0], firstSlot, numBindings);
+
+        if (!nullBackend)
+            SDL_BindGPUComputeStorageBuffers(pass, firstSlot, buffers, numBindings);
+    }
+
+    static void pushComputeUniformData(SDL_GPUCommandBuffer *cmd, Uint32 slot, const void *data, Uint32 length)
+    {
+        stats.uniformPushes++;
+        stats.uniformBytes += length;
+        record(GPUCommandType::PushComputeUniformData, nullptr, slot, length);
+
+        if (!nullBackend)
+            SDL_PushGPUComputeUniformData(cmd, slot, data, length);
+    }
+
+    static void dispatchCompute(SDL_GPUComputePass *pass, Uint32 groupCountX, Uint32 groupCountY, Uint32 groupCountZ)
+    {
+        stats.dispatches++;
+        record(GPUCommandType::DispatchCompute, nullptr, 0, groupCountX * groupCountY * groupCountZ);
+
+        if (!nullBackend)
+            SDL_DispatchGPUCompute(pass, groupCountX, groupCountY, groupCountZ);
+    }
+
+    // The group count lives on the GPU, the recording gets the byte offset
+    static void dispatchComputeIndirect(SDL_GPUComputePass *pass, SDL_GPUBuffer *buffer, Uint32 offset)
+    {
+        stats.dispatches++;
+        record(GPUCommandType::DispatchComputeIndirect, buffer, 0, offset);
+
+        if (!nullBackend)
+            SDL_DispatchGPUComputeIndirect(pass, buffer, offset);
+    }
+
+    static SDL_GPUTexture *createTexture(SDL_GPUDevice *device, const SDL_GPUTextureCreateInfo *info, GPUMemoryCategory category)
+    {
+        stats.texturesCreated++;
+        SDL_GPUTexture *texture = SDL_CreateGPUTexture(device, info);
+        memory.track(texture, category, GPUMemory::textureBytes(*info));
+        return texture;
+    }
+
+    static SDL_GPUBuffer *createBuffer(SDL_GPUDevice *device, const SDL_GPUBufferCreateInfo *info, GPUMemoryCategory category)
+    {
+        stats.buffersCreated++;
+        SDL_GPUBuffer *buffer = SDL_CreateGPUBuffer(device, info);
+        memory.track(buffer, category, info->size);
+        return buffer;
+    }
+
+    static SDL_GPUTransferBuffer *createTransferBuffer(SDL_GPUDevice *device, const SDL_GPUTransferBufferCreateInfo *info)
+    {
+        SDL_GPUTransferBuffer *buffer = SDL_CreateGPUTransferBuffer(device, info);
+        memory.track(buffer, GPUMemoryCategory::Staging, info->size);
+        return buffer;
+    }
+
+    static void releaseTexture(SDL_GPUDevice *device, SDL_GPUTexture *texture)
+    {
+        memory.untrack(texture);
+        SDL_ReleaseGPUTexture(device, texture);
+    }
+
+    static void releaseBuffer(SDL_GPUDevice *device, SDL_GPUBuffer *buffer)
+    {
+        memory.untrack(buffer);
+        SDL_ReleaseGPUBuffer(device, buffer);
+    }
+
+    static void releaseTransferBuffer(SDL_GPUDevice *device, SDL_GPUTransferBuffer *buffer)
+    {
+        memory.untrack(buffer);
+        SDL_ReleaseGPUTransferBuffer(device, buffer);
+    }
+
+    static void uploadToBuffer(SDL_GPUCopyPass *pass, const SDL_GPUTransferBufferLocation *source, const SDL_GPUBufferRegion *destination, bool cycle)
+    {
+        stats.uploadBytes += destination->size;
+        SDL_UploadToGPUBuffer(pass, source, destination, cycle);
+    }
+
+    // The region has no format, the caller passes the texture's
+    static void uploadToTexture(SDL_GPUCopyPass *pass, const SDL_GPUTextureTransferInfo *source, const SDL_GPUTextureRegion *destination, bool cycle, SDL_GPUTextureFormat format)
+    {
+        stats.uploadBytes += SDL_CalculateGPUTextureFormatSize(format, destination->w, destination->h, destination->d);
+        SDL_UploadToGPUTexture(pass, source, destination, cycle);
+    }
+
+    static void countCulling(bool visible)
+    {
+        if (visible)
+            stats.primitivesVisible++;
+        else
+            stats.primitivesCulled++;
+    }
+
+private:
+    static SDL_GPUGraphicsPipeline *boundPipeline;
+    static SDL_GPUComputePipeline *boundComputePipeline;
+
+    static void record(GPUCommandType type, const void *object, Uint32 slot, Uint32 count)
+    {
+        if (recording)
+            commands.push_back({type, object, slot, count});
+    }
+};
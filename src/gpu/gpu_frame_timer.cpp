@@ -0,0 +1,79 @@
+#include "gpu_frame_timer.h"
+
+#include <algorithm>
+
+#include <SDL3/SDL_timer.h>
+
+GPUFrameTimer::GPUFrameTimer(SDL_GPUDevice *device)
+    : m_device(device)
+{
+    m_watcher = std::thread(&GPUFrameTimer::watch, this);
+}
+
+GPUFrameTimer::~GPUFrameTimer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    m_watcher.join();
+
+    for (Frame &frame : m_frames)
+        SDL_ReleaseGPUFence(m_device, frame.fence);
+}
+
+void GPUFrameTimer::endFrame(Uint64 submitTime)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_frames.size() >= MaxFramesInFlight)
+        return;
+
+    SDL_GPUFence *fence = SDL_SubmitGPUCommandBufferAndAcquireFence(SDL_AcquireGPUCommandBuffer(m_device));
+    if (!fence)
+        return;
+
+    m_frames.push_back({fence, submitTime});
+    m_wake.notify_all();
+}
+
+float GPUFrameTimer::poll()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    while (!m_frames.empty() && m_frames.front().done)
+    {
+        const Frame &frame = m_frames.front();
+        // The GPU could not start before the frame was submitted or the previous one finished
+        Uint64 start = std::max(frame.submitTime, m_lastSignalTime);
+        m_gpuTime = frame.signalTime > start ? (frame.signalTime - start) / 1e6f : 0.f;
+        m_lastSignalTime = frame.signalTime;
+
+        SDL_ReleaseGPUFence(m_device, frame.fence);
+        m_frames.pop_front();
+        m_waited--;
+    }
+
+    return m_gpuTime;
+}
+
+void GPUFrameTimer::watch()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_wake.wait(lock, [this]() { return m_quit || m_waited < (int)m_frames.size(); });
+        if (m_quit)
+            return;
+
+        // Fences are only released by poll once done, so this one stays valid unlocked
+        SDL_GPUFence *fence = m_frames[m_waited].fence;
+        lock.unlock();
+        SDL_WaitForGPUFences(m_device, true, &fence, 1);
+        Uint64 signalTime = SDL_GetTicksNS();
+        lock.lock();
+
+        m_frames[m_waited].signalTime = signalTime;
+        m_frames[m_waited].done = true;
+        m_waited++;
+    }
+}
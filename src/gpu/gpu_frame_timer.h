@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <SDL3/SDL_gpu.h>
+
+// GPU time of whole frames without stalling the CPU. Every timed frame is followed by an
+// empty submission whose fence a watcher thread waits on, the frame ran on the GPU from
+// when it could start (its submit or the end of the previous frame) until that fence.
+// Results arrive some frames later, frames are not timed while MaxFramesInFlight are pending.
+class GPUFrameTimer
+{
+public:
+    static constexpr int MaxFramesInFlight = 4;
+
+    GPUFrameTimer(SDL_GPUDevice *device);
+    ~GPUFrameTimer();
+
+    // submitTime is taken right before the frame's command buffers were submitted
+    void endFrame(Uint64 submitTime);
+    // Releases finished fences, returns the latest finished frame's GPU time in ms or 0
+    float poll();
+
+private:
+    struct Frame
+    {
+        SDL_GPUFence *fence;
+        Uint64 submitTime;
+        Uint64 signalTime = 0;
+        bool done = false;
+    };
+
+    SDL_GPUDevice *m_device;
+    std::thread m_watcher;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::deque<Frame> m_frames; // submission order
+    int m_waited = 0;           // frames the watcher saw signal, from the front
+    Uint64 m_lastSignalTime = 0;
+    float m_gpuTime = 0.f;
+    bool m_quit = false;
+
+    void watch();
+};
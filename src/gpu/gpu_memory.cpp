@@ -0,0 +1,83 @@
+#include "gpu_memory.h"
+
+#include <algorithm>
+
+#include <SDL3/SDL_log.h>
+
+const char *getCategoryName(GPUMemoryCategory category)
+{
+    switch (category)
+    {
+    case GPUMemoryCategory::Mesh:
+        return "Mesh";
+    case GPUMemoryCategory::MaterialTexture:
+        return "Material Texture";
+    case GPUMemoryCategory::RenderTarget:
+        return "Render Target";
+    case GPUMemoryCategory::IBL:
+        return "IBL";
+    case GPUMemoryCategory::Shadow:
+        return "Shadow";
+    case GPUMemoryCategory::Staging:
+        return "Staging";
+    case GPUMemoryCategory::Other:
+    case GPUMemoryCategory::Count:
+        break;
+    }
+    return "Other";
+}
+
+void GPUMemory::track(const void *object, GPUMemoryCategory category, Uint64 bytes)
+{
+    if (!object)
+        return;
+
+    bool wasOverBudget = overBudget();
+
+    int c = (int)category;
+    m_allocations[object] = {category, bytes};
+    m_bytes[c] += bytes;
+    m_counts[c]++;
+    m_peaks[c] = std::max(m_peaks[c], m_bytes[c]);
+    m_total += bytes;
+    m_peak = std::max(m_peak, m_total);
+
+    // Once per crossing, not for every allocation while over
+    if (!wasOverBudget && overBudget())
+    {
+        SDL_Log("GPU memory over budget: %.1f / %.1f MB after a %.1f MB %s allocation",
+                m_total / (1024.f * 1024.f), m_budget / (1024.f * 1024.f), bytes / (1024.f * 1024.f), getCategoryName(category));
+        for (auto &callback : m_overBudgetCallbacks)
+            callback(m_total, m_budget);
+    }
+}
+
+void GPUMemory::untrack(const void *object)
+{
+    auto it = m_allocations.find(object);
+    if (it == m_allocations.end())
+        return;
+
+    int c = (int)it->second.category;
+    m_bytes[c] -= it->second.bytes;
+    m_counts[c]--;
+    m_total -= it->second.bytes;
+    m_allocations.erase(it);
+}
+
+Uint64 GPUMemory::textureBytes(const SDL_GPUTextureCreateInfo &info)
+{
+    bool volume = info.type == SDL_GPU_TEXTURETYPE_3D;
+
+    Uint64 bytes = 0;
+    for (Uint32 level = 0; level < std::max(info.num_levels, 1u); level++)
+    {
+        Uint32 width = std::max(info.width >> level, 1u);
+        Uint32 height = std::max(info.height >> level, 1u);
+        Uint32 depth = volume ? std::max(info.layer_count_or_depth >> level, 1u) : info.layer_count_or_depth;
+        bytes += SDL_CalculateGPUTextureFormatSize(info.format, width, height, depth);
+    }
+
+    // SDL_GPU_SAMPLECOUNT_1 is 0, each step doubles
+    return bytes << (int)info.sample_count;
+}
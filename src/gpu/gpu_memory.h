@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <SDL3/SDL_gpu.h>
+
+enum class GPUMemoryCategory
+{
+    Mesh,
+    MaterialTexture,
+    RenderTarget, // sized by the screen or a pass
+    IBL,
+    Shadow,
+    Staging, // transfer buffers
+    Other,
+    Count
+};
+
+const char *getCategoryName(GPUMemoryCategory category);
+
+// Estimated bytes of every allocation made through GPU::, per category with high-water marks.
+// Sizes come from the create infos, the driver's padding and alignment are not known.
+class GPUMemory
+{
+public:
+    static constexpr int CategoryCount = (int)GPUMemoryCategory::Count;
+
+    Uint64 m_budget = 0; // 0 is unlimited
+    Uint64 m_total = 0;
+    Uint64 m_peak = 0;
+    Uint64 m_bytes[CategoryCount] = {};
+    Uint64 m_peaks[CategoryCount] = {};
+    Uint32 m_counts[CategoryCount] = {};
+
+    // Called when an allocation takes the total over the budget, e.g. to evict caches
+    std::vector<std::function<void(Uint64 total, Uint64 budget)>> m_overBudgetCallbacks;
+
+    void track(const void *object, GPUMemoryCategory category, Uint64 bytes);
+    void untrack(const void *object);
+    bool overBudget() const { return m_budget > 0 && m_total > m_budget; }
+
+    static Uint64 textureBytes(const SDL_GPUTextureCreateInfo &info);
+
+private:
+    struct Allocation
+    {
+        GPUMemoryCategory category;
+        Uint64 bytes;
+    };
+    std::unordered_map<const void *, Allocation> m_allocations;
+};
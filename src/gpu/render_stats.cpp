@@ -0,0 +1,135 @@
+#include "render_stats.h"
+
+#include <algorithm>
+
+#include "gpu.h"
+
+void CounterHistory::push(float value)
+{
+    m_values[m_head] = value;
+    m_head = (m_head + 1) % Size;
+    m_count = std::min(m_count + 1, Size);
+}
+
+float CounterHistory::last() const
+{
+    if (m_count == 0)
+        return 0.f;
+    return m_values[(m_head + Size - 1) % Size];
+}
+
+// Until the ring is full the valid values are the first m_count
+float CounterHistory::min() const
+{
+    if (m_count == 0)
+        return 0.f;
+    return *std::min_element(m_values, m_values + m_count);
+}
+
+float CounterHistory::avg() const
+{
+    if (m_count == 0)
+        return 0.f;
+
+    double sum = 0.0;
+    for (int i = 0; i < m_count; i++)
+        sum += m_values[i];
+    return (float)(sum / m_count);
+}
+
+float CounterHistory::max() const
+{
+    if (m_count == 0)
+        return 0.f;
+    return *std::max_element(m_values, m_values + m_count);
+}
+
+// Filled from GPUStats in endFrame, in this order
+static const char *const gpuCounterNames[] = {
+    "Draw Calls",
+    "Triangles",
+    "Primitives Visible",
+    "Primitives Culled",
+    "Pipeline Binds",
+    "Pipeline Changes",
+    "Sampler Binds",
+    "Uniform Bytes",
+    "State Changes",
+    "Render Passes",
+    "Compute Passes",
+    "Dispatches",
+    "Blits",
+    "Upload Bytes",
+    "Textures Created",
+    "Buffers Created",
+    "GPU Memory MB"};
+
+RenderStats::RenderStats()
+{
+    for (const char *name : gpuCounterNames)
+        registerCounter(name);
+    m_gpuCounters = (int)m_counters.size();
+}
+
+int RenderStats::registerCounter(const std::string &name)
+{
+    auto it = m_ids.find(name);
+    if (it != m_ids.end())
+        return it->second;
+
+    int id = (int)m_counters.size();
+    Counter counter;
+    counter.name = name;
+    if (!m_counters.empty())
+    {
+        counter.history.m_head = m_counters[0].history.m_head;
+        counter.history.m_count = m_counters[0].history.m_count;
+    }
+
+    m_counters.push_back(counter);
+    m_frame.push_back(0.f);
+    m_ids[name] = id;
+    return id;
+}
+
+void RenderStats::endFrame()
+{
+    const GPUStats &stats = GPU::stats;
+    const float gpuValues[] = {
+        (float)stats.drawCalls,
+        (float)stats.triangles,
+        (float)stats.primitivesVisible,
+        (float)stats.primitivesCulled,
+        (float)stats.pipelineBinds,
+        (float)stats.pipelineChanges,
+        (float)stats.samplerBinds,
+        (float)stats.uniformBytes,
+        (float)stats.stateChanges,
+        (float)stats.renderPasses,
+        (float)stats.computePasses,
+        (float)stats.dispatches,
+        (float)stats.blits,
+        (float)stats.uploadBytes,
+        (float)stats.texturesCreated,
+        (float)stats.buffersCreated,
+        GPU::memory.m_total / (1024.f * 1024.f)};
+    static_assert(sizeof(gpuValues) / sizeof(gpuValues[0]) == sizeof(gpuCounterNames) / sizeof(gpuCounterNames[0]),
+                  "one value per GPU counter name");
+
+    for (int i = 0; i < m_gpuCounters; i++)
+        m_frame[i] += gpuValues[i];
+
+    if (!m_paused)
+    {
+        for (size_t i = 0; i < m_counters.size(); i++)
+            m_counters[i].history.push(m_frame[i]);
+    }
+
+    std::fill(m_frame.begin(), m_frame.end(), 0.f);
+}
+
+const CounterHistory *RenderStats::get(const std::string &name) const
+{
+    auto it = m_ids.find(name);
+    return it != m_ids.end() ? &m_counters[it->second].history : nullptr;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+// Last Size frames of one counter
+struct CounterHistory
+{
+    static constexpr int Size = 240;
+
+    float m_values[Size] = {};
+    int m_head = 0; // next write
+    int m_count = 0;
+
+    void push(float value);
+    float last() const;
+    float min() const;
+    float avg() const;
+    float max() const;
+};
+
+// Per-frame renderer counters: the GPU stats of the frame plus named counters
+// (per render graph pass), each kept in a ring buffer. Counters are registered once
+// and then added to by id, every known counter advances every frame. Main thread only.
+class RenderStats
+{
+public:
+    static RenderStats &getInstance()
+    {
+        static RenderStats instance;
+        return instance;
+    }
+
+    RenderStats(const RenderStats &) = delete;
+    RenderStats &operator=(const RenderStats &) = delete;
+
+    struct Counter
+    {
+        std::string name;
+        CounterHistory history;
+    };
+
+    bool m_paused = false;
+    std::vector<Counter> m_counters; // by id, in registration order
+    std::vector<float> m_frame;      // being collected, by id
+
+    // Returns the id of the counter, creating it on first use. Frames before
+    // its creation count as zero so its history covers the same frames as the others
+    int registerCounter(const std::string &name);
+
+    // Accumulates into the current frame
+    void add(int id, float value) { m_frame[id] += value; }
+    // Pushes the frame into the histories, counters not added to this frame get a zero
+    void endFrame();
+
+    const CounterHistory *get(const std::string &name) const;
+
+private:
+    RenderStats();
+
+    std::map<std::string, int> m_ids;
+    int m_gpuCounters = 0; // the first ids, filled from GPUStats in endFrame
+};
@@ -0,0 +1,94 @@
+#include "job_system.h"
+
+JobSystem::JobSystem()
+{
+    int threadCount = (int)std::thread::hardware_concurrency() - 1;
+    for (int i = 0; i < threadCount; i++)
+        m_workers.emplace_back(&JobSystem::workerLoop, this);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread &worker : m_workers)
+        worker.join();
+}
+
+void JobSystem::parallelFor(int count, const std::function<void(int)> &job)
+{
+    if (count <= 0)
+        return;
+
+    if (m_workers.empty() || count == 1)
+    {
+        for (int i = 0; i < count; i++)
+            job(i);
+        return;
+    }
+
+    {
+        // A worker that woke late for the previous dispatch may still be leaving runJobs
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_active == 0; });
+
+        m_job = &job;
+        m_count = count;
+        m_remaining = count;
+        m_next = 0;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    runJobs();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() { return m_remaining == 0; });
+    m_job = nullptr;
+}
+
+void JobSystem::workerLoop()
+{
+    Uint64 generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]() { return m_quit || m_generation != generation; });
+            if (m_quit)
+                return;
+            generation = m_generation;
+            m_active++;
+        }
+
+        runJobs();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_active--;
+        }
+        m_done.notify_all();
+    }
+}
+
+void JobSystem::runJobs()
+{
+    while (true)
+    {
+        int index = m_next.fetch_add(1);
+        if (index >= m_count)
+            return;
+
+        (*m_job)(index);
+
+        if (m_remaining.fetch_sub(1) == 1)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done.notify_all();
+        }
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+// Worker threads for data parallel frame work, one hardware thread is left to the
+// main thread which runs jobs too while it waits. parallelFor is called from the main thread only.
+class JobSystem
+{
+public:
+    static JobSystem &getInstance()
+    {
+        static JobSystem instance;
+        return instance;
+    }
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    int getWorkerCount() const { return (int)m_workers.size(); }
+
+    // Runs job(i) for every i in [0, count) and returns once all of them finished
+    void parallelFor(int count, const std::function<void(int)> &job);
+
+private:
+    JobSystem();
+    ~JobSystem();
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    bool m_quit = false;
+
+    // Current dispatch, only changed while no worker is running it
+    const std::function<void(int)> *m_job = nullptr;
+    int m_count = 0;
+    Uint64 m_generation = 0;
+    int m_active = 0; // workers inside runJobs
+    std::atomic<int> m_next{0};
+    std::atomic<int> m_remaining{0};
+
+    void workerLoop();
+    void runJobs();
+};
@@ -0,0 +1,379 @@
+#include "light_manager.h"
+
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+
+#include <imgui.h>
+
+#include "../gpu/gpu.h"
+#include "../utils/utils.h"
+
+LightManager::LightManager()
+{
+    SDL_GPUBufferCreateInfo bufferInfo{};
+    bufferInfo.usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ;
+
+    bufferInfo.size = sizeof(LocalLight) * MAX_LOCAL_LIGHTS;
+    m_lightBuffer = GPU::createBuffer(Utils::device, &bufferInfo, GPUMemoryCategory::Other);
+    if (!m_lightBuffer)
+    {
+        SDL_Log("Failed to create light buffer: %s", SDL_GetError());
+    }
+
+    bufferInfo.size = sizeof(glm::uvec2) * NUM_CLUSTERS;
+    m_clusterBuffer = GPU::createBuffer(Utils::device, &bufferInfo, GPUMemoryCategory::Other);
+    if (!m_clusterBuffer)
+    {
+        SDL_Log("Failed to create cluster buffer: %s", SDL_GetError());
+    }
+
+    bufferInfo.size = sizeof(Uint32) * MAX_LIGHT_INDICES;
+    m_lightIndexBuffer = GPU::createBuffer(Utils::device, &bufferInfo, GPUMemoryCategory::Other);
+    if (!m_lightIndexBuffer)
+    {
+        SDL_Log("Failed to create light index buffer: %s", SDL_GetError());
+    }
+
+    SDL_GPUTransferBufferCreateInfo transferInfo{};
+    transferInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+    transferInfo.size = sizeof(LocalLight) * MAX_LOCAL_LIGHTS + sizeof(glm::uvec2) * NUM_CLUSTERS + sizeof(Uint32) * MAX_LIGHT_INDICES;
+    m_transferBuffer = GPU::createTransferBuffer(Utils::device, &transferInfo);
+    if (!m_transferBuffer)
+    {
+        SDL_Log("Failed to create light transfer buffer: %s", SDL_GetError());
+    }
+
+    m_clusterLights.resize(NUM_CLUSTERS);
+    m_clusterRanges.resize(NUM_CLUSTERS);
+    m_lightIndices.reserve(MAX_LIGHT_INDICES);
+
+    m_clusterUniforms.grid = glm::uvec4(CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, 0);
+}
+
+LightManager::~LightManager()
+{
+    if (m_lightBuffer)
+        GPU::releaseBuffer(Utils::device, m_lightBuffer);
+    if (m_clusterBuffer)
+        GPU::releaseBuffer(Utils::device, m_clusterBuffer);
+    if (m_lightIndexBuffer)
+        GPU::releaseBuffer(Utils::device, m_lightIndexBuffer);
+    if (m_transferBuffer)
+        GPU::releaseTransferBuffer(Utils::device, m_transferBuffer);
+}
+
+void LightManager::renderUI()
+{
+    if (!ImGui::CollapsingHeader("Light Manager"))
+        return;
+
+    ImGui::PushID(this);
+
+    ImGui::Checkbox("Enabled", &m_enabled);
+    ImGui::Text("Lights: %d (visible: %d)", (int)m_lights.size(), m_visibleLights);
+    ImGui::Text("Light Indices: %d / %d", (int)m_lightIndices.size(), MAX_LIGHT_INDICES);
+    ImGui::Text("Max Lights Per Cluster: %d", m_maxLightsPerCluster);
+
+    static float scatterRadius = 20.f;
+    ImGui::DragFloat("Scatter Radius", &scatterRadius, 0.1f, 0.f, 500.f);
+    if (ImGui::Button("Add 32 Random Lights"))
+    {
+        for (int i = 0; i < 32; ++i)
+        {
+            glm::vec3 position(SDL_randf() * 2.f - 1.f, SDL_randf() * 0.2f, SDL_randf() * 2.f - 1.f);
+            glm::vec3 color(SDL_randf(), SDL_randf(), SDL_randf());
+            addPointLight(position * scatterRadius, glm::normalize(color + 0.1f), 4.f, 3.f + SDL_randf() * 4.f);
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Clear"))
+        m_lights.clear();
+
+    if (ImGui::TreeNode("Lights"))
+    {
+        for (size_t i = 0; i < m_lights.size(); ++i)
+        {
+            LocalLight &light = m_lights[i];
+
+            ImGui::PushID((int)i);
+            if (ImGui::TreeNode("Light", "%s %d", light.type == LocalLight_Spot ? "Spot" : "Point", (int)i))
+            {
+                ImGui::DragFloat3("Position", &light.position.x, 0.1f);
+                ImGui::ColorEdit3("Color", &light.color.x);
+                ImGui::DragFloat("Intensity", &light.intensity, 0.1f, 0.f, 1000.f);
+                ImGui::DragFloat("Range", &light.range, 0.1f, 0.01f, 1000.f);
+                if (light.type == LocalLight_Spot)
+                {
+                    if (ImGui::DragFloat3("Direction", &light.direction.x, 0.01f))
+                        light.direction = glm::normalize(light.direction);
+                    ImGui::DragFloat("Inner Cone Cos", &light.innerConeCos, 0.001f, light.outerConeCos, 1.f);
+                    ImGui::DragFloat("Outer Cone Cos", &light.outerConeCos, 0.001f, 0.f, light.innerConeCos);
+                }
+
+                ImGui::TreePop();
+            }
+            ImGui::PopID();
+        }
+
+        ImGui::TreePop();
+    }
+
+    ImGui::PopID();
+}
+
+LocalLight &LightManager::addPointLight(const glm::vec3 &position, const glm::vec3 &color, float intensity, float range)
+{
+    LocalLight light{};
+    light.position = position;
+    light.color = color;
+    light.intensity = intensity;
+    light.range = range;
+    light.type = LocalLight_Point;
+
+    m_lights.push_back(light);
+    return m_lights.back();
+}
+
+LocalLight &LightManager::addSpotLight(
+    const glm::vec3 &position,
+    const glm::vec3 &direction,
+    const glm::vec3 &color,
+    float intensity,
+    float range,
+    float innerAngle,
+    float outerAngle)
+{
+    LocalLight light{};
+    light.position = position;
+    light.direction = glm::normalize(direction);
+    light.color = color;
+    light.intensity = intensity;
+    light.range = range;
+    light.innerConeCos = std::cos(glm::radians(innerAngle));
+    light.outerConeCos = std::cos(glm::radians(outerAngle));
+    light.type = LocalLight_Spot;
+
+    m_lights.push_back(light);
+    return m_lights.back();
+}
+
+void LightManager::updateClusterBounds(const glm::mat4 &projection, float nearClip, float farClip)
+{
+    m_clusterProjection = projection;
+    m_clusterDepthRange = glm::vec2(nearClip, farClip);
+
+    m_clusterMin.resize(NUM_CLUSTERS);
+    m_clusterMax.resize(NUM_CLUSTERS);
+
+    const float ratio = farClip / nearClip;
+
+    for (int z = 0; z < CLUSTER_GRID_Z; ++z)
+    {
+        // Exponential slices, must match the slice scale/bias in ClusterUniforms
+        float sliceNear = nearClip * std::pow(ratio, z / (float)CLUSTER_GRID_Z);
+        float sliceFar = nearClip * std::pow(ratio, (z + 1) / (float)CLUSTER_GRID_Z);
+
+        for (int y = 0; y < CLUSTER_GRID_Y; ++y)
+        {
+            // Tile rows go top to bottom like gl_FragCoord
+            float ndcTop = 1.f - 2.f * y / (float)CLUSTER_GRID_Y;
+            float ndcBottom = 1.f - 2.f * (y + 1) / (float)CLUSTER_GRID_Y;
+
+            for (int x = 0; x < CLUSTER_GRID_X; ++x)
+            {
+                float ndcLeft = 2.f * x / (float)CLUSTER_GRID_X - 1.f;
+                float ndcRight = 2.f * (x + 1) / (float)CLUSTER_GRID_X - 1.f;
+
+                glm::vec3 minVS(std::numeric_limits<float>::max());
+                glm::vec3 maxVS(std::numeric_limits<float>::lowest());
+
+                for (float depth : {sliceNear, sliceFar})
+                {
+                    for (float ndcX : {ndcLeft, ndcRight})
+                    {
+                        for (float ndcY : {ndcTop, ndcBottom})
+                        {
+                            // Inverse of the perspective divide at a known view depth
+                            glm::vec3 p(
+                                depth * (ndcX + projection[2][0]) / projection[0][0],
+                                depth * (ndcY + projection[2][1]) / projection[1][1],
+                                -depth);
+                            minVS = glm::min(minVS, p);
+                            maxVS = glm::max(maxVS, p);
+                        }
+                    }
+                }
+
+                int index = x + CLUSTER_GRID_X * (y + CLUSTER_GRID_Y * z);
+                m_clusterMin[index] = minVS;
+                m_clusterMax[index] = maxVS;
+            }
+        }
+    }
+}
+
+void LightManager::update(
+    SDL_GPUCommandBuffer *cmd,
+    const glm::mat4 &view,
+    const glm::mat4 &projection,
+    float nearClip,
+    float farClip,
+    glm::ivec2 screenSize)
+{
+    m_visibleLights = 0;
+    m_maxLightsPerCluster = 0;
+    m_clusterUniforms.grid.w = 0;
+
+    if (!m_enabled || m_lights.empty() || !m_transferBuffer)
+        return;
+
+    if (projection != m_clusterProjection || glm::vec2(nearClip, farClip) != m_clusterDepthRange)
+        updateClusterBounds(projection, nearClip, farClip);
+
+    const float logRatio = std::log(farClip / nearClip);
+    const float sliceScale = CLUSTER_GRID_Z / logRatio;
+    const float sliceBias = -CLUSTER_GRID_Z * std::log(nearClip) / logRatio;
+
+    auto sliceOf = [&](float depth) {
+        int slice = (int)std::floor(std::log(depth) * sliceScale + sliceBias);
+        return glm::clamp(slice, 0, CLUSTER_GRID_Z - 1);
+    };
+
+    for (std::vector<Uint32> &lights : m_clusterLights)
+        lights.clear();
+
+    const int lightCount = glm::min((int)m_lights.size(), MAX_LOCAL_LIGHTS);
+
+    // 1. Bin every light into the clusters its bounding sphere touches
+    for (int i = 0; i < lightCount; ++i)
+    {
+        const LocalLight &light = m_lights[i];
+        const glm::vec3 center = glm::vec3(view * glm::vec4(light.position, 1.f));
+        const float radius = light.range;
+        const float depth = -center.z;
+
+        if (light.intensity <= 0.f || depth + radius < nearClip || depth - radius > farClip)
+            continue;
+
+        int sliceMin = sliceOf(glm::max(depth - radius, nearClip));
+        int sliceMax = sliceOf(glm::min(depth + radius, farClip));
+
+        glm::ivec2 tileMin(0);
+        glm::ivec2 tileMax(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1);
+
+        // Spheres crossing the near plane cover the whole screen
+        if (depth - radius > nearClip)
+        {
+            glm::vec2 ndcMin(std::numeric_limits<float>::max());
+            glm::vec2 ndcMax(std::numeric_limits<float>::lowest());
+            for (int j = 0; j < 8; ++j)
+            {
+                glm::vec3 corner = center + glm::vec3(
+                                                (j & 1) ? radius : -radius,
+                                                (j & 2) ? radius : -radius,
+                                                (j & 4) ? radius : -radius);
+                glm::vec4 clip = projection * glm::vec4(corner, 1.f);
+                glm::vec2 ndc = glm::vec2(clip) / clip.w;
+                ndcMin = glm::min(ndcMin, ndc);
+                ndcMax = glm::max(ndcMax, ndc);
+            }
+
+            if (ndcMax.x < -1.f || ndcMin.x > 1.f || ndcMax.y < -1.f || ndcMin.y > 1.f)
+                continue;
+
+            tileMin.x = (int)std::floor((ndcMin.x * 0.5f + 0.5f) * CLUSTER_GRID_X);
+            tileMax.x = (int)std::floor((ndcMax.x * 0.5f + 0.5f) * CLUSTER_GRID_X);
+            tileMin.y = (int)std::floor((0.5f - ndcMax.y * 0.5f) * CLUSTER_GRID_Y);
+            tileMax.y = (int)std::floor((0.5f - ndcMin.y * 0.5f) * CLUSTER_GRID_Y);
+            tileMin = glm::clamp(tileMin, glm::ivec2(0), glm::ivec2(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1));
+            tileMax = glm::clamp(tileMax, glm::ivec2(0), glm::ivec2(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1));
+        }
+
+        bool visible = false;
+        for (int z = sliceMin; z <= sliceMax; ++z)
+        {
+            for (int y = tileMin.y; y <= tileMax.y; ++y)
+            {
+                for (int x = tileMin.x; x <= tileMax.x; ++x)
+                {
+                    int index = x + CLUSTER_GRID_X * (y + CLUSTER_GRID_Y * z);
+
+                    // Sphere vs. cluster AABB
+                    glm::vec3 closest = glm::clamp(center, m_clusterMin[index], m_clusterMax[index]);
+                    glm::vec3 delta = closest - center;
+                    if (glm::dot(delta, delta) > radius * radius)
+                        continue;
+
+                    m_clusterLights[index].push_back((Uint32)i);
+                    visible = true;
+                }
+            }
+        }
+
+        if (visible)
+            m_visibleLights++;
+    }
+
+    // 2. Flatten the per-cluster lists
+    m_lightIndices.clear();
+    for (int i = 0; i < NUM_CLUSTERS; ++i)
+    {
+        const std::vector<Uint32> &lights = m_clusterLights[i];
+        Uint32 count = (Uint32)glm::min(lights.size(), (size_t)(MAX_LIGHT_INDICES - m_lightIndices.size()));
+
+        m_clusterRanges[i] = glm::uvec2((Uint32)m_lightIndices.size(), count);
+        m_lightIndices.insert(m_lightIndices.end(), lights.begin(), lights.begin() + count);
+        m_maxLightsPerCluster = glm::max(m_maxLightsPerCluster, (int)count);
+    }
+
+    // 3. Upload
+    const Uint32 lightsSize = sizeof(LocalLight) * lightCount;
+    const Uint32 clustersSize = sizeof(glm::uvec2) * NUM_CLUSTERS;
+    const Uint32 indicesSize = sizeof(Uint32) * (Uint32)m_lightIndices.size();
+    const Uint32 clustersOffset = sizeof(LocalLight) * MAX_LOCAL_LIGHTS;
+    const Uint32 indicesOffset = clustersOffset + clustersSize;
+
+    Uint8 *data = (Uint8 *)SDL_MapGPUTransferBuffer(Utils::device, m_transferBuffer, true);
+    if (!data)
+    {
+        SDL_Log("Failed to map light transfer buffer: %s", SDL_GetError());
+        return;
+    }
+
+    std::memcpy(data, m_lights.data(), lightsSize);
+    std::memcpy(data + clustersOffset, m_clusterRanges.data(), clustersSize);
+    if (indicesSize > 0)
+        std::memcpy(data + indicesOffset, m_lightIndices.data(), indicesSize);
+    SDL_UnmapGPUTransferBuffer(Utils::device, m_transferBuffer);
+
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmd);
+
+    SDL_GPUTransferBufferLocation source{m_transferBuffer, 0};
+    SDL_GPUBufferRegion region{m_lightBuffer, 0, lightsSize};
+    GPU::uploadToBuffer(copyPass, &source, &region, true);
+
+    source.offset = clustersOffset;
+    region = {m_clusterBuffer, 0, clustersSize};
+    GPU::uploadToBuffer(copyPass, &source, &region, true);
+
+    if (indicesSize > 0)
+    {
+        source.offset = indicesOffset;
+        region = {m_lightIndexBuffer, 0, indicesSize};
+        GPU::uploadToBuffer(copyPass, &source, &region, true);
+    }
+
+    SDL_EndGPUCopyPass(copyPass);
+
+    glm::vec2 tileSize = glm::vec2(screenSize) / glm::vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y);
+    m_clusterUniforms.grid.w = (Uint32)lightCount;
+    m_clusterUniforms.params = glm::vec4(tileSize, sliceScale, sliceBias);
+}
+
+void LightManager::bindBuffers(SDL_GPURenderPass *pass)
+{
+    SDL_GPUBuffer *buffers[3] = {m_lightBuffer, m_clusterBuffer, m_lightIndexBuffer};
+    GPU::bindFragmentStorageBuffers(pass, 0, buffers, 3);
+}
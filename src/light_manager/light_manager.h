@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <SDL3/SDL_gpu.h>
+
+#include "../ui/base_ui.h"
+
+const int CLUSTER_GRID_X = 16;
+const int CLUSTER_GRID_Y = 9;
+const int CLUSTER_GRID_Z = 24;
+const int NUM_CLUSTERS = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+
+const int MAX_LOCAL_LIGHTS = 1024;
+const int MAX_LIGHT_INDICES = NUM_CLUSTERS * 32;
+
+enum LocalLightType
+{
+    LocalLight_Point = 0,
+    LocalLight_Spot = 1,
+};
+
+// std430 layout, matches LocalLight in pbr.frag
+struct LocalLight
+{
+    glm::vec3 position{0.f};
+    float range = 5.f;
+    glm::vec3 color{1.f};
+    float intensity = 1.f;
+    glm::vec3 direction{0.f, -1.f, 0.f}; // spot only
+    float innerConeCos = 0.9f;
+    float outerConeCos = 0.8f;
+    Uint32 type = LocalLight_Point;
+    glm::vec2 padding;
+};
+
+struct ClusterUniforms
+{
+    glm::uvec4 grid;   // cluster count x, y, z, local light count
+    glm::vec4 params;  // tile size in pixels (xy), depth slice scale, depth slice bias
+};
+
+class LightManager : public BaseUI
+{
+public:
+    LightManager();
+    ~LightManager();
+
+    std::vector<LocalLight> m_lights;
+    bool m_enabled = true;
+
+    // Filled by update, copied into FragmentUniforms
+    ClusterUniforms m_clusterUniforms{};
+
+    // GPU objects
+    SDL_GPUBuffer *m_lightBuffer = nullptr;
+    SDL_GPUBuffer *m_clusterBuffer = nullptr;    // uvec2(offset, count) per cluster
+    SDL_GPUBuffer *m_lightIndexBuffer = nullptr; // flattened per-cluster light lists
+    SDL_GPUTransferBuffer *m_transferBuffer = nullptr;
+
+    // View-space cluster bounds, rebuilt when the projection changes
+    std::vector<glm::vec3> m_clusterMin;
+    std::vector<glm::vec3> m_clusterMax;
+    glm::mat4 m_clusterProjection{0.f};
+    glm::vec2 m_clusterDepthRange{0.f};
+
+    // Binning scratch
+    std::vector<std::vector<Uint32>> m_clusterLights;
+    std::vector<glm::uvec2> m_clusterRanges;
+    std::vector<Uint32> m_lightIndices;
+
+    // Stats
+    int m_visibleLights = 0;
+    int m_maxLightsPerCluster = 0;
+
+    void renderUI() override;
+    LocalLight &addPointLight(const glm::vec3 &position, const glm::vec3 &color, float intensity, float range);
+    LocalLight &addSpotLight(
+        const glm::vec3 &position,
+        const glm::vec3 &direction,
+        const glm::vec3 &color,
+        float intensity,
+        float range,
+        float innerAngle,
+        float outerAngle);
+    void updateClusterBounds(const glm::mat4 &projection, float nearClip, float farClip);
+    void update(
+        SDL_GPUCommandBuffer *cmd,
+        const glm::mat4 &view,
+        const glm::mat4 &projection,
+        float nearClip,
+        float farClip,
+        glm::ivec2 screenSize);
+    void bindBuffers(SDL_GPURenderPass *pass);
+};
@@ -5,25 +5,65 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <imgui.h>
 
+#include "../gpu/gpu.h"
 #include "../resource_manager/dds_loader.h"
 #include "../utils/utils.h"
 
+// Group counts of the bloom downsample for a render region, 32x32 mip 1 texels per group.
+// Mip 1 of an odd region can reach past 4 times mip 3, so it decides
+static glm::ivec2 getBloomGroups(glm::ivec2 size)
+{
+    return (glm::max(size >> 1, glm::ivec2(1)) + 31) / 32;
+}
+
+// Counters the shaders reset themselves only need a zero to start from
+static void clearBuffer(SDL_GPUCommandBuffer *commandBuffer, SDL_GPUBuffer *buffer, Uint32 size)
+{
+    SDL_GPUTransferBufferCreateInfo transferInfo{};
+    transferInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+    transferInfo.size = size;
+
+    SDL_GPUTransferBuffer *transferBuffer = GPU::createTransferBuffer(Utils::device, &transferInfo);
+    void *mapData = SDL_MapGPUTransferBuffer(Utils::device, transferBuffer, false);
+    if (mapData)
+    {
+        std::memset(mapData, 0, transferInfo.size);
+        SDL_UnmapGPUTransferBuffer(Utils::device, transferBuffer);
+    }
+
+    SDL_GPUTransferBufferLocation source{transferBuffer, 0};
+    SDL_GPUBufferRegion destination{buffer, 0, transferInfo.size};
+
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+    GPU::uploadToBuffer(copyPass, &source, &destination, false);
+    SDL_EndGPUCopyPass(copyPass);
+
+    GPU::releaseTransferBuffer(Utils::device, transferBuffer);
+}
+
+static float halton(int index, int base)
+{
+    float result = 0.f;
+    float f = 1.f;
+    while (index > 0)
+    {
+        f /= (float)base;
+        result += f * (float)(index % base);
+        index /= base;
+    }
+    return result;
+}
+
 PostProcess::PostProcess(SDL_GPUSampleCount sampleCount)
 {
-    m_fullscreenVert = Utils::loadShader("src/shaders/fullscreen.vert", 0, 0, SDL_GPU_SHADERSTAGE_VERTEX);
+    m_fullscreenVert = Utils::loadShader("src/shaders/fullscreen.vert", 0, 1, SDL_GPU_SHADERSTAGE_VERTEX);
     m_postProcessFrag = Utils::loadShader("src/shaders/post.frag", 4, 1, SDL_GPU_SHADERSTAGE_FRAGMENT);
-    m_bloomDownFrag = Utils::loadShader("src/shaders/downsample.frag", 1, 1, SDL_GPU_SHADERSTAGE_FRAGMENT);
-    m_bloomUpFrag = Utils::loadShader("src/shaders/upsample.frag", 1, 1, SDL_GPU_SHADERSTAGE_FRAGMENT);
-
-    // Load GTAO Shaders (replaces SSAO)
-    m_gtaoGenFrag = Utils::loadShader("src/shaders/gtao.frag", 2, 1, SDL_GPU_SHADERSTAGE_FRAGMENT);
-    m_gtaoBlurFrag = Utils::loadShader("src/shaders/bilateral_blur.frag", 1, 1, SDL_GPU_SHADERSTAGE_FRAGMENT);
     m_depthCopyFrag = Utils::loadShader("src/shaders/depth_copy.frag", 1, 0, SDL_GPU_SHADERSTAGE_FRAGMENT);
     m_depthResolveFrag = Utils::loadShader("src/shaders/depth_resolve.frag", 1, 0, SDL_GPU_SHADERSTAGE_FRAGMENT);
 
     SDL_GPUColorTargetDescription colorTargetDesc[1];
     colorTargetDesc[0] = {};
-    colorTargetDesc[0].format = SDL_GetGPUSwapchainTextureFormat(Utils::device, Utils::window);
+    colorTargetDesc[0].format = Utils::getPresentFormat();
 
     SDL_GPUGraphicsPipelineCreateInfo pp{};
     pp.vertex_shader = m_fullscreenVert;
@@ -33,10 +73,23 @@ PostProcess::PostProcess(SDL_GPUSampleCount sampleCount)
     pp.target_info.color_target_descriptions = colorTargetDesc;
     m_postProcessPipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &pp);
 
+    // Edge pixels are marked in stencil so the blend weight pass only runs on them
+    m_smaaStencilFormat = SDL_GPU_TEXTUREFORMAT_D24_UNORM_S8_UINT;
+    if (!SDL_GPUTextureSupportsFormat(
+            Utils::device, m_smaaStencilFormat, SDL_GPU_TEXTURETYPE_2D, SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET))
+        m_smaaStencilFormat = SDL_GPU_TEXTUREFORMAT_D32_FLOAT_S8_UINT;
+
     // --- SMAA Edge Pass ---
     SDL_GPUColorTargetDescription smaaEdgeDesc{};
     smaaEdgeDesc.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
 
+    // SMAA discards non edge pixels, everything that survives writes 1
+    SDL_GPUStencilOpState markEdges{};
+    markEdges.compare_op = SDL_GPU_COMPAREOP_ALWAYS;
+    markEdges.pass_op = SDL_GPU_STENCILOP_REPLACE;
+    markEdges.fail_op = SDL_GPU_STENCILOP_KEEP;
+    markEdges.depth_fail_op = SDL_GPU_STENCILOP_KEEP;
+
     SDL_GPUGraphicsPipelineCreateInfo smaaEdgeInfo{};
     smaaEdgeInfo.vertex_shader = m_fullscreenVert;
     smaaEdgeInfo.fragment_shader = Utils::loadShader(
@@ -47,6 +100,12 @@ PostProcess::PostProcess(SDL_GPUSampleCount sampleCount)
     smaaEdgeInfo.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
     smaaEdgeInfo.target_info.num_color_targets = 1;
     smaaEdgeInfo.target_info.color_target_descriptions = &smaaEdgeDesc;
+    smaaEdgeInfo.target_info.has_depth_stencil_target = true;
+    smaaEdgeInfo.target_info.depth_stencil_format = m_smaaStencilFormat;
+    smaaEdgeInfo.depth_stencil_state.enable_stencil_test = true;
+    smaaEdgeInfo.depth_stencil_state.front_stencil_state = markEdges;
+    smaaEdgeInfo.depth_stencil_state.back_stencil_state = markEdges;
+    smaaEdgeInfo.depth_stencil_state.write_mask = 0xFF;
 
     m_smaaEdgePipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &smaaEdgeInfo);
     if (!m_smaaEdgePipeline)
@@ -59,6 +118,12 @@ PostProcess::PostProcess(SDL_GPUSampleCount sampleCount)
     SDL_GPUColorTargetDescription smaaBlendDesc{};
     smaaBlendDesc.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
 
+    SDL_GPUStencilOpState onEdges{};
+    onEdges.compare_op = SDL_GPU_COMPAREOP_EQUAL;
+    onEdges.pass_op = SDL_GPU_STENCILOP_KEEP;
+    onEdges.fail_op = SDL_GPU_STENCILOP_KEEP;
+    onEdges.depth_fail_op = SDL_GPU_STENCILOP_KEEP;
+
     SDL_GPUGraphicsPipelineCreateInfo smaaBlendInfo{};
     smaaBlendInfo.vertex_shader = m_fullscreenVert;
     smaaBlendInfo.fragment_shader = Utils::loadShader(
@@ -67,6 +132,12 @@ PostProcess::PostProcess(SDL_GPUSampleCount sampleCount)
     smaaBlendInfo.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
     smaaBlendInfo.target_info.num_color_targets = 1;
     smaaBlendInfo.target_info.color_target_descriptions = &smaaBlendDesc;
+    smaaBlendInfo.target_info.has_depth_stencil_target = true;
+    smaaBlendInfo.target_info.depth_stencil_format = m_smaaStencilFormat;
+    smaaBlendInfo.depth_stencil_state.enable_stencil_test = true;
+    smaaBlendInfo.depth_stencil_state.front_stencil_state = onEdges;
+    smaaBlendInfo.depth_stencil_state.back_stencil_state = onEdges;
+    smaaBlendInfo.depth_stencil_state.compare_mask = 0xFF;
 
     m_smaaBlendPipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &smaaBlendInfo);
     if (!m_smaaBlendPipeline)
@@ -99,22 +170,50 @@ PostProcess::PostProcess(SDL_GPUSampleCount sampleCount)
 
     loadSmaaLuts();
 
-    colorTargetDesc[0].format = SDL_GPU_TEXTUREFORMAT_R11G11B10_UFLOAT;
-    pp.target_info.color_target_descriptions = colorTargetDesc;
-    pp.fragment_shader = m_bloomDownFrag;
-    m_bloomDownPipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &pp);
+    // --- TAA Resolve Pass ---
+    SDL_GPUColorTargetDescription taaColorDesc{};
+    taaColorDesc.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
+
+    SDL_GPUGraphicsPipelineCreateInfo taaInfo{};
+    taaInfo.vertex_shader = m_fullscreenVert;
+    taaInfo.fragment_shader = Utils::loadShader("src/shaders/taa.frag", 4, 1, SDL_GPU_SHADERSTAGE_FRAGMENT);
+    taaInfo.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
+    taaInfo.target_info.num_color_targets = 1;
+    taaInfo.target_info.color_target_descriptions = &taaColorDesc;
+
+    m_taaPipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &taaInfo);
+    if (!m_taaPipeline)
+    {
+        SDL_Log("Failed to create m_taaPipeline: %s", SDL_GetError());
+        return;
+    }
+
+    // --- Spatial Upscale Passes ---
+    taaInfo.fragment_shader = Utils::loadShader("src/shaders/easu.frag", 1, 1, SDL_GPU_SHADERSTAGE_FRAGMENT);
+    m_easuPipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &taaInfo);
+    if (!m_easuPipeline)
+    {
+        SDL_Log("Failed to create m_easuPipeline: %s", SDL_GetError());
+        return;
+    }
 
-    // upsample - blend
-    colorTargetDesc[0].blend_state.enable_blend = true;
-    colorTargetDesc[0].blend_state.color_blend_op = SDL_GPU_BLENDOP_ADD;
-    colorTargetDesc[0].blend_state.src_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
-    colorTargetDesc[0].blend_state.dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
-    colorTargetDesc[0].blend_state.alpha_blend_op = SDL_GPU_BLENDOP_ADD;
-    colorTargetDesc[0].blend_state.src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
-    colorTargetDesc[0].blend_state.dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE;
+    taaInfo.fragment_shader = Utils::loadShader("src/shaders/rcas.frag", 1, 1, SDL_GPU_SHADERSTAGE_FRAGMENT);
+    m_rcasPipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &taaInfo);
+    if (!m_rcasPipeline)
+    {
+        SDL_Log("Failed to create m_rcasPipeline: %s", SDL_GetError());
+        return;
+    }
 
-    pp.fragment_shader = m_bloomUpFrag;
-    m_bloomUpPipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &pp);
+    // Bloom, prefiltered into mip 0, filtered down in one dispatch and combined back up in place
+    m_bloomPrefilterPipeline = Utils::loadComputePipeline("src/shaders/bloom_prefilter.comp", 1, 1, 1, 8, 8);
+    m_bloomDownPipeline = Utils::loadComputePipeline("src/shaders/bloom_downsample.comp", 0, BLOOM_MIPS, 1, 16, 16, 1, 0, 1);
+    m_bloomUpPipeline = Utils::loadComputePipeline("src/shaders/bloom_upsample.comp", 0, 2, 1, 8, 8);
+    if (!m_bloomPrefilterPipeline || !m_bloomDownPipeline || !m_bloomUpPipeline)
+    {
+        SDL_Log("Failed to create bloom pipelines: %s", SDL_GetError());
+        return;
+    }
 
     // depth copy
     SDL_GPUGraphicsPipelineCreateInfo pp1{};
@@ -144,25 +243,25 @@ PostProcess::PostProcess(SDL_GPUSampleCount sampleCount)
 
     m_depthResolvePipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &pp2);
 
-    // 1. GTAO Generation Pipeline (Output: RG8 or RG16F)
-    SDL_GPUColorTargetDescription gtaoTargetDesc{};
-    gtaoTargetDesc.format = SDL_GPU_TEXTUREFORMAT_R8G8_UNORM; // R=visibility, G=packed depth
-
-    SDL_GPUGraphicsPipelineCreateInfo gtaoPP{};
-    gtaoPP.vertex_shader = m_fullscreenVert;
-    gtaoPP.fragment_shader = m_gtaoGenFrag;
-    gtaoPP.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
-    gtaoPP.target_info.num_color_targets = 1;
-    gtaoPP.target_info.color_target_descriptions = &gtaoTargetDesc;
-    m_gtaoGenPipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &gtaoPP);
-
-    // 2. GTAO Blur Pipeline (can reuse SSAO blur shader)
-    SDL_GPUColorTargetDescription blurTargetDesc{};
-    blurTargetDesc.format = SDL_GPU_TEXTUREFORMAT_R8_UNORM; // Just the visibility channel
+    m_hiZPipeline = Utils::loadComputePipeline("src/shaders/hiz.comp", 1, HIZ_MIPS, 1, 16, 16, 1, 0, 1);
+    if (!m_hiZPipeline)
+    {
+        SDL_Log("Failed to create m_hiZPipeline: %s", SDL_GetError());
+        return;
+    }
 
-    gtaoPP.fragment_shader = m_gtaoBlurFrag;
-    gtaoPP.target_info.color_target_descriptions = &blurTargetDesc;
-    m_gtaoBlurPipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &gtaoPP);
+    // GTAO: depth pyramid -> tile classification -> slices -> temporal accumulation -> depth aware upsample
+    m_gtaoDepthPipeline = Utils::loadComputePipeline("src/shaders/gtao_depth.comp", 2, GTAO_DEPTH_MIPS, 1, 16, 16);
+    m_gtaoClassifyPipeline = Utils::loadComputePipeline("src/shaders/gtao_classify.comp", 2, 1, 1, 8, 8, 1, 0, 1);
+    m_gtaoGenPipeline = Utils::loadComputePipeline("src/shaders/gtao.comp", 2, 1, 1, 8, 8, 1, 1, 0);
+    m_gtaoTemporalPipeline = Utils::loadComputePipeline("src/shaders/gtao_temporal.comp", 2, 1, 1, 8, 8, 1, 1, 0);
+    m_gtaoUpsamplePipeline = Utils::loadComputePipeline("src/shaders/gtao_upsample.comp", 2, 1, 1, 8, 8);
+    if (!m_gtaoDepthPipeline || !m_gtaoClassifyPipeline || !m_gtaoGenPipeline || !m_gtaoTemporalPipeline ||
+        !m_gtaoUpsamplePipeline)
+    {
+        SDL_Log("Failed to create GTAO pipelines: %s", SDL_GetError());
+        return;
+    }
 
     SDL_GPUSamplerCreateInfo samplerInfo{};
     samplerInfo.min_filter = SDL_GPU_FILTER_LINEAR;
@@ -183,56 +282,76 @@ PostProcess::PostProcess(SDL_GPUSampleCount sampleCount)
     m_UBO.fxaaEnabled = 0;
     m_UBO.lutEnabled = 0;
     m_UBO.lutIntensity = 1.f;
+    m_UBO.uvMax = glm::vec2(1.f);
+    m_fullscreenUBO.uvScale = glm::vec2(1.f);
     m_upsampleUBO.filterRadius = 1.;
     m_downsampleUBO.highlight = 100.0f;
 
     {
-        m_gtaoResolutionFactor = 1.f;
+        m_gtaoResolutionFactor = 0.5f;
         m_gtaoParams.intensity = 1.0f;
         m_gtaoParams.radius = 0.4f;
         m_gtaoParams.power = 1.0f;
         m_gtaoParams.thicknessHeuristic = 0.0f;
         m_gtaoParams.constThickness = 0.1f;
-        m_gtaoParams.sliceCount = glm::vec2(4.0f, 1.0f / 4.0f); // 4 slices
+        m_gtaoParams.sliceCount = glm::vec2(2.0f, 1.0f / 2.0f); // 2 slices per frame, more accumulate over time
         m_gtaoParams.stepsPerSlice = 4.0f;
-        m_gtaoParams.maxLevel = 0; // Mip level for depth sampling
+        m_gtaoParams.maxLevel = GTAO_DEPTH_MIPS - 1; // Mip level for depth sampling
+        m_gtaoParams.frameIndex = 0;
+        m_gtaoTemporal.feedback = 0.9f;
     }
 
     m_sampleCount = sampleCount;
 
     m_aaMode = AA_SMAA;
     m_smaaUniforms.edgeDetectionMode = 0;
+    m_taaUniforms.feedback = 0.9f;
+    m_upscaleUniforms.sharpness = 0.2f;
 }
 
 PostProcess::~PostProcess()
 {
     SDL_ReleaseGPUSampler(Utils::device, m_clampedSampler);
-    SDL_ReleaseGPUTexture(Utils::device, m_intermediateTexture);
-    SDL_ReleaseGPUTexture(Utils::device, m_colorTexture);
-    SDL_ReleaseGPUTexture(Utils::device, m_depthTexture);
-    SDL_ReleaseGPUTexture(Utils::device, m_gtaoRawTexture);
-    SDL_ReleaseGPUTexture(Utils::device, m_gtaoBlur0Texture);
-    SDL_ReleaseGPUTexture(Utils::device, m_gtaoBlur1Texture);
-
-    for (int i = 0; i < BLOOM_MIPS; i++)
-        SDL_ReleaseGPUTexture(Utils::device, m_bloomMip[i]);
+    GPU::releaseTexture(Utils::device, m_colorTexture);
+    GPU::releaseTexture(Utils::device, m_depthTexture);
+    GPU::releaseTexture(Utils::device, m_hiZTexture);
+    GPU::releaseBuffer(Utils::device, m_hiZBuffer);
+    GPU::releaseBuffer(Utils::device, m_bloomBuffer);
+    GPU::releaseTexture(Utils::device, m_gtaoHistory[0]);
+    GPU::releaseTexture(Utils::device, m_gtaoHistory[1]);
+    GPU::releaseTexture(Utils::device, m_gtaoMaskTexture);
+    GPU::releaseBuffer(Utils::device, m_gtaoTileBuffer);
+    GPU::releaseTransferBuffer(Utils::device, m_gtaoTileReset);
 
     SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_postProcessPipeline);
-    SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_bloomDownPipeline);
-    SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_bloomUpPipeline);
-    SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_gtaoGenPipeline);
-    SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_gtaoBlurPipeline);
+    SDL_ReleaseGPUComputePipeline(Utils::device, m_bloomPrefilterPipeline);
+    SDL_ReleaseGPUComputePipeline(Utils::device, m_bloomDownPipeline);
+    SDL_ReleaseGPUComputePipeline(Utils::device, m_bloomUpPipeline);
+    SDL_ReleaseGPUComputePipeline(Utils::device, m_hiZPipeline);
+    SDL_ReleaseGPUComputePipeline(Utils::device, m_gtaoDepthPipeline);
+    SDL_ReleaseGPUComputePipeline(Utils::device, m_gtaoClassifyPipeline);
+    SDL_ReleaseGPUComputePipeline(Utils::device, m_gtaoGenPipeline);
+    SDL_ReleaseGPUComputePipeline(Utils::device, m_gtaoTemporalPipeline);
+    SDL_ReleaseGPUComputePipeline(Utils::device, m_gtaoUpsamplePipeline);
 
     // SMAA
-    SDL_ReleaseGPUTexture(Utils::device, m_smaaEdgeTex);
-    SDL_ReleaseGPUTexture(Utils::device, m_smaaBlendTex);
-    SDL_ReleaseGPUTexture(Utils::device, m_smaaColorTex);
-    SDL_ReleaseGPUTexture(Utils::device, m_smaaAreaTex);
-    SDL_ReleaseGPUTexture(Utils::device, m_smaaSearchTex);
+    GPU::releaseTexture(Utils::device, m_smaaAreaTex);
+    GPU::releaseTexture(Utils::device, m_smaaSearchTex);
     SDL_ReleaseGPUSampler(Utils::device, m_smaaLutSampler);
     SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_smaaEdgePipeline);
     SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_smaaBlendPipeline);
     SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_smaaNeighborPipeline);
+
+    // TAA
+    GPU::releaseTexture(Utils::device, m_msaaVelocityTexture);
+    GPU::releaseTexture(Utils::device, m_velocityTexture);
+    GPU::releaseTexture(Utils::device, m_taaHistory[0]);
+    GPU::releaseTexture(Utils::device, m_taaHistory[1]);
+    SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_taaPipeline);
+
+    // Upscale
+    SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_easuPipeline);
+    SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_rcasPipeline);
 }
 
 void PostProcess::renderUI()
@@ -240,13 +359,23 @@ void PostProcess::renderUI()
     if (!ImGui::CollapsingHeader("Post Process", m_uiDefaultOpen ? ImGuiTreeNodeFlags_DefaultOpen : 0))
         return;
 
-    ImGui::Text("Screen Size: (%d, %d)", (int)m_UBO.screenSize.x, (int)m_UBO.screenSize.y);
+    ImGui::Text("Screen Size: (%d, %d)", m_screenSize.x, m_screenSize.y);
+    ImGui::Text("Render Size: (%d, %d)", m_renderSize.x, m_renderSize.y);
 
-    const char *aaItems[] = {"None", "FXAA", "SMAA"};
+    const char *aaItems[] = {"None", "FXAA", "SMAA", "TAA"};
     int aaMode = m_aaMode;
     if (ImGui::Combo("Anti-Aliasing", &aaMode, aaItems, IM_ARRAYSIZE(aaItems)))
         setAntiAliasingMode((AntiAliasingMode)aaMode);
 
+    const char *upscaleItems[] = {"Bilinear", "EASU"};
+    int upscaleMode = m_upscaleMode;
+    if (ImGui::Combo("Upscaler", &upscaleMode, upscaleItems, IM_ARRAYSIZE(upscaleItems)))
+        m_upscaleMode = (UpscaleMode)upscaleMode;
+
+    ImGui::Checkbox("Sharpen (RCAS)", &m_sharpenEnabled);
+    if (m_sharpenEnabled)
+        ImGui::SliderFloat("Sharpness (stops)", &m_upscaleUniforms.sharpness, 0.f, 2.f);
+
     {
         const char *msaaOptions[] = {"1x", "2x", "4x", "8x"};
         SDL_GPUSampleCount msaaValues[] = {
@@ -276,7 +405,7 @@ void PostProcess::renderUI()
         {
             for (int i = 0; i < 4; i++)
             {
-                bool isSupported = SDL_GPUTextureSupportsSampleCount(Utils::device, SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, msaaValues[i]);
+                bool isSupported = Utils::supportsSceneMSAA(msaaValues[i]);
 
                 if (!isSupported)
                 {
@@ -299,6 +428,23 @@ void PostProcess::renderUI()
         }
     }
 
+    if (ImGui::TreeNode("Dynamic Resolution"))
+    {
+        ImGui::Checkbox("Enabled", &m_dynamicResolution);
+        ImGui::DragFloat("Target Frame Time (ms)", &m_targetFrameTime, 0.1f, 1.f, 100.f);
+        ImGui::DragFloat("Min Scale", &m_minRenderScale, 0.01f, 0.25f, m_maxRenderScale);
+        ImGui::DragFloat("Max Scale", &m_maxRenderScale, 0.01f, m_minRenderScale, 1.f);
+
+        ImGui::BeginDisabled(m_dynamicResolution);
+        ImGui::SliderFloat("Render Scale", &m_renderScale, m_minRenderScale, m_maxRenderScale);
+        ImGui::EndDisabled();
+
+        ImGui::Text("CPU: %.2f ms, GPU: %.2f ms", m_cpuFrameTime, m_gpuFrameTime);
+        ImGui::Text("Smoothed CPU: %.2f ms, GPU: %.2f ms", m_smoothedCPUTime, m_smoothedGPUTime);
+
+        ImGui::TreePop();
+    }
+
     if (ImGui::TreeNode("Tone Mapping"))
     {
         ImGui::DragFloat("Exposure", &m_UBO.exposure, 0.01f, 0.f);
@@ -314,28 +460,19 @@ void PostProcess::renderUI()
         ImGui::DragFloat("Filter Radius", &m_upsampleUBO.filterRadius, 0.001f, 0.f);
         ImGui::DragFloat("Higlight", &m_downsampleUBO.highlight, 0.1f, 0.f);
 
-        if (ImGui::TreeNode("Mip Textures"))
-        {
-            for (int i = 0; i < BLOOM_MIPS; i++)
-            {
-                if (!m_bloomMip[i])
-                    continue;
-
-                ImGui::Text("Mip %d", i);
-                ImTextureID texID = (ImTextureID)(m_bloomMip[i]);
-                ImGui::Image(texID, ImVec2(m_UBO.screenSize.x * 0.2f, m_UBO.screenSize.y * 0.2f));
-
-                ImGui::Spacing();
-            }
-            ImGui::TreePop();
-        }
+        if (m_bloomTexture)
+            ImGui::Image((ImTextureID)(m_bloomTexture), ImVec2(m_UBO.screenSize.x * 0.2f, m_UBO.screenSize.y * 0.2f));
         ImGui::TreePop();
     }
 
     if (ImGui::TreeNode("GTAO"))
     // if (ImGui::TreeNodeEx("GTAO", ImGuiTreeNodeFlags_DefaultOpen))
     {
-        ImGui::DragFloat("Resolution Factor", &m_gtaoResolutionFactor, 0.01f, 0.1f, 1.0f);
+        const char *resolutionItems[] = {"Full", "Half", "Quarter"};
+        const float resolutionFactors[] = {1.f, 0.5f, 0.25f};
+        int resolution = m_gtaoResolutionFactor > 0.75f ? 0 : (m_gtaoResolutionFactor > 0.375f ? 1 : 2);
+        if (ImGui::Combo("Resolution", &resolution, resolutionItems, IM_ARRAYSIZE(resolutionItems)))
+            m_gtaoResolutionFactor = resolutionFactors[resolution];
         ImGui::DragFloat("Intensity", &m_gtaoParams.intensity, 0.01f, 0.0f, 4.0f);
         ImGui::DragFloat("Radius", &m_gtaoParams.radius, 0.01f, 0.f, 5.0f);
         ImGui::DragFloat("Power", &m_gtaoParams.power, 0.1f, 0.f, 10.0f);
@@ -343,7 +480,7 @@ void PostProcess::renderUI()
         if (ImGui::TreeNode("Advanced"))
         {
             int slices = (int)m_gtaoParams.sliceCount.x;
-            if (ImGui::SliderInt("Slices", &slices, 1, 8))
+            if (ImGui::SliderInt("Slices Per Frame", &slices, 1, 8))
             {
                 m_gtaoParams.sliceCount = glm::vec2(slices, 1.0f / slices);
             }
@@ -351,6 +488,7 @@ void PostProcess::renderUI()
             ImGui::DragFloat("Steps Per Slice", &m_gtaoParams.stepsPerSlice, 0.5f, 1.0f, 16.0f);
             ImGui::DragFloat("Thickness Heuristic", &m_gtaoParams.thicknessHeuristic, 0.01f, 0.0f, 1.0f);
             ImGui::DragFloat("Const Thickness", &m_gtaoParams.constThickness, 0.01f, 0.0f, 1.0f);
+            ImGui::SliderFloat("Temporal Feedback", &m_gtaoTemporal.feedback, 0.0f, 0.98f);
 
             ImGui::TreePop();
         }
@@ -361,9 +499,13 @@ void PostProcess::renderUI()
         if (m_gtaoRawTexture)
             ImGui::Image((ImTextureID)(m_gtaoRawTexture), size);
 
-        ImGui::Text("GTAO - Blur");
-        if (m_gtaoBlur1Texture)
-            ImGui::Image((ImTextureID)(m_gtaoBlur1Texture), size);
+        ImGui::Text("GTAO - Accumulated");
+        if (m_gtaoHistory[m_gtaoHistoryIndex])
+            ImGui::Image((ImTextureID)(m_gtaoHistory[m_gtaoHistoryIndex]), size);
+
+        ImGui::Text("GTAO - Upsampled");
+        if (m_gtaoTexture)
+            ImGui::Image((ImTextureID)(m_gtaoTexture), size);
 
         ImGui::TreePop();
     }
@@ -379,12 +521,16 @@ void PostProcess::renderUI()
         float scale = 0.4f;
         ImVec2 size(m_UBO.screenSize.x * scale, m_UBO.screenSize.y * scale);
 
-        ImGui::Text("m_smaaEdgeTex");
-        ImGui::Image((ImTextureID)(m_smaaEdgeTex), size);
-        ImGui::Text("m_smaaBlendTex");
-        ImGui::Image((ImTextureID)(m_smaaBlendTex), size);
-        ImGui::Text("m_smaaColorTex");
-        ImGui::Image((ImTextureID)(m_smaaColorTex), size);
+        // Only allocated while SMAA is on
+        if (m_smaaEdgeTex)
+        {
+            ImGui::Text("m_smaaEdgeTex");
+            ImGui::Image((ImTextureID)(m_smaaEdgeTex), size);
+            ImGui::Text("m_smaaBlendTex");
+            ImGui::Image((ImTextureID)(m_smaaBlendTex), size);
+            ImGui::Text("m_smaaColorTex");
+            ImGui::Image((ImTextureID)(m_smaaColorTex), size);
+        }
 
         if (ImGui::TreeNode("Lut Textures"))
         {
@@ -408,6 +554,21 @@ void PostProcess::renderUI()
         ImGui::TreePop();
     }
 
+    if (ImGui::TreeNode("TAA"))
+    {
+        ImGui::SliderFloat("Feedback", &m_taaUniforms.feedback, 0.5f, 0.98f);
+        ImGui::Text("Jitter: (%.5f, %.5f)", m_jitter.x, m_jitter.y);
+        if (ImGui::Button("Reset History"))
+            m_taaHistoryValid = false;
+
+        ImVec2 size(m_UBO.screenSize.x * 0.3f, m_UBO.screenSize.y * 0.3f);
+        ImGui::Text("Velocity");
+        if (m_velocityTexture)
+            ImGui::Image((ImTextureID)(m_velocityTexture), size);
+
+        ImGui::TreePop();
+    }
+
     if (ImGui::TreeNode("Textures"))
     {
         ImGui::Text("Color");
@@ -423,134 +584,149 @@ void PostProcess::setAntiAliasingMode(AntiAliasingMode mode)
 {
     m_aaMode = (AntiAliasingMode)mode;
     m_UBO.fxaaEnabled = (m_aaMode == AA_FXAA) ? 1 : 0;
+    m_taaHistoryValid = false;
 }
 
 void PostProcess::update(glm::ivec2 screenSize)
 {
-    m_UBO.screenSize = screenSize;
+    m_screenSize = screenSize;
+
+    m_maxRenderScale = glm::clamp(m_maxRenderScale, 0.25f, 1.f);
+    m_minRenderScale = glm::clamp(m_minRenderScale, 0.25f, m_maxRenderScale);
+    m_renderScale = glm::clamp(m_renderScale, m_minRenderScale, m_maxRenderScale);
+
+    // Render targets only follow the max scale, the render scale moves inside them
+    glm::ivec2 targetSize = glm::max(glm::ivec2(glm::ceil(glm::vec2(screenSize) * m_maxRenderScale)), glm::ivec2(1));
 
     static Uint32 lastW = 0, lastH = 0;
+    static glm::ivec2 lastTargetSize;
     static SDL_GPUSampleCount lastSampleCount;
     static float lastGtaoResolution;
     if (lastW != screenSize.x ||
         lastH != screenSize.y ||
+        lastTargetSize != targetSize ||
         lastSampleCount != m_sampleCount ||
         lastGtaoResolution != m_gtaoResolutionFactor)
     {
-        if (m_intermediateTexture)
-            SDL_ReleaseGPUTexture(Utils::device, m_intermediateTexture);
-
-        SDL_GPUTextureCreateInfo colorInfo{};
-        colorInfo.format = SDL_GetGPUSwapchainTextureFormat(Utils::device, Utils::window);
-        colorInfo.width = screenSize.x;
-        colorInfo.height = screenSize.y;
-        colorInfo.num_levels = 1;
-        colorInfo.type = SDL_GPU_TEXTURETYPE_2D;
-        colorInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
-        colorInfo.sample_count = SDL_GPUSampleCount::SDL_GPU_SAMPLECOUNT_1;
-        m_intermediateTexture = SDL_CreateGPUTexture(Utils::device, &colorInfo);
+        m_targetSize = targetSize;
 
         if (m_msaaColorTexture)
-            SDL_ReleaseGPUTexture(Utils::device, m_msaaColorTexture);
+            GPU::releaseTexture(Utils::device, m_msaaColorTexture);
         if (m_msaaDepthTexture)
-            SDL_ReleaseGPUTexture(Utils::device, m_msaaDepthTexture);
+            GPU::releaseTexture(Utils::device, m_msaaDepthTexture);
 
         // MSAA Color Target
         SDL_GPUTextureCreateInfo msaaColorInfo{};
         msaaColorInfo.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
-        msaaColorInfo.width = screenSize.x;
-        msaaColorInfo.height = screenSize.y;
+        msaaColorInfo.width = m_targetSize.x;
+        msaaColorInfo.height = m_targetSize.y;
         msaaColorInfo.num_levels = 1;
         msaaColorInfo.type = SDL_GPU_TEXTURETYPE_2D;
         msaaColorInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET; // Not sampled directly
         msaaColorInfo.sample_count = m_sampleCount;
-        m_msaaColorTexture = SDL_CreateGPUTexture(Utils::device, &msaaColorInfo);
+        m_msaaColorTexture = GPU::createTexture(Utils::device, &msaaColorInfo, GPUMemoryCategory::RenderTarget);
 
         // MSAA Depth Target
         SDL_GPUTextureCreateInfo msaaDepthInfo{};
         msaaDepthInfo.format = SDL_GPU_TEXTUREFORMAT_D32_FLOAT;
-        msaaDepthInfo.width = screenSize.x;
-        msaaDepthInfo.height = screenSize.y;
+        msaaDepthInfo.width = m_targetSize.x;
+        msaaDepthInfo.height = m_targetSize.y;
         msaaDepthInfo.num_levels = 1;
         msaaDepthInfo.type = SDL_GPU_TEXTURETYPE_2D;
         msaaDepthInfo.usage = SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
         msaaDepthInfo.sample_count = m_sampleCount;
-        m_msaaDepthTexture = SDL_CreateGPUTexture(Utils::device, &msaaDepthInfo);
+        m_msaaDepthTexture = GPU::createTexture(Utils::device, &msaaDepthInfo, GPUMemoryCategory::RenderTarget);
 
         if (m_colorTexture)
-            SDL_ReleaseGPUTexture(Utils::device, m_colorTexture);
+            GPU::releaseTexture(Utils::device, m_colorTexture);
 
         SDL_GPUTextureCreateInfo rtInfo{};
         rtInfo.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
-        rtInfo.width = screenSize.x;
-        rtInfo.height = screenSize.y;
+        rtInfo.width = m_targetSize.x;
+        rtInfo.height = m_targetSize.y;
         rtInfo.num_levels = 1;
         rtInfo.type = SDL_GPU_TEXTURETYPE_2D;
         rtInfo.layer_count_or_depth = 1;
         rtInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
 
-        m_colorTexture = SDL_CreateGPUTexture(Utils::device, &rtInfo);
-
-        for (int i = 0; i < BLOOM_MIPS; i++)
-        {
-            if (m_bloomMip[i])
-                SDL_ReleaseGPUTexture(Utils::device, m_bloomMip[i]);
-
-            SDL_GPUTextureCreateInfo info{};
-            info.format = SDL_GPU_TEXTUREFORMAT_R11G11B10_UFLOAT;
-            info.width = screenSize.x >> i;
-            info.height = screenSize.y >> i;
-            info.num_levels = 1;
-            info.type = SDL_GPU_TEXTURETYPE_2D;
-            info.layer_count_or_depth = 1;
-            info.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
-
-            m_bloomMip[i] = SDL_CreateGPUTexture(Utils::device, &info);
-        }
+        m_colorTexture = GPU::createTexture(Utils::device, &rtInfo, GPUMemoryCategory::RenderTarget);
 
         if (m_depthTexture)
-            SDL_ReleaseGPUTexture(Utils::device, m_depthTexture);
+            GPU::releaseTexture(Utils::device, m_depthTexture);
 
         SDL_GPUTextureCreateInfo depthInfo{};
         depthInfo.type = SDL_GPU_TEXTURETYPE_2D;
         depthInfo.format = SDL_GPU_TEXTUREFORMAT_R32_FLOAT;
-        depthInfo.width = screenSize.x;
-        depthInfo.height = screenSize.y;
+        depthInfo.width = m_targetSize.x;
+        depthInfo.height = m_targetSize.y;
         depthInfo.layer_count_or_depth = 1;
         depthInfo.num_levels = 1;
         depthInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
-        m_depthTexture = SDL_CreateGPUTexture(Utils::device, &depthInfo);
+        m_depthTexture = GPU::createTexture(Utils::device, &depthInfo, GPUMemoryCategory::RenderTarget);
+
+        if (m_hiZTexture)
+            GPU::releaseTexture(Utils::device, m_hiZTexture);
+        if (m_hiZBuffer)
+            GPU::releaseBuffer(Utils::device, m_hiZBuffer);
+
+        // Rounded up so every level halves exactly and the mip regions line up
+        const int hiZAlign = 1 << (HIZ_MIPS - 1);
+        m_hiZSize = ((m_targetSize + 1) / 2 + hiZAlign - 1) / hiZAlign * hiZAlign;
+
+        SDL_GPUTextureCreateInfo hiZInfo{};
+        hiZInfo.type = SDL_GPU_TEXTURETYPE_2D;
+        hiZInfo.format = SDL_GPU_TEXTUREFORMAT_R32G32_FLOAT;
+        hiZInfo.width = m_hiZSize.x;
+        hiZInfo.height = m_hiZSize.y;
+        hiZInfo.layer_count_or_depth = 1;
+        hiZInfo.num_levels = HIZ_MIPS;
+        hiZInfo.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE;
+        m_hiZTexture = GPU::createTexture(Utils::device, &hiZInfo, GPUMemoryCategory::RenderTarget);
+        SDL_SetGPUTextureName(Utils::device, m_hiZTexture, "Hi-Z");
+
+        // Counter header, then one min/max pair per group
+        glm::ivec2 hiZGroups = m_hiZSize / 32;
+        SDL_GPUBufferCreateInfo hiZBufferInfo{};
+        hiZBufferInfo.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+        hiZBufferInfo.size = 16 + hiZGroups.x * hiZGroups.y * sizeof(glm::vec2);
+        m_hiZBuffer = GPU::createBuffer(Utils::device, &hiZBufferInfo, GPUMemoryCategory::RenderTarget);
+        m_hiZBufferCleared = false;
+
+        if (m_bloomBuffer)
+            GPU::releaseBuffer(Utils::device, m_bloomBuffer);
+
+        // One counter per group, then mip 3 of the whole target as RGB halves
+        glm::ivec2 bloomGroups = getBloomGroups(m_targetSize);
+        glm::ivec2 bloomMip3 = glm::max(m_targetSize >> 3, glm::ivec2(1));
+        SDL_GPUBufferCreateInfo bloomBufferInfo{};
+        bloomBufferInfo.usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+        bloomBufferInfo.size = (bloomGroups.x * bloomGroups.y + bloomMip3.x * bloomMip3.y * 2) * sizeof(Uint32);
+        m_bloomBuffer = GPU::createBuffer(Utils::device, &bloomBufferInfo, GPUMemoryCategory::RenderTarget);
+        m_bloomBufferCleared = false;
+
+        for (int i = 0; i < 2; i++)
+        {
+            if (m_gtaoHistory[i])
+                GPU::releaseTexture(Utils::device, m_gtaoHistory[i]);
+        }
 
-        if (m_gtaoRawTexture)
-            SDL_ReleaseGPUTexture(Utils::device, m_gtaoRawTexture);
-        if (m_gtaoBlur0Texture)
-            SDL_ReleaseGPUTexture(Utils::device, m_gtaoBlur0Texture);
-        if (m_gtaoBlur1Texture)
-            SDL_ReleaseGPUTexture(Utils::device, m_gtaoBlur1Texture);
-
-        SDL_GPUTextureCreateInfo gtaoRawInfo{};
-        gtaoRawInfo.format = SDL_GPU_TEXTUREFORMAT_R8G8_UNORM; // RG for visibility + packed depth
         m_gtaoResolutionFactor = std::max(m_gtaoResolutionFactor, 0.1f);
-        gtaoRawInfo.width = screenSize.x * m_gtaoResolutionFactor;
-        gtaoRawInfo.height = screenSize.y * m_gtaoResolutionFactor;
-        gtaoRawInfo.num_levels = 1;
-        gtaoRawInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
-
-        m_gtaoRawTexture = SDL_CreateGPUTexture(Utils::device, &gtaoRawInfo);
-        SDL_SetGPUTextureName(Utils::device, m_gtaoRawTexture, "GTAO Raw");
+        m_gtaoSize = glm::max(glm::ivec2(glm::vec2(m_targetSize) * m_gtaoResolutionFactor), glm::ivec2(1));
 
-        SDL_GPUTextureCreateInfo gtaoBlurInfo{};
-        gtaoBlurInfo.format = SDL_GPU_TEXTUREFORMAT_R8_UNORM; // Just visibility
-        gtaoBlurInfo.width = screenSize.x * m_gtaoResolutionFactor;
-        gtaoBlurInfo.height = screenSize.y * m_gtaoResolutionFactor;
-        gtaoBlurInfo.num_levels = 1;
-        gtaoBlurInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
+        SDL_GPUTextureCreateInfo gtaoHistoryInfo{};
+        gtaoHistoryInfo.format = SDL_GPU_TEXTUREFORMAT_R16G16_FLOAT; // RG for visibility + linear depth
+        gtaoHistoryInfo.width = m_gtaoSize.x;
+        gtaoHistoryInfo.height = m_gtaoSize.y;
+        gtaoHistoryInfo.layer_count_or_depth = 1;
+        gtaoHistoryInfo.num_levels = 1;
+        gtaoHistoryInfo.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE;
 
-        m_gtaoBlur0Texture = SDL_CreateGPUTexture(Utils::device, &gtaoBlurInfo);
-        m_gtaoBlur1Texture = SDL_CreateGPUTexture(Utils::device, &gtaoBlurInfo);
+        m_gtaoHistory[0] = GPU::createTexture(Utils::device, &gtaoHistoryInfo, GPUMemoryCategory::RenderTarget);
+        m_gtaoHistory[1] = GPU::createTexture(Utils::device, &gtaoHistoryInfo, GPUMemoryCategory::RenderTarget);
+        m_gtaoHistoryValid = false;
 
         if (m_gtaoMaskTexture)
-            SDL_ReleaseGPUTexture(Utils::device, m_gtaoMaskTexture);
+            GPU::releaseTexture(Utils::device, m_gtaoMaskTexture);
 
         // 1. Create the Texture
         SDL_GPUTextureCreateInfo maskInfo{};
@@ -561,112 +737,239 @@ void PostProcess::update(glm::ivec2 screenSize)
         maskInfo.num_levels = 1;
         maskInfo.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER; // We only read it in shader
 
-        m_gtaoMaskTexture = SDL_CreateGPUTexture(Utils::device, &maskInfo);
+        m_gtaoMaskTexture = GPU::createTexture(Utils::device, &maskInfo, GPUMemoryCategory::RenderTarget);
         SDL_SetGPUTextureName(Utils::device, m_gtaoMaskTexture, "GTAO Mask");
+        m_gtaoMask.markDirty();
 
-        // SMAA edge texture
-        if (m_smaaEdgeTex)
-            SDL_ReleaseGPUTexture(Utils::device, m_smaaEdgeTex);
-
-        SDL_GPUTextureCreateInfo edgeInfo{};
-        edgeInfo.format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM;
-        edgeInfo.width = screenSize.x;
-        edgeInfo.height = screenSize.y;
-        edgeInfo.num_levels = 1;
-        edgeInfo.type = SDL_GPU_TEXTURETYPE_2D;
-        edgeInfo.layer_count_or_depth = 1;
-        edgeInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
-        m_smaaEdgeTex = SDL_CreateGPUTexture(Utils::device, &edgeInfo);
-
-        // SMAA blend weights texture
-        if (m_smaaBlendTex)
-            SDL_ReleaseGPUTexture(Utils::device, m_smaaBlendTex);
-
-        SDL_GPUTextureCreateInfo blendInfo = edgeInfo;
-        m_smaaBlendTex = SDL_CreateGPUTexture(Utils::device, &blendInfo);
-
-        // SMAA output color texture
-        if (m_smaaColorTex)
-            SDL_ReleaseGPUTexture(Utils::device, m_smaaColorTex);
-
-        SDL_GPUTextureCreateInfo smaaColorInfo{};
-        smaaColorInfo.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
-        smaaColorInfo.width = screenSize.x;
-        smaaColorInfo.height = screenSize.y;
-        smaaColorInfo.num_levels = 1;
-        smaaColorInfo.type = SDL_GPU_TEXTURETYPE_2D;
-        smaaColorInfo.layer_count_or_depth = 1;
-        smaaColorInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
-        m_smaaColorTex = SDL_CreateGPUTexture(Utils::device, &smaaColorInfo);
+        if (m_gtaoTileBuffer)
+            GPU::releaseBuffer(Utils::device, m_gtaoTileBuffer);
+
+        glm::ivec2 gtaoTiles = (m_gtaoSize + 7) / 8;
+        SDL_GPUBufferCreateInfo tileInfo{};
+        tileInfo.usage = SDL_GPU_BUFFERUSAGE_INDIRECT |
+                         SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ |
+                         SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE;
+        tileInfo.size = 16 + gtaoTiles.x * gtaoTiles.y * sizeof(Uint32);
+        m_gtaoTileBuffer = GPU::createBuffer(Utils::device, &tileInfo, GPUMemoryCategory::RenderTarget);
 
         m_smaaUniforms.rtMetrics = glm::vec4(
-            1.0f / screenSize.x,
-            1.0f / screenSize.y,
-            (float)screenSize.x,
-            (float)screenSize.y);
+            1.0f / m_targetSize.x,
+            1.0f / m_targetSize.y,
+            (float)m_targetSize.x,
+            (float)m_targetSize.y);
+
+        // TAA velocity, written by the opaque pass next to the scene color
+        if (m_msaaVelocityTexture)
+            GPU::releaseTexture(Utils::device, m_msaaVelocityTexture);
+        if (m_velocityTexture)
+            GPU::releaseTexture(Utils::device, m_velocityTexture);
+
+        SDL_GPUTextureCreateInfo velocityInfo{};
+        velocityInfo.format = SDL_GPU_TEXTUREFORMAT_R16G16_FLOAT;
+        velocityInfo.width = m_targetSize.x;
+        velocityInfo.height = m_targetSize.y;
+        velocityInfo.num_levels = 1;
+        velocityInfo.type = SDL_GPU_TEXTURETYPE_2D;
+        velocityInfo.layer_count_or_depth = 1;
+        velocityInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
+        m_velocityTexture = GPU::createTexture(Utils::device, &velocityInfo, GPUMemoryCategory::RenderTarget);
+        SDL_SetGPUTextureName(Utils::device, m_velocityTexture, "Velocity");
+
+        m_msaaVelocityTexture = nullptr;
+        if (m_sampleCount != SDL_GPU_SAMPLECOUNT_1)
+        {
+            velocityInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+            velocityInfo.sample_count = m_sampleCount;
+            m_msaaVelocityTexture = GPU::createTexture(Utils::device, &velocityInfo, GPUMemoryCategory::RenderTarget);
+        }
+
+        // TAA history, resolved at display resolution so it also upsamples
+        for (int i = 0; i < 2; i++)
+        {
+            if (m_taaHistory[i])
+                GPU::releaseTexture(Utils::device, m_taaHistory[i]);
+
+            SDL_GPUTextureCreateInfo historyInfo{};
+            historyInfo.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
+            historyInfo.width = screenSize.x;
+            historyInfo.height = screenSize.y;
+            historyInfo.num_levels = 1;
+            historyInfo.type = SDL_GPU_TEXTURETYPE_2D;
+            historyInfo.layer_count_or_depth = 1;
+            historyInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
+            m_taaHistory[i] = GPU::createTexture(Utils::device, &historyInfo, GPUMemoryCategory::RenderTarget);
+        }
+        m_taaHistoryValid = false;
 
         lastW = screenSize.x;
         lastH = screenSize.y;
+        lastTargetSize = targetSize;
         lastSampleCount = m_sampleCount;
         lastGtaoResolution = m_gtaoResolutionFactor;
     }
+
+    m_renderSize = glm::clamp(glm::ivec2(glm::vec2(screenSize) * m_renderScale), glm::ivec2(1), m_targetSize);
+
+    glm::vec2 targetSizeF = glm::vec2(m_targetSize);
+    m_fullscreenUBO.uvScale = glm::vec2(m_renderSize) / targetSizeF;
+    m_UBO.screenSize = targetSizeF;
+    m_UBO.uvMax = (glm::vec2(m_renderSize) - 0.5f) / targetSizeF;
+
+    if (m_aaMode == AA_TAA)
+    {
+        // More phases at lower render scales so every display pixel gets covered
+        float scale = glm::vec2(m_renderSize).x / glm::max(1.f, (float)screenSize.x);
+        int phases = glm::clamp((int)glm::ceil(8.f / (scale * scale)), 8, 64);
+        int index = (m_taaFrame++ % phases) + 1;
+
+        glm::vec2 offset(halton(index, 2) - 0.5f, halton(index, 3) - 0.5f);
+        m_jitter = offset * 2.f / glm::vec2(m_renderSize);
+    }
+    else
+    {
+        m_jitter = glm::vec2(0.f);
+    }
+}
+
+void PostProcess::updateRenderScale(float cpuFrameTime, float gpuFrameTime)
+{
+    m_cpuFrameTime = cpuFrameTime;
+    m_gpuFrameTime = gpuFrameTime;
+
+    if (!m_dynamicResolution)
+        return;
+
+    // Resolution only changes GPU cost, nothing is decided until a GPU time was measured
+    if (gpuFrameTime <= 0.f)
+        return;
+
+    if (m_smoothedGPUTime <= 0.f)
+    {
+        m_smoothedGPUTime = gpuFrameTime;
+        m_smoothedCPUTime = cpuFrameTime;
+    }
+    m_smoothedGPUTime = glm::mix(m_smoothedGPUTime, gpuFrameTime, 0.1f);
+    m_smoothedCPUTime = glm::mix(m_smoothedCPUTime, cpuFrameTime, 0.1f);
+
+    float budget = m_targetFrameTime / std::max(m_smoothedGPUTime, 0.01f);
+
+    // A CPU bound frame does not get faster at a lower resolution
+    if (budget < 1.f && m_smoothedCPUTime >= m_smoothedGPUTime)
+        return;
+
+    // Dead band around the target keeps the scale from hunting every frame
+    if (std::abs(budget - 1.f) < 0.05f)
+        return;
+
+    // Pixel cost grows with the area, so the linear scale follows the square root
+    float desired = m_renderScale * std::sqrt(budget);
+    m_renderScale = glm::clamp(glm::mix(m_renderScale, desired, 0.2f), m_minRenderScale, m_maxRenderScale);
+}
+
+void PostProcess::bindRenderViewport(SDL_GPUCommandBuffer *commandBuffer, SDL_GPURenderPass *pass)
+{
+    bindViewport(commandBuffer, pass, m_renderSize);
+}
+
+void PostProcess::bindViewport(SDL_GPUCommandBuffer *commandBuffer, SDL_GPURenderPass *pass, glm::ivec2 size)
+{
+    size = glm::max(size, glm::ivec2(1));
+
+    SDL_GPUViewport viewport{};
+    viewport.w = (float)size.x;
+    viewport.h = (float)size.y;
+    viewport.min_depth = 0.0f;
+    viewport.max_depth = 1.0f;
+    GPU::setViewport(pass, &viewport);
+
+    SDL_Rect scissor{0, 0, size.x, size.y};
+    GPU::setScissor(pass, &scissor);
+
+    GPU::pushVertexUniformData(commandBuffer, 0, &m_fullscreenUBO, sizeof(m_fullscreenUBO));
 }
 
 void PostProcess::downsample(SDL_GPUCommandBuffer *commandBuffer)
 {
-    // Downsample chain
-    SDL_GPUTexture *src = m_colorTexture;
+    m_downsampleUBO.invTargetSize = 1.f / glm::vec2(m_targetSize);
+    m_downsampleUBO.uvMax = m_UBO.uvMax;
+    m_downsampleUBO.renderSize = m_renderSize;
 
-    for (int i = 0; i < BLOOM_MIPS; i++)
+    // Mip 0 filters and thresholds the scene
     {
-        SDL_GPUColorTargetInfo rt{};
-        rt.texture = m_bloomMip[i];
-        rt.load_op = SDL_GPU_LOADOP_CLEAR;
-        rt.store_op = SDL_GPU_STOREOP_STORE;
+        SDL_GPUStorageTextureReadWriteBinding mip{};
+        mip.texture = m_bloomTexture;
+        mip.mip_level = 0;
 
-        SDL_GPURenderPass *rp = SDL_BeginGPURenderPass(commandBuffer, &rt, 1, nullptr);
+        SDL_GPUComputePass *pass = GPU::beginComputePass(commandBuffer, &mip, 1, nullptr, 0);
         {
-            SDL_BindGPUGraphicsPipeline(rp, m_bloomDownPipeline);
-
-            m_downsampleUBO.mipLevel = i;
-            SDL_PushGPUFragmentUniformData(commandBuffer, 0, &m_downsampleUBO, sizeof(m_downsampleUBO));
+            GPU::bindComputePipeline(pass, m_bloomPrefilterPipeline);
 
-            SDL_GPUTextureSamplerBinding bind = {src, m_clampedSampler};
-            SDL_BindGPUFragmentSamplers(rp, 0, &bind, 1);
+            SDL_GPUTextureSamplerBinding bind = {m_colorTexture, m_clampedSampler};
+            GPU::bindComputeSamplers(pass, 0, &bind, 1);
+            GPU::pushComputeUniformData(commandBuffer, 0, &m_downsampleUBO, sizeof(m_downsampleUBO));
 
-            SDL_DrawGPUPrimitives(rp, 3, 1, 0, 0);
+            glm::ivec2 groups = (m_renderSize + 7) / 8;
+            GPU::dispatchCompute(pass, groups.x, groups.y, 1);
         }
-        SDL_EndGPURenderPass(rp);
+        GPU::endComputePass(pass);
+    }
+
+    if (!m_bloomDownPipeline || !m_bloomBuffer)
+        return;
+
+    glm::ivec2 maxGroups = getBloomGroups(m_targetSize);
+    if (!m_bloomBufferCleared)
+    {
+        clearBuffer(commandBuffer, m_bloomBuffer, (Uint32)(maxGroups.x * maxGroups.y * sizeof(Uint32)));
+        m_bloomBufferCleared = true;
+    }
+
+    // Mips 1 to 4 in one dispatch, groups filter mip 4 once their neighbours are done
+    SDL_GPUStorageTextureReadWriteBinding mips[BLOOM_MIPS] = {};
+    for (int i = 0; i < BLOOM_MIPS; i++)
+    {
+        mips[i].texture = m_bloomTexture;
+        mips[i].mip_level = i;
+    }
+
+    SDL_GPUStorageBufferReadWriteBinding buffer{};
+    buffer.buffer = m_bloomBuffer;
 
-        // SDL_GenerateMipmapsForGPUTexture(commandBuffer, rt.texture);
+    m_downsampleUBO.texelOffset = maxGroups.x * maxGroups.y;
+    m_downsampleUBO.groupCount = getBloomGroups(m_renderSize);
 
-        src = m_bloomMip[i]; // next mip uses this one
+    SDL_GPUComputePass *pass = GPU::beginComputePass(commandBuffer, mips, BLOOM_MIPS, &buffer, 1);
+    {
+        GPU::bindComputePipeline(pass, m_bloomDownPipeline);
+        GPU::pushComputeUniformData(commandBuffer, 0, &m_downsampleUBO, sizeof(m_downsampleUBO));
+        GPU::dispatchCompute(pass, m_downsampleUBO.groupCount.x, m_downsampleUBO.groupCount.y, 1);
     }
+    GPU::endComputePass(pass);
 }
 
 void PostProcess::upsample(SDL_GPUCommandBuffer *commandBuffer)
 {
+    // Tent filter each mip and add it into the next bigger one, passes order the reads after the writes
     for (int i = BLOOM_MIPS - 1; i > 0; i--)
     {
-        SDL_GPUColorTargetInfo rt{};
-        rt.texture = m_bloomMip[i - 1];   // write to next bigger mip
-        rt.load_op = SDL_GPU_LOADOP_LOAD; // keep existing bloom
-        rt.store_op = SDL_GPU_STOREOP_STORE;
-
-        SDL_GPURenderPass *rp = SDL_BeginGPURenderPass(commandBuffer, &rt, 1, nullptr);
-        {
-            SDL_BindGPUGraphicsPipeline(rp, m_bloomUpPipeline);
+        SDL_GPUStorageTextureReadWriteBinding mips[2] = {};
+        mips[0].texture = m_bloomTexture;
+        mips[0].mip_level = i - 1;
+        mips[1].texture = m_bloomTexture;
+        mips[1].mip_level = i;
 
-            SDL_PushGPUFragmentUniformData(commandBuffer, 0, &m_upsampleUBO, sizeof(m_upsampleUBO));
+        m_upsampleUBO.dstSize = glm::max(m_renderSize >> (i - 1), glm::ivec2(1));
+        m_upsampleUBO.srcSize = glm::max(m_renderSize >> i, glm::ivec2(1));
 
-            SDL_GPUTextureSamplerBinding bind = {m_bloomMip[i], m_clampedSampler};
-            SDL_BindGPUFragmentSamplers(rp, 0, &bind, 1);
+        SDL_GPUComputePass *pass = GPU::beginComputePass(commandBuffer, mips, 2, nullptr, 0);
+        {
+            GPU::bindComputePipeline(pass, m_bloomUpPipeline);
+            GPU::pushComputeUniformData(commandBuffer, 0, &m_upsampleUBO, sizeof(m_upsampleUBO));
 
-            SDL_DrawGPUPrimitives(rp, 3, 1, 0, 0);
+            glm::ivec2 groups = (m_upsampleUBO.dstSize + 7) / 8;
+            GPU::dispatchCompute(pass, groups.x, groups.y, 1);
         }
-        SDL_EndGPURenderPass(rp);
-
-        // SDL_GenerateMipmapsForGPUTexture(commandBuffer, rt.texture);
+        GPU::endComputePass(pass);
     }
 }
 
@@ -674,26 +977,75 @@ void PostProcess::resolveDepth(SDL_GPUCommandBuffer *cmd)
 {
     SDL_GPUColorTargetInfo target{};
     target.texture = m_depthTexture;
-    target.clear_color = {0, 0, 0, 0};
+    // texels outside the render region read as far plane
+    target.clear_color = {1, 0, 0, 0};
     target.load_op = SDL_GPU_LOADOP_CLEAR;
     target.store_op = SDL_GPU_STOREOP_STORE;
 
-    SDL_GPURenderPass *pass = SDL_BeginGPURenderPass(cmd, &target, 1, nullptr);
+    SDL_GPURenderPass *pass = GPU::beginRenderPass(cmd, &target, 1, nullptr);
+    bindRenderViewport(cmd, pass);
 
     if (m_sampleCount == SDL_GPU_SAMPLECOUNT_1)
-        SDL_BindGPUGraphicsPipeline(pass, m_depthCopyPipeline);
+        GPU::bindGraphicsPipeline(pass, m_depthCopyPipeline);
     else
-        SDL_BindGPUGraphicsPipeline(pass, m_depthResolvePipeline);
+        GPU::bindGraphicsPipeline(pass, m_depthResolvePipeline);
 
     SDL_GPUTextureSamplerBinding binding{};
     binding.texture = m_msaaDepthTexture;
     binding.sampler = m_clampedSampler;
 
-    SDL_BindGPUFragmentSamplers(pass, 0, &binding, 1);
+    GPU::bindFragmentSamplers(pass, 0, &binding, 1);
 
-    SDL_DrawGPUPrimitives(pass, 3, 1, 0, 0);
+    GPU::drawPrimitives(pass, 3, 1, 0, 0);
 
     SDL_EndGPURenderPass(pass);
+
+    buildHiZ(cmd);
+}
+
+glm::ivec2 PostProcess::getHiZRegion(int level) const
+{
+    int scale = 2 << level;
+    return glm::max((m_renderSize + scale - 1) / scale, glm::ivec2(1));
+}
+
+void PostProcess::buildHiZ(SDL_GPUCommandBuffer *commandBuffer)
+{
+    if (!m_hiZPipeline || !m_hiZTexture || !m_hiZBuffer)
+        return;
+
+    // The shader resets the group counter itself
+    if (!m_hiZBufferCleared)
+    {
+        clearBuffer(commandBuffer, m_hiZBuffer, 16);
+        m_hiZBufferCleared = true;
+    }
+
+    SDL_GPUStorageTextureReadWriteBinding mips[HIZ_MIPS] = {};
+    for (int i = 0; i < HIZ_MIPS; i++)
+    {
+        mips[i].texture = m_hiZTexture;
+        mips[i].mip_level = i;
+    }
+
+    SDL_GPUStorageBufferReadWriteBinding buffer{};
+    buffer.buffer = m_hiZBuffer;
+
+    SDL_GPUComputePass *pass = GPU::beginComputePass(commandBuffer, mips, HIZ_MIPS, &buffer, 1);
+    {
+        GPU::bindComputePipeline(pass, m_hiZPipeline);
+
+        SDL_GPUTextureSamplerBinding depth = {m_depthTexture, m_clampedSampler};
+        GPU::bindComputeSamplers(pass, 0, &depth, 1);
+
+        HiZUniforms uniforms{};
+        uniforms.depthSize = m_renderSize;
+        uniforms.groupCount = getHiZRegion(5);
+        GPU::pushComputeUniformData(commandBuffer, 0, &uniforms, sizeof(uniforms));
+
+        GPU::dispatchCompute(pass, uniforms.groupCount.x, uniforms.groupCount.y, 1);
+    }
+    GPU::endComputePass(pass);
 }
 
 void PostProcess::computeGTAO(
@@ -705,11 +1057,18 @@ void PostProcess::computeGTAO(
 {
     glm::mat4 invProj = glm::inverse(projectionMatrix);
 
+    // Resolution of the rendered region, the shader works in screen uv
+    glm::ivec2 gtaoRenderSize = glm::clamp(
+        glm::ivec2(glm::vec2(m_renderSize) * m_gtaoResolutionFactor),
+        glm::ivec2(1),
+        m_gtaoSize);
+
     m_gtaoParams.resolution = glm::vec4(
-        m_UBO.screenSize.x * m_gtaoResolutionFactor,
-        m_UBO.screenSize.y * m_gtaoResolutionFactor,
-        1.0f / (m_UBO.screenSize.x * m_gtaoResolutionFactor),
-        1.0f / (m_UBO.screenSize.y * m_gtaoResolutionFactor));
+        gtaoRenderSize.x,
+        gtaoRenderSize.y,
+        1.0f / gtaoRenderSize.x,
+        1.0f / gtaoRenderSize.y);
+    m_gtaoParams.uvScale = glm::vec2(gtaoRenderSize) / glm::vec2(m_gtaoSize);
 
     m_gtaoParams.positionParams = glm::vec2(
         invProj[0][0],
@@ -728,8 +1087,58 @@ void PostProcess::computeGTAO(
 
     m_gtaoParams.nearPlane = nearPlane;
     m_gtaoParams.farPlane = farPlane;
+    m_gtaoParams.maxLevel = GTAO_DEPTH_MIPS - 1;
+    m_gtaoParams.frameIndex++;
+
+    // History is reprojected with the camera, a resized AO region cannot be reused
+    if (gtaoRenderSize != m_gtaoLastRenderSize)
+        m_gtaoHistoryValid = false;
+
+    m_gtaoTemporal.reprojection = m_gtaoPrevViewProjection * glm::inverse(viewMatrix);
+    m_gtaoTemporal.resolution = glm::vec4(glm::vec2(gtaoRenderSize), 1.f / glm::vec2(m_gtaoSize));
+    m_gtaoTemporal.positionParams = m_gtaoParams.positionParams;
+    m_gtaoTemporal.farPlane = farPlane;
+    m_gtaoTemporal.historyValid = m_gtaoHistoryValid ? 1 : 0;
+
+    m_gtaoPrevViewProjection = projectionMatrix * viewMatrix;
+    m_gtaoLastRenderSize = gtaoRenderSize;
+
+    m_gtaoUpsample.renderSize = m_renderSize;
+    m_gtaoUpsample.gtaoRenderSize = gtaoRenderSize;
+    m_gtaoUpsample.nearPlane = nearPlane;
+    m_gtaoUpsample.farPlane = farPlane;
+    m_gtaoUpsample.radius = m_gtaoParams.radius;
+
+    // Start the pyramid from the Hi-Z level closest to the AO resolution, full resolution AO has none
+    m_gtaoUpsample.hizLevel = std::min(
+        (int)std::floor(std::log2(1.f / m_gtaoResolutionFactor) + 1e-3f) - 1,
+        HIZ_MIPS - 1);
+
+    if (!m_gtaoTileReset)
+    {
+        SDL_GPUTransferBufferCreateInfo resetInfo{};
+        resetInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+        resetInfo.size = sizeof(SDL_GPUIndirectDispatchCommand);
+        m_gtaoTileReset = GPU::createTransferBuffer(Utils::device, &resetInfo);
+
+        SDL_GPUIndirectDispatchCommand *reset =
+            (SDL_GPUIndirectDispatchCommand *)SDL_MapGPUTransferBuffer(Utils::device, m_gtaoTileReset, false);
+        if (reset)
+        {
+            *reset = {0, 1, 1};
+            SDL_UnmapGPUTransferBuffer(Utils::device, m_gtaoTileReset);
+        }
+    }
+
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(commandBuffer);
+    {
+        SDL_GPUTransferBufferLocation source{m_gtaoTileReset, 0};
+        SDL_GPUBufferRegion destination{m_gtaoTileBuffer, 0, sizeof(SDL_GPUIndirectDispatchCommand)};
+        GPU::uploadToBuffer(copyPass, &source, &destination, false);
+    }
 
-    // update mask texture
+    // The mask is usually redrawn identically every frame, upload only when it changed
+    if (m_gtaoMask.isDirty())
     {
         // 1. Create a Transfer Buffer (Staging buffer)
         Uint32 dataSize = m_gtaoMask.getDataSize();
@@ -738,7 +1147,7 @@ void PostProcess::computeGTAO(
         transferInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
         transferInfo.size = dataSize;
 
-        SDL_GPUTransferBuffer *transferBuffer = SDL_CreateGPUTransferBuffer(Utils::device, &transferInfo);
+        SDL_GPUTransferBuffer *transferBuffer = GPU::createTransferBuffer(Utils::device, &transferInfo);
 
         // 2. Map memory and copy CPU data
         Uint8 *mapData = (Uint8 *)SDL_MapGPUTransferBuffer(Utils::device, transferBuffer, false);
@@ -762,126 +1171,164 @@ void PostProcess::computeGTAO(
         destination.d = 1;
 
         // 4. Record the upload command
-        SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(commandBuffer);
-        SDL_UploadToGPUTexture(copyPass, &source, &destination, false);
-        SDL_EndGPUCopyPass(copyPass);
+        GPU::uploadToTexture(copyPass, &source, &destination, false, SDL_GPU_TEXTUREFORMAT_R8_UNORM);
 
         // 5. Cleanup
         // SDL3 tracks the buffer usage, so we can release the handle immediately
         // and the driver will destroy it after the command buffer finishes.
-        SDL_ReleaseGPUTransferBuffer(Utils::device, transferBuffer);
+        GPU::releaseTransferBuffer(Utils::device, transferBuffer);
+        m_gtaoMask.markUploaded();
     }
+    SDL_EndGPUCopyPass(copyPass);
 
-    // 1. GTAO Generation Pass
-    SDL_GPUColorTargetInfo genTarget{};
-    genTarget.texture = m_gtaoRawTexture;
-    genTarget.load_op = SDL_GPU_LOADOP_CLEAR;
-    genTarget.store_op = SDL_GPU_STOREOP_STORE;
+    SDL_GPUStorageTextureReadWriteBinding output{};
 
-    SDL_GPURenderPass *genPass = SDL_BeginGPURenderPass(commandBuffer, &genTarget, 1, nullptr);
+    // 1. Linear depth pyramid at AO resolution
+    SDL_GPUStorageTextureReadWriteBinding depthMips[GTAO_DEPTH_MIPS] = {};
+    for (int i = 0; i < GTAO_DEPTH_MIPS; i++)
     {
-        SDL_BindGPUGraphicsPipeline(genPass, m_gtaoGenPipeline);
+        depthMips[i].texture = m_gtaoDepthTexture;
+        depthMips[i].mip_level = i;
+    }
 
-        SDL_GPUTextureSamplerBinding textures[2] = {
+    SDL_GPUComputePass *depthPass = GPU::beginComputePass(commandBuffer, depthMips, GTAO_DEPTH_MIPS, nullptr, 0);
+    {
+        GPU::bindComputePipeline(depthPass, m_gtaoDepthPipeline);
+
+        SDL_GPUTextureSamplerBinding depth[] = {
             {m_depthTexture, m_clampedSampler},
-            {m_gtaoMaskTexture, m_clampedSampler},
+            {m_hiZTexture, m_clampedSampler},
         };
-        SDL_BindGPUFragmentSamplers(genPass, 0, textures, 2);
+        GPU::bindComputeSamplers(depthPass, 0, depth, 2);
+        GPU::pushComputeUniformData(commandBuffer, 0, &m_gtaoUpsample, sizeof(m_gtaoUpsample));
 
-        // Push GTAO parameters
-        SDL_PushGPUFragmentUniformData(commandBuffer, 0, &m_gtaoParams, sizeof(m_gtaoParams));
+        // 16x16 mip 0 texels per group, the smaller mips reduce in shared memory
+        glm::ivec2 groups = (gtaoRenderSize + 15) / 16;
+        GPU::dispatchCompute(depthPass, groups.x, groups.y, 1);
+    }
+    GPU::endComputePass(depthPass);
+
+    SDL_GPUTextureSamplerBinding depthAndMask[2] = {
+        {m_gtaoDepthTexture, m_clampedSampler},
+        {m_gtaoMaskTexture, m_clampedSampler},
+    };
+
+    // 2. Tile classification, sky and masked out tiles are resolved straight into the history
+    int next = 1 - m_gtaoHistoryIndex;
+    output.texture = m_gtaoHistory[next];
+    SDL_GPUStorageBufferReadWriteBinding tiles{};
+    tiles.buffer = m_gtaoTileBuffer;
+    SDL_GPUComputePass *classifyPass = GPU::beginComputePass(commandBuffer, &output, 1, &tiles, 1);
+    {
+        GPU::bindComputePipeline(classifyPass, m_gtaoClassifyPipeline);
+        GPU::bindComputeSamplers(classifyPass, 0, depthAndMask, 2);
+        GPU::pushComputeUniformData(commandBuffer, 0, &m_gtaoParams, sizeof(m_gtaoParams));
 
-        SDL_DrawGPUPrimitives(genPass, 3, 1, 0, 0);
+        glm::ivec2 groups = (gtaoRenderSize + 7) / 8;
+        GPU::dispatchCompute(classifyPass, groups.x, groups.y, 1);
     }
-    SDL_EndGPURenderPass(genPass);
+    GPU::endComputePass(classifyPass);
 
-    struct BlurFragUBO
+    // 3. GTAO slices, rotated every frame
+    output.texture = m_gtaoRawTexture;
+    SDL_GPUComputePass *genPass = GPU::beginComputePass(commandBuffer, &output, 1, nullptr, 0);
     {
-        glm::vec2 invResolutionDirection;
-        float sharpness;
-        float padding0;
-    } ubo;
-
-    // 2. GTAO Blur
-
-    // Pass 1: Horizontal blur (raw → blur temp)
-    SDL_GPUColorTargetInfo blurTarget1{};
-    blurTarget1.texture = m_gtaoBlur0Texture; // temp target
-    blurTarget1.load_op = SDL_GPU_LOADOP_CLEAR;
-    blurTarget1.store_op = SDL_GPU_STOREOP_STORE;
-    SDL_GPURenderPass *blurPass1 = SDL_BeginGPURenderPass(commandBuffer, &blurTarget1, 1, nullptr);
+        GPU::bindComputePipeline(genPass, m_gtaoGenPipeline);
+        GPU::bindComputeSamplers(genPass, 0, depthAndMask, 2);
+        GPU::bindComputeStorageBuffers(genPass, 0, &m_gtaoTileBuffer, 1);
+        GPU::pushComputeUniformData(commandBuffer, 0, &m_gtaoParams, sizeof(m_gtaoParams));
+
+        GPU::dispatchComputeIndirect(genPass, m_gtaoTileBuffer, 0);
+    }
+    GPU::endComputePass(genPass);
+
+    // 4. Temporal accumulation over the same tiles
+    output.texture = m_gtaoHistory[next];
+    SDL_GPUComputePass *temporalPass = GPU::beginComputePass(commandBuffer, &output, 1, nullptr, 0);
     {
-        SDL_BindGPUGraphicsPipeline(blurPass1, m_gtaoBlurPipeline);
-        SDL_GPUTextureSamplerBinding input[1] = {{m_gtaoRawTexture, m_clampedSampler}};
-        SDL_BindGPUFragmentSamplers(blurPass1, 0, input, 1);
-
-        BlurFragUBO ubo;
-        ubo.sharpness = 40.f;
-        ubo.invResolutionDirection = glm::vec2(1.f / m_gtaoParams.resolution.x, 0.f);
-        SDL_PushGPUFragmentUniformData(commandBuffer, 0, &ubo, sizeof(ubo));
-        SDL_DrawGPUPrimitives(blurPass1, 3, 1, 0, 0);
+        GPU::bindComputePipeline(temporalPass, m_gtaoTemporalPipeline);
+
+        SDL_GPUTextureSamplerBinding textures[2] = {
+            {m_gtaoRawTexture, m_clampedSampler},
+            {m_gtaoHistory[m_gtaoHistoryIndex], m_clampedSampler},
+        };
+        GPU::bindComputeSamplers(temporalPass, 0, textures, 2);
+        GPU::bindComputeStorageBuffers(temporalPass, 0, &m_gtaoTileBuffer, 1);
+        GPU::pushComputeUniformData(commandBuffer, 0, &m_gtaoTemporal, sizeof(m_gtaoTemporal));
+
+        GPU::dispatchComputeIndirect(temporalPass, m_gtaoTileBuffer, 0);
     }
-    SDL_EndGPURenderPass(blurPass1);
-
-    // Pass 2: Vertical blur (blur temp → final output)
-    SDL_GPUColorTargetInfo blurTarget2{};
-    blurTarget2.texture = m_gtaoBlur1Texture; // your final output texture
-    blurTarget2.load_op = SDL_GPU_LOADOP_CLEAR;
-    blurTarget2.store_op = SDL_GPU_STOREOP_STORE;
-    SDL_GPURenderPass *blurPass2 = SDL_BeginGPURenderPass(commandBuffer, &blurTarget2, 1, nullptr);
+    GPU::endComputePass(temporalPass);
+
+    m_gtaoHistoryIndex = next;
+    m_gtaoHistoryValid = true;
+
+    // 5. Depth aware upsample to the target resolution, sky pixels exit after one depth fetch
+    output.texture = m_gtaoTexture;
+    SDL_GPUComputePass *upsamplePass = GPU::beginComputePass(commandBuffer, &output, 1, nullptr, 0);
     {
-        SDL_BindGPUGraphicsPipeline(blurPass2, m_gtaoBlurPipeline);
-        SDL_GPUTextureSamplerBinding input[1] = {{m_gtaoBlur0Texture, m_clampedSampler}};
-        SDL_BindGPUFragmentSamplers(blurPass2, 0, input, 1);
-
-        BlurFragUBO ubo;
-        ubo.sharpness = 40.f;
-        ubo.invResolutionDirection = glm::vec2(0.f, 1.f / m_gtaoParams.resolution.y);
-        SDL_PushGPUFragmentUniformData(commandBuffer, 0, &ubo, sizeof(ubo));
-        SDL_DrawGPUPrimitives(blurPass2, 3, 1, 0, 0);
+        GPU::bindComputePipeline(upsamplePass, m_gtaoUpsamplePipeline);
+
+        SDL_GPUTextureSamplerBinding textures[2] = {
+            {m_depthTexture, m_clampedSampler},
+            {m_gtaoHistory[m_gtaoHistoryIndex], m_clampedSampler},
+        };
+        GPU::bindComputeSamplers(upsamplePass, 0, textures, 2);
+        GPU::pushComputeUniformData(commandBuffer, 0, &m_gtaoUpsample, sizeof(m_gtaoUpsample));
+
+        glm::ivec2 groups = (m_renderSize + 7) / 8;
+        GPU::dispatchCompute(upsamplePass, groups.x, groups.y, 1);
     }
-    SDL_EndGPURenderPass(blurPass2);
+    GPU::endComputePass(upsamplePass);
 }
 
-void PostProcess::runSMAA(SDL_GPUCommandBuffer *cmd)
+void PostProcess::runSMAA(SDL_GPUCommandBuffer *cmd, const SDL_GPUColorTargetInfo &edgeTarget, const SDL_GPUColorTargetInfo &blendTarget, const SDL_GPUColorTargetInfo &colorTarget)
 {
     if (m_aaMode != AA_SMAA)
         return;
 
-    if (!m_colorTexture || !m_smaaEdgeTex || !m_smaaBlendTex || !m_smaaColorTex)
+    if (!m_colorTexture || !m_smaaEdgeTex || !m_smaaBlendTex || !m_smaaColorTex || !m_smaaStencilTex)
         return;
 
     // Push SMAA_RT_METRICS
-    SDL_PushGPUFragmentUniformData(cmd, 0, &m_smaaUniforms, sizeof(m_smaaUniforms));
+    GPU::pushFragmentUniformData(cmd, 0, &m_smaaUniforms, sizeof(m_smaaUniforms));
 
     // --- 1) Edge detection ---
-    SDL_GPUColorTargetInfo edgeTarget{};
-    edgeTarget.texture = m_smaaEdgeTex;
-    edgeTarget.load_op = SDL_GPU_LOADOP_CLEAR;
-    edgeTarget.store_op = SDL_GPU_STOREOP_STORE;
-    edgeTarget.clear_color = {0, 0, 0, 0};
-
-    SDL_GPURenderPass *edgePass = SDL_BeginGPURenderPass(cmd, &edgeTarget, 1, nullptr);
+    SDL_GPUDepthStencilTargetInfo edgeStencil{};
+    edgeStencil.texture = m_smaaStencilTex;
+    edgeStencil.load_op = SDL_GPU_LOADOP_DONT_CARE;
+    edgeStencil.store_op = SDL_GPU_STOREOP_DONT_CARE;
+    edgeStencil.stencil_load_op = SDL_GPU_LOADOP_CLEAR;
+    edgeStencil.stencil_store_op = SDL_GPU_STOREOP_STORE;
+    edgeStencil.clear_stencil = 0;
+
+    SDL_GPURenderPass *edgePass = GPU::beginRenderPass(cmd, &edgeTarget, 1, &edgeStencil);
     {
-        SDL_BindGPUGraphicsPipeline(edgePass, m_smaaEdgePipeline);
+        bindRenderViewport(cmd, edgePass);
+        GPU::bindGraphicsPipeline(edgePass, m_smaaEdgePipeline);
+        GPU::setStencilReference(edgePass, 1);
 
         // IMPORTANT: for best results the input read for the color/luma edge detection should *NOT* be sRGB.
         SDL_GPUTextureSamplerBinding colorBind{m_colorTexture, m_smaaLutSampler};
-        SDL_BindGPUFragmentSamplers(edgePass, 0, &colorBind, 1);
-        SDL_DrawGPUPrimitives(edgePass, 3, 1, 0, 0);
+        GPU::bindFragmentSamplers(edgePass, 0, &colorBind, 1);
+        GPU::drawPrimitives(edgePass, 3, 1, 0, 0);
     }
     SDL_EndGPURenderPass(edgePass);
 
     // --- 2) Blend weight calculation ---
-    SDL_GPUColorTargetInfo blendTarget{};
-    blendTarget.texture = m_smaaBlendTex;
-    blendTarget.load_op = SDL_GPU_LOADOP_CLEAR;
-    blendTarget.store_op = SDL_GPU_STOREOP_STORE;
-    blendTarget.clear_color = {0, 0, 0, 0};
-
-    SDL_GPURenderPass *blendPass = SDL_BeginGPURenderPass(cmd, &blendTarget, 1, nullptr);
+    // Pixels without an edge keep the cleared zero weights
+    SDL_GPUDepthStencilTargetInfo blendStencil{};
+    blendStencil.texture = m_smaaStencilTex;
+    blendStencil.load_op = SDL_GPU_LOADOP_DONT_CARE;
+    blendStencil.store_op = SDL_GPU_STOREOP_DONT_CARE;
+    blendStencil.stencil_load_op = SDL_GPU_LOADOP_LOAD;
+    blendStencil.stencil_store_op = SDL_GPU_STOREOP_DONT_CARE;
+
+    SDL_GPURenderPass *blendPass = GPU::beginRenderPass(cmd, &blendTarget, 1, &blendStencil);
     {
-        SDL_BindGPUGraphicsPipeline(blendPass, m_smaaBlendPipeline);
+        bindRenderViewport(cmd, blendPass);
+        GPU::bindGraphicsPipeline(blendPass, m_smaaBlendPipeline);
+        GPU::setStencilReference(blendPass, 1);
 
         SDL_GPUTextureSamplerBinding samplers[3] =
             {
@@ -889,65 +1336,137 @@ void PostProcess::runSMAA(SDL_GPUCommandBuffer *cmd)
                 {m_smaaAreaTex, m_smaaLutSampler},   // area LUT
                 {m_smaaSearchTex, m_smaaLutSampler}, // search LUT
             };
-        SDL_BindGPUFragmentSamplers(blendPass, 0, samplers, 3);
+        GPU::bindFragmentSamplers(blendPass, 0, samplers, 3);
 
-        SDL_DrawGPUPrimitives(blendPass, 3, 1, 0, 0);
+        GPU::drawPrimitives(blendPass, 3, 1, 0, 0);
     }
     SDL_EndGPURenderPass(blendPass);
 
     // --- 3) Neighborhood blending ---
-    SDL_GPUColorTargetInfo colorTarget{};
-    colorTarget.texture = m_smaaColorTex;
-    colorTarget.load_op = SDL_GPU_LOADOP_CLEAR;
-    colorTarget.store_op = SDL_GPU_STOREOP_STORE;
-    colorTarget.clear_color = {0, 0, 0, 0};
-
-    SDL_GPURenderPass *neighborPass = SDL_BeginGPURenderPass(cmd, &colorTarget, 1, nullptr);
+    SDL_GPURenderPass *neighborPass = GPU::beginRenderPass(cmd, &colorTarget, 1, nullptr);
     {
-        SDL_BindGPUGraphicsPipeline(neighborPass, m_smaaNeighborPipeline);
+        bindRenderViewport(cmd, neighborPass);
+        GPU::bindGraphicsPipeline(neighborPass, m_smaaNeighborPipeline);
 
         SDL_GPUTextureSamplerBinding samplers[2] =
             {
                 {m_colorTexture, m_smaaLutSampler},
                 {m_smaaBlendTex, m_smaaLutSampler},
             };
-        SDL_BindGPUFragmentSamplers(neighborPass, 0, samplers, 2);
+        GPU::bindFragmentSamplers(neighborPass, 0, samplers, 2);
 
-        SDL_DrawGPUPrimitives(neighborPass, 3, 1, 0, 0);
+        GPU::drawPrimitives(neighborPass, 3, 1, 0, 0);
     }
     SDL_EndGPURenderPass(neighborPass);
 }
 
-void PostProcess::postProcess(SDL_GPUCommandBuffer *commandBuffer, SDL_GPUTexture *swapchainTexture, glm::vec2 swapchainSize)
+void PostProcess::runTAA(SDL_GPUCommandBuffer *cmd, const SDL_GPUColorTargetInfo &target, const glm::mat4 &viewProjection, const glm::mat4 &prevViewProjection)
 {
-    // 1: Render Post-Process effects to Intermediate Texture
+    if (m_aaMode != AA_TAA)
+        return;
+
+    if (!m_colorTexture || !m_velocityTexture || !m_taaHistory[0] || !m_taaHistory[1])
+        return;
+
+    int next = 1 - m_taaHistoryIndex;
 
-    SDL_GPUColorTargetInfo intermediateTarget{};
-    intermediateTarget.texture = m_intermediateTexture;
-    intermediateTarget.load_op = SDL_GPU_LOADOP_DONT_CARE;
-    intermediateTarget.store_op = SDL_GPU_STOREOP_STORE;
-    intermediateTarget.clear_color = {0.f, 0.f, 0.f, 1.f};
+    m_taaUniforms.reprojection = prevViewProjection * glm::inverse(viewProjection);
+    m_taaUniforms.renderSize = glm::vec4(glm::vec2(m_renderSize), 1.f / glm::vec2(m_targetSize));
+    m_taaUniforms.uvScale = m_fullscreenUBO.uvScale;
+    m_taaUniforms.jitter = m_jitter * glm::vec2(0.5f, -0.5f);
+    m_taaUniforms.historyValid = m_taaHistoryValid ? 1 : 0;
+
+    SDL_GPURenderPass *pass = GPU::beginRenderPass(cmd, &target, 1, nullptr);
+    {
+        // Resolve at display resolution, the render region is upsampled in the shader
+        bindViewport(cmd, pass, m_screenSize);
+        GPU::bindGraphicsPipeline(pass, m_taaPipeline);
+
+        SDL_GPUTextureSamplerBinding samplers[4] =
+            {
+                {m_colorTexture, m_smaaLutSampler},
+                {m_velocityTexture, m_smaaLutSampler},
+                {m_depthTexture, m_smaaLutSampler},
+                {m_taaHistory[m_taaHistoryIndex], m_smaaLutSampler},
+            };
+        GPU::bindFragmentSamplers(pass, 0, samplers, 4);
+        GPU::pushFragmentUniformData(cmd, 0, &m_taaUniforms, sizeof(m_taaUniforms));
+
+        GPU::drawPrimitives(pass, 3, 1, 0, 0);
+    }
+    SDL_EndGPURenderPass(pass);
+
+    m_taaHistoryIndex = next;
+    m_taaHistoryValid = true;
+}
+
+void PostProcess::runUpscale(SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *source, const SDL_GPUColorTargetInfo &target)
+{
+    m_upscaleUniforms.sizes = glm::vec4(glm::vec2(m_renderSize), glm::vec2(m_screenSize));
+
+    SDL_GPURenderPass *pass = GPU::beginRenderPass(cmd, &target, 1, nullptr);
+    {
+        bindViewport(cmd, pass, m_screenSize);
+        GPU::bindGraphicsPipeline(pass, m_easuPipeline);
+
+        SDL_GPUTextureSamplerBinding binding{source, m_smaaLutSampler};
+        GPU::bindFragmentSamplers(pass, 0, &binding, 1);
+        GPU::pushFragmentUniformData(cmd, 0, &m_upscaleUniforms, sizeof(m_upscaleUniforms));
+
+        GPU::drawPrimitives(pass, 3, 1, 0, 0);
+    }
+    SDL_EndGPURenderPass(pass);
+}
+
+void PostProcess::runSharpen(SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *source, const SDL_GPUColorTargetInfo &target)
+{
+    // Sharpening only runs on a display resolution image
+    m_upscaleUniforms.sizes = glm::vec4(glm::vec2(m_screenSize), glm::vec2(m_screenSize));
+
+    SDL_GPURenderPass *pass = GPU::beginRenderPass(cmd, &target, 1, nullptr);
+    {
+        bindViewport(cmd, pass, m_screenSize);
+        GPU::bindGraphicsPipeline(pass, m_rcasPipeline);
+
+        SDL_GPUTextureSamplerBinding binding{source, m_smaaLutSampler};
+        GPU::bindFragmentSamplers(pass, 0, &binding, 1);
+        GPU::pushFragmentUniformData(cmd, 0, &m_upscaleUniforms, sizeof(m_upscaleUniforms));
+
+        GPU::drawPrimitives(pass, 3, 1, 0, 0);
+    }
+    SDL_EndGPURenderPass(pass);
+}
+
+void PostProcess::postProcess(SDL_GPUCommandBuffer *commandBuffer, const SDL_GPUColorTargetInfo &intermediateTarget, SDL_GPUTexture *swapchainTexture, glm::vec2 swapchainSize)
+{
+    // 1: Render Post-Process effects to Intermediate Texture
 
     SDL_GPUTexture *color = m_colorTexture;
-    if (m_aaMode == AA_SMAA)
+    if (m_sceneOutput)
+        color = m_sceneOutput;
+    else if (m_aaMode == AA_SMAA)
         color = m_smaaColorTex;
+    m_UBO.sceneFullRes = m_sceneOutput ? 1 : 0;
 
-    SDL_GPURenderPass *intermediatePass = SDL_BeginGPURenderPass(commandBuffer, &intermediateTarget, 1, nullptr);
+    SDL_GPURenderPass *intermediatePass = GPU::beginRenderPass(commandBuffer, &intermediateTarget, 1, nullptr);
     {
-        SDL_BindGPUGraphicsPipeline(intermediatePass, m_postProcessPipeline);
+        GPU::bindGraphicsPipeline(intermediatePass, m_postProcessPipeline);
+
+        // Full output viewport, the scaled uv upsamples the render region
+        GPU::pushVertexUniformData(commandBuffer, 0, &m_fullscreenUBO, sizeof(m_fullscreenUBO));
 
         SDL_GPUTextureSamplerBinding inputs[4] =
             {
                 {color, Utils::baseSampler},
-                {m_bloomMip[0], Utils::baseSampler},
-                {m_gtaoBlur1Texture, Utils::baseSampler},
+                {m_bloomTexture, Utils::baseSampler},
+                {m_gtaoTexture, Utils::baseSampler},
                 {m_lutTex, m_smaaLutSampler},
             };
-        SDL_BindGPUFragmentSamplers(intermediatePass, 0, inputs, 4);
+        GPU::bindFragmentSamplers(intermediatePass, 0, inputs, 4);
 
-        SDL_PushGPUFragmentUniformData(commandBuffer, 0, &m_UBO, sizeof(m_UBO));
+        GPU::pushFragmentUniformData(commandBuffer, 0, &m_UBO, sizeof(m_UBO));
 
-        SDL_DrawGPUPrimitives(intermediatePass, 3, 1, 0, 0);
+        GPU::drawPrimitives(intermediatePass, 3, 1, 0, 0);
     }
     SDL_EndGPURenderPass(intermediatePass);
 
@@ -955,8 +1474,8 @@ void PostProcess::postProcess(SDL_GPUCommandBuffer *commandBuffer, SDL_GPUTextur
 
     SDL_GPUBlitInfo blitInfo{};
     blitInfo.source.texture = m_intermediateTexture;
-    blitInfo.source.w = m_UBO.screenSize.x;
-    blitInfo.source.h = m_UBO.screenSize.y;
+    blitInfo.source.w = m_screenSize.x;
+    blitInfo.source.h = m_screenSize.y;
 
     blitInfo.destination.texture = swapchainTexture;
     blitInfo.destination.w = swapchainSize.x;
@@ -965,7 +1484,143 @@ void PostProcess::postProcess(SDL_GPUCommandBuffer *commandBuffer, SDL_GPUTextur
     blitInfo.filter = SDL_GPU_FILTER_LINEAR;
     blitInfo.load_op = SDL_GPU_LOADOP_DONT_CARE;
 
-    SDL_BlitGPUTexture(commandBuffer, &blitInfo);
+    GPU::blitTexture(commandBuffer, &blitInfo);
+}
+
+void PostProcess::addPasses(RenderGraph &graph, const PostProcessFrame &frame)
+{
+    const bool smaa = m_aaMode == AA_SMAA;
+    const bool taa = m_aaMode == AA_TAA;
+    const bool easu = !taa && m_upscaleMode == UPSCALE_EASU;
+    const bool sharpen = (taa || easu) && m_sharpenEnabled;
+
+    // Anything left from a previous frame may have gone back to the pool
+    m_intermediateTexture = nullptr;
+    m_bloomTexture = nullptr;
+    m_gtaoDepthTexture = nullptr;
+    m_gtaoRawTexture = nullptr;
+    m_gtaoTexture = nullptr;
+    m_smaaEdgeTex = nullptr;
+    m_smaaBlendTex = nullptr;
+    m_smaaColorTex = nullptr;
+    m_smaaStencilTex = nullptr;
+
+    const SDL_GPUTextureUsageFlags targetUsage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
+    const SDL_GPUTextureUsageFlags storageUsage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_WRITE;
+
+    RGTextureDesc hdrDesc{SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, m_targetSize, 1, targetUsage};
+    RGTextureDesc displayDesc{SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, m_screenSize, 1, targetUsage};
+
+    // GTAO
+    RGTexture gtaoDepth = graph.createTexture(
+        "GTAO Depth", {SDL_GPU_TEXTUREFORMAT_R32_FLOAT, m_gtaoSize, GTAO_DEPTH_MIPS, storageUsage});
+    RGTexture gtaoRaw = graph.createTexture("GTAO Raw", {SDL_GPU_TEXTUREFORMAT_R16G16_FLOAT, m_gtaoSize, 1, storageUsage});
+    RGTexture gtao = graph.createTexture("GTAO", {SDL_GPU_TEXTUREFORMAT_R16_FLOAT, m_targetSize, 1, storageUsage});
+
+    graph.addPass("GTAO", [this, frame, gtaoDepth, gtaoRaw, gtao](SDL_GPUCommandBuffer *cmd, RenderGraph &graph) {
+             m_gtaoDepthTexture = graph.get(gtaoDepth);
+             m_gtaoRawTexture = graph.get(gtaoRaw);
+             m_gtaoTexture = graph.get(gtao);
+             computeGTAO(cmd, frame.projection, frame.view, frame.nearPlane, frame.farPlane);
+         })
+        .read(frame.depth)
+        .write(gtaoDepth)
+        .read(gtaoDepth)
+        .write(gtaoRaw)
+        .read(gtaoRaw)
+        .write(gtao);
+
+    // Bloom, RGBA16F since R11G11B10 has no guaranteed storage support
+    RGTexture bloom = graph.createTexture(
+        "Bloom",
+        {SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, m_targetSize, BLOOM_MIPS,
+         storageUsage | SDL_GPU_TEXTUREUSAGE_COMPUTE_STORAGE_SIMULTANEOUS_READ_WRITE});
+
+    graph.addPass("Bloom", [this, bloom](SDL_GPUCommandBuffer *cmd, RenderGraph &graph) {
+             m_bloomTexture = graph.get(bloom);
+             downsample(cmd);
+             upsample(cmd);
+         })
+        .read(frame.color)
+        .write(bloom);
+
+    // SMAA
+    RGTextureDesc edgeDesc{SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM, m_targetSize, 1, targetUsage};
+    RGTexture smaaEdge = graph.createTexture("SMAA Edge", edgeDesc);
+    RGTexture smaaBlend = graph.createTexture("SMAA Blend", edgeDesc);
+    RGTexture smaaStencil = graph.createTexture(
+        "SMAA Stencil", {m_smaaStencilFormat, m_targetSize, 1, SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET});
+    RGTexture smaaColor = graph.createTexture("SMAA Color", hdrDesc);
+
+    graph.addPass("SMAA", [this, smaaEdge, smaaBlend, smaaStencil, smaaColor](SDL_GPUCommandBuffer *cmd, RenderGraph &graph) {
+             m_smaaEdgeTex = graph.get(smaaEdge);
+             m_smaaBlendTex = graph.get(smaaBlend);
+             m_smaaStencilTex = graph.get(smaaStencil);
+             m_smaaColorTex = graph.get(smaaColor);
+             runSMAA(cmd, graph.colorTarget(smaaEdge), graph.colorTarget(smaaBlend), graph.colorTarget(smaaColor));
+         })
+        .read(frame.color)
+        .write(smaaEdge, true)
+        .read(smaaEdge)
+        .write(smaaStencil)
+        .read(smaaStencil)
+        .write(smaaBlend, true)
+        .read(smaaBlend)
+        .write(smaaColor);
+
+    RGTexture aaColor = smaa ? smaaColor : frame.color;
+
+    // TAA, the history only counts as an output while TAA is on
+    RGTexture history = graph.importTexture("TAA History", m_taaHistory[1 - m_taaHistoryIndex], taa);
+    RGTexture prevHistory = graph.importTexture("TAA Previous History", m_taaHistory[m_taaHistoryIndex]);
+
+    graph.addPass("TAA", [this, frame, history](SDL_GPUCommandBuffer *cmd, RenderGraph &graph) {
+             runTAA(cmd, graph.colorTarget(history), frame.projection * frame.view, frame.prevViewProjection);
+         })
+        .read(frame.color)
+        .read(frame.velocity)
+        .read(frame.depth)
+        .read(prevHistory)
+        .overwrite(history);
+
+    // Spatial upscale, TAA already resolved to display resolution
+    RGTexture upscale = graph.createTexture("EASU", displayDesc);
+
+    graph.addPass("EASU", [this, aaColor, upscale](SDL_GPUCommandBuffer *cmd, RenderGraph &graph) {
+             runUpscale(cmd, graph.get(aaColor), graph.colorTarget(upscale));
+         })
+        .read(aaColor)
+        .write(upscale);
+
+    RGTexture sceneOutput = taa ? history : (easu ? upscale : RGTexture{});
+
+    RGTexture sharpened = graph.createTexture("RCAS", displayDesc);
+
+    graph.addPass("RCAS", [this, sceneOutput, sharpened](SDL_GPUCommandBuffer *cmd, RenderGraph &graph) {
+             runSharpen(cmd, graph.get(sceneOutput), graph.colorTarget(sharpened));
+         })
+        .read(sceneOutput)
+        .write(sharpened);
+
+    if (sharpen)
+        sceneOutput = sharpened;
+
+    // Post, then the blit to the swapchain
+    RGTexture intermediate = graph.createTexture(
+        "Post Intermediate",
+        {Utils::getPresentFormat(), m_screenSize, 1, targetUsage});
+
+    graph.addPass("Post", [this, frame, sceneOutput, intermediate](SDL_GPUCommandBuffer *cmd, RenderGraph &graph) {
+             m_sceneOutput = graph.get(sceneOutput);
+             m_intermediateTexture = graph.get(intermediate);
+             postProcess(cmd, graph.colorTarget(intermediate), graph.get(frame.swapchain), frame.swapchainSize);
+         })
+        .read(sceneOutput.valid() ? sceneOutput : aaColor)
+        .read(bloom)
+        .read(gtao)
+        .write(intermediate)
+        .read(intermediate)
+        .write(frame.swapchain);
 }
 
 void PostProcess::loadSmaaLuts()
@@ -1023,7 +1678,7 @@ void PostProcess::loadSmaaTextureFromDDS(SDL_GPUTexture **textureOut,
 
     if (*textureOut)
     {
-        SDL_ReleaseGPUTexture(Utils::device, *textureOut);
+        GPU::releaseTexture(Utils::device, *textureOut);
     }
 
     *textureOut = info->texture;
@@ -5,6 +5,7 @@
 
 #include <SDL3/SDL_gpu.h>
 
+#include "../render_graph/render_graph.h"
 #include "../ui/base_ui.h"
 #include "screen_mask.h"
 
@@ -17,17 +18,33 @@ struct PostProcessFragmentUBO
     Uint32 fxaaEnabled;
     Uint32 lutEnabled;
     float lutIntensity;
+    glm::vec2 uvMax; // last valid texel center of the render region
+    Uint32 sceneFullRes; // scene input is already at display resolution
+    Uint32 padding;
+};
+
+// fullscreen.vert, maps the viewport to the rendered region of the targets
+struct FullscreenVertexUBO
+{
+    glm::vec2 uvScale;
+    glm::vec2 padding;
 };
 
 struct BloomDownsampleUBO
 {
-    int mipLevel;
+    glm::vec2 invTargetSize;
+    glm::vec2 uvMax; // source clamp to the render region
+    glm::ivec2 renderSize;
     float highlight;
-    float padding[2];
+    Sint32 texelOffset;    // mip 3 start in the bloom buffer, after the group counters
+    glm::ivec2 groupCount; // 8x8 mip 3 texels per group
+    glm::ivec2 padding;
 };
 
 struct BloomUpsampleUBO
 {
+    glm::ivec2 dstSize; // render region of the written mip
+    glm::ivec2 srcSize; // render region of the mip below
     float filterRadius;
     float padding[3];
 };
@@ -36,7 +53,7 @@ struct GTAOParamsUBO
 {
     glm::vec4 resolution;     // xy = size, zw = 1/size
     glm::vec2 positionParams; // invProj[0][0] * 2, invProj[1][1] * 2
-    float padding1[2];
+    glm::vec2 uvScale;        // screen uv to depth texture uv
 
     float invFarPlane;
     int maxLevel;
@@ -55,7 +72,36 @@ struct GTAOParamsUBO
     float constThickness;
     float nearPlane;
     float farPlane;
-    float padding2;
+    Uint32 frameIndex; // rotates the slice directions
+};
+
+struct GTAOTemporalUBO
+{
+    glm::mat4 reprojection;   // current view space to previous clip space
+    glm::vec4 resolution;     // xy = AO region size, zw = 1 / AO texture size
+    glm::vec2 positionParams; // same as GTAOParamsUBO
+    float farPlane;
+    float feedback;
+    Uint32 historyValid;
+    float padding0;
+    glm::vec2 padding1;
+};
+
+// Shared by the depth pyramid and the upsample
+struct GTAOUpsampleUBO
+{
+    glm::ivec2 renderSize;     // full resolution region
+    glm::ivec2 gtaoRenderSize; // AO region
+    float nearPlane;
+    float farPlane;
+    float radius; // pyramid texels farther than this behind the closest are left out
+    int hizLevel; // Hi-Z level the pyramid starts from, -1 reads the resolved depth
+};
+
+struct HiZUniforms
+{
+    glm::ivec2 depthSize;  // render region of the resolved depth
+    glm::ivec2 groupCount; // one group per 64x64 depth texels
 };
 
 enum AntiAliasingMode
@@ -63,6 +109,7 @@ enum AntiAliasingMode
     AA_None = 0,
     AA_FXAA = 1,
     AA_SMAA = 2,
+    AA_TAA = 3,
 };
 
 enum SMAAEdgeDetectionMode
@@ -78,6 +125,46 @@ struct SMAAUniforms
     glm::vec3 padding;
 };
 
+enum UpscaleMode
+{
+    UPSCALE_BILINEAR = 0, // in post.frag
+    UPSCALE_EASU = 1,     // edge adaptive pass to display resolution
+};
+
+// Shared by easu.frag and rcas.frag
+struct UpscaleUniforms
+{
+    glm::vec4 sizes; // xy = source size, zw = output size
+    float sharpness; // RCAS, in stops, 0 is the strongest
+    glm::vec3 padding;
+};
+
+struct TAAUniforms
+{
+    glm::mat4 reprojection; // current to previous clip space, unjittered, for pixels without motion vectors
+    glm::vec4 renderSize;   // xy = render region size, zw = 1 / target size
+    glm::vec2 uvScale;      // screen uv to render target uv
+    glm::vec2 jitter;       // uv offset of this frame's samples
+    float feedback;
+    Uint32 historyValid;
+    glm::vec2 padding;
+};
+
+// Per frame inputs of the post chain
+struct PostProcessFrame
+{
+    RGTexture color;
+    RGTexture velocity;
+    RGTexture depth; // resolved
+    RGTexture swapchain;
+    glm::ivec2 swapchainSize{0};
+    glm::mat4 projection{1.f};
+    glm::mat4 view{1.f};
+    glm::mat4 prevViewProjection{1.f};
+    float nearPlane = 0.f;
+    float farPlane = 0.f;
+};
+
 // using ScreenMask32 = MaskTexture<32, 32>;
 using ScreenMask64 = MaskTexture<64, 64>;
 
@@ -91,50 +178,116 @@ public:
     BloomDownsampleUBO m_downsampleUBO;
     BloomUpsampleUBO m_upsampleUBO;
     GTAOParamsUBO m_gtaoParams;
+    GTAOTemporalUBO m_gtaoTemporal;
+    GTAOUpsampleUBO m_gtaoUpsample;
     float m_gtaoResolutionFactor;
     ScreenMask64 m_gtaoMask;
 
+    // GTAO history, the slice directions rotate every frame and accumulate here
+    glm::mat4 m_gtaoPrevViewProjection{1.f};
+    glm::ivec2 m_gtaoLastRenderSize{0};
+    int m_gtaoHistoryIndex = 0;
+    bool m_gtaoHistoryValid = false;
+
     SDL_GPUSampleCount m_sampleCount;
 
+    // Dynamic resolution, targets are allocated at m_maxRenderScale and
+    // the scene renders into the top left m_renderSize region of them
+    bool m_dynamicResolution = false;
+    float m_renderScale = 1.f;
+    float m_minRenderScale = 0.5f;
+    float m_maxRenderScale = 1.f;
+    float m_targetFrameTime = 16.6f; // ms
+    float m_smoothedCPUTime = 0.f;
+    float m_smoothedGPUTime = 0.f;
+    float m_cpuFrameTime = 0.f;
+    float m_gpuFrameTime = 0.f;
+    glm::ivec2 m_screenSize{0};
+    glm::ivec2 m_targetSize{0};
+    glm::ivec2 m_renderSize{0};
+    glm::ivec2 m_gtaoSize{0};
+    FullscreenVertexUBO m_fullscreenUBO;
+
     SMAAUniforms m_smaaUniforms;
     AntiAliasingMode m_aaMode;
+
+    // TAA, the scene is rendered with a sub-pixel jitter and resolved into a display resolution history
+    TAAUniforms m_taaUniforms;
+    glm::vec2 m_jitter{0.f}; // NDC offset to bake into the projection
+    int m_taaFrame = 0;
+    int m_taaHistoryIndex = 0;
+    bool m_taaHistoryValid = false;
+
+    // Spatial upscale, needs no history so it also covers everything TAA cannot
+    UpscaleMode m_upscaleMode = UPSCALE_BILINEAR;
+    bool m_sharpenEnabled = false;
+    UpscaleUniforms m_upscaleUniforms;
+    SDL_GPUTexture *m_sceneOutput = nullptr; // display resolution scene for post.frag, null reads the render region
+
     bool m_uiDefaultOpen = true;
 
+    // Transient targets are owned by the render graph, the texture pointers
+    // below marked as such are only set for the frame their pass survived
     SDL_GPUSampler *m_clampedSampler = nullptr;
-    SDL_GPUTexture *m_intermediateTexture = nullptr;
+    SDL_GPUTexture *m_intermediateTexture = nullptr; // transient
     SDL_GPUTexture *m_msaaColorTexture = nullptr;
     SDL_GPUTexture *m_msaaDepthTexture = nullptr;
     SDL_GPUTexture *m_colorTexture = nullptr;
     SDL_GPUTexture *m_depthTexture = nullptr;
-    SDL_GPUTexture *m_gtaoRawTexture = nullptr; // Raw GTAO result (RG format)
-    SDL_GPUTexture *m_gtaoBlur0Texture = nullptr;
-    SDL_GPUTexture *m_gtaoBlur1Texture = nullptr; // Final blurred GTAO
-    SDL_GPUTexture *m_gtaoMaskTexture = nullptr;
+
+    // Min/max depth pyramid built by resolveDepth, shared by everything that
+    // needs depth over a footprint. Mip 0 is half of the render region, level L
+    // covers getHiZRegion(L) texels, R: closest, G: farthest
+    static const int HIZ_MIPS = 8;
+    SDL_GPUTexture *m_hiZTexture = nullptr;
+    SDL_GPUBuffer *m_hiZBuffer = nullptr; // group counter and mip 5 for the last group
+    glm::ivec2 m_hiZSize{0};
+    bool m_hiZBufferCleared = false;
+
+    static const int GTAO_DEPTH_MIPS = 4;
+    SDL_GPUTexture *m_gtaoDepthTexture = nullptr; // transient, linear view depth pyramid at AO resolution
+    SDL_GPUTexture *m_gtaoRawTexture = nullptr;   // transient, this frame's slices, R: visibility, G: depth / far
+    SDL_GPUTexture *m_gtaoHistory[2] = {};        // accumulated, same layout as raw
+    SDL_GPUTexture *m_gtaoTexture = nullptr;      // transient, upsampled to the target size, read by post.frag
+    SDL_GPUTexture *m_gtaoMaskTexture = nullptr;   // only uploaded when m_gtaoMask changes
+    SDL_GPUBuffer *m_gtaoTileBuffer = nullptr;     // indirect dispatch args, then the 8x8 AO tiles that need work
+    SDL_GPUTransferBuffer *m_gtaoTileReset = nullptr; // zero tiles dispatch args, copied in every frame
+    SDL_GPUTexture *m_msaaVelocityTexture = nullptr;
+    SDL_GPUTexture *m_velocityTexture = nullptr; // RG16F, uv delta to the previous frame
+    SDL_GPUTexture *m_taaHistory[2] = {};
 
     static const int BLOOM_MIPS = 5;
-    SDL_GPUTexture *m_bloomMip[BLOOM_MIPS] = {};
+    SDL_GPUTexture *m_bloomTexture = nullptr; // transient, mip chained, mip 0 holds the combined bloom
+    SDL_GPUBuffer *m_bloomBuffer = nullptr;   // group counters and mip 3 for the groups filtering mip 4
+    bool m_bloomBufferCleared = false;
 
     SDL_GPUGraphicsPipeline *m_postProcessPipeline = nullptr;
-    SDL_GPUGraphicsPipeline *m_bloomDownPipeline = nullptr;
-    SDL_GPUGraphicsPipeline *m_bloomUpPipeline = nullptr;
+    SDL_GPUComputePipeline *m_bloomPrefilterPipeline = nullptr;
+    SDL_GPUComputePipeline *m_bloomDownPipeline = nullptr;
+    SDL_GPUComputePipeline *m_bloomUpPipeline = nullptr;
     SDL_GPUGraphicsPipeline *m_depthCopyPipeline = nullptr;
     SDL_GPUGraphicsPipeline *m_depthResolvePipeline = nullptr;
-    SDL_GPUGraphicsPipeline *m_gtaoGenPipeline = nullptr;
-    SDL_GPUGraphicsPipeline *m_gtaoBlurPipeline = nullptr;
+    SDL_GPUComputePipeline *m_hiZPipeline = nullptr;
+    SDL_GPUComputePipeline *m_gtaoDepthPipeline = nullptr;
+    SDL_GPUComputePipeline *m_gtaoClassifyPipeline = nullptr;
+    SDL_GPUComputePipeline *m_gtaoGenPipeline = nullptr;
+    SDL_GPUComputePipeline *m_gtaoTemporalPipeline = nullptr;
+    SDL_GPUComputePipeline *m_gtaoUpsamplePipeline = nullptr;
+    SDL_GPUGraphicsPipeline *m_taaPipeline = nullptr;
+    SDL_GPUGraphicsPipeline *m_easuPipeline = nullptr;
+    SDL_GPUGraphicsPipeline *m_rcasPipeline = nullptr;
 
     SDL_GPUShader *m_fullscreenVert = nullptr;
     SDL_GPUShader *m_postProcessFrag = nullptr;
-    SDL_GPUShader *m_bloomDownFrag = nullptr;
-    SDL_GPUShader *m_bloomUpFrag = nullptr;
     SDL_GPUShader *m_depthCopyFrag = nullptr;
     SDL_GPUShader *m_depthResolveFrag = nullptr;
-    SDL_GPUShader *m_gtaoGenFrag = nullptr;
-    SDL_GPUShader *m_gtaoBlurFrag = nullptr;
 
-    // SMAA textures
+    // SMAA textures, all transient
     SDL_GPUTexture *m_smaaEdgeTex = nullptr;  // RGBA8
     SDL_GPUTexture *m_smaaBlendTex = nullptr; // RGBA8
     SDL_GPUTexture *m_smaaColorTex = nullptr; // AA’d color (same format as m_colorTexture)
+    SDL_GPUTexture *m_smaaStencilTex = nullptr; // edge pixels, masks the blend weight pass
+    SDL_GPUTextureFormat m_smaaStencilFormat = SDL_GPU_TEXTUREFORMAT_INVALID;
 
     // SMAA LUTs
     SDL_GPUTexture *m_smaaAreaTex = nullptr;
@@ -154,17 +307,28 @@ public:
     void setAntiAliasingMode(AntiAliasingMode mode);
 
     void update(glm::ivec2 screenSize);
+    void updateRenderScale(float cpuFrameTime, float gpuFrameTime);
+    void bindRenderViewport(SDL_GPUCommandBuffer *commandBuffer, SDL_GPURenderPass *pass);
+    void bindViewport(SDL_GPUCommandBuffer *commandBuffer, SDL_GPURenderPass *pass, glm::ivec2 size);
     void downsample(SDL_GPUCommandBuffer *commandBuffer);
     void upsample(SDL_GPUCommandBuffer *commandBuffer);
     void resolveDepth(SDL_GPUCommandBuffer *commandBuffer);
+    void buildHiZ(SDL_GPUCommandBuffer *commandBuffer);
+    glm::ivec2 getHiZRegion(int level) const;
     void computeGTAO(
         SDL_GPUCommandBuffer *commandBuffer,
         const glm::mat4 &projectionMatrix,
         const glm::mat4 &viewMatrix,
         float nearPlane,
         float farPlane);
-    void runSMAA(SDL_GPUCommandBuffer *cmd);
-    void postProcess(SDL_GPUCommandBuffer *commandBuffer, SDL_GPUTexture *swapchainTexture, glm::vec2 swapchainSize);
+    void runSMAA(SDL_GPUCommandBuffer *cmd, const SDL_GPUColorTargetInfo &edgeTarget, const SDL_GPUColorTargetInfo &blendTarget, const SDL_GPUColorTargetInfo &colorTarget);
+    void runTAA(SDL_GPUCommandBuffer *cmd, const SDL_GPUColorTargetInfo &target, const glm::mat4 &viewProjection, const glm::mat4 &prevViewProjection);
+    void runUpscale(SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *source, const SDL_GPUColorTargetInfo &target);
+    void runSharpen(SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *source, const SDL_GPUColorTargetInfo &target);
+    void postProcess(SDL_GPUCommandBuffer *commandBuffer, const SDL_GPUColorTargetInfo &intermediateTarget, SDL_GPUTexture *swapchainTexture, glm::vec2 swapchainSize);
+
+    // Declares everything after the scene passes, culled per AA and upscale mode
+    void addPasses(RenderGraph &graph, const PostProcessFrame &frame);
 
     void loadSmaaLuts();
     void loadSmaaTextureFromDDS(SDL_GPUTexture **textureOut, const char *filepath, SDL_GPUTextureFormat format);
@@ -27,6 +27,21 @@ public:
         return data_.size();
     }
 
+    // Compared against the last upload, so redrawing the same mask every frame costs no upload
+    bool isDirty() const
+    {
+        return data_ != uploaded_;
+    }
+    void markUploaded()
+    {
+        uploaded_ = data_;
+    }
+    // The texture was recreated and lost its contents
+    void markDirty()
+    {
+        uploaded_.clear();
+    }
+
     // --- Drawing Functions ---
 
     void clear(uint8_t value = 0)
@@ -198,4 +213,5 @@ public:
 
 private:
     std::vector<uint8_t> data_;
+    std::vector<uint8_t> uploaded_;
 };
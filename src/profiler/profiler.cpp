@@ -0,0 +1,256 @@
+#include "profiler.h"
+
+#include <algorithm>
+
+#include <SDL3/SDL_iostream.h>
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_timer.h>
+
+#include <imgui.h>
+
+#include "../utils/utils.h"
+
+static std::string zoneLabel(const ProfileZone &zone)
+{
+    if (zone.index < 0)
+        return zone.name;
+    return zone.name + " " + std::to_string(zone.index);
+}
+
+static ImU32 zoneColor(const std::string &name, bool gpu)
+{
+    // Stable color per name
+    Uint32 hash = 2166136261u;
+    for (char c : name)
+        hash = (hash ^ (Uint8)c) * 16777619u;
+
+    float hue = (hash % 360) / 360.f;
+    float r, g, b;
+    ImGui::ColorConvertHSVtoRGB(hue, gpu ? 0.45f : 0.6f, 0.75f, r, g, b);
+    return ImGui::GetColorU32(ImVec4(r, g, b, 1.f));
+}
+
+static void writeEscaped(SDL_IOStream *io, const std::string &text)
+{
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+            SDL_IOprintf(io, "\\%c", c);
+        else if ((Uint8)c >= 0x20)
+            SDL_IOprintf(io, "%c", c);
+    }
+}
+
+void Profiler::renderUI()
+{
+    if (!ImGui::CollapsingHeader("Profiler"))
+        return;
+
+    ImGui::Checkbox("Enabled", &m_enabled);
+    ImGui::SameLine();
+    ImGui::Checkbox("Pause", &m_paused);
+    ImGui::SameLine();
+    ImGui::Checkbox("GPU Timings", &m_gpuTimings);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Submits every pass separately and waits for it, serializes the CPU and the GPU");
+
+    ImGui::DragInt("Capture Frames", &m_captureFrames, 1, 1, 10000);
+    if (m_capturing)
+    {
+        ImGui::Text("Capturing %d/%d", m_capturedFrames, m_captureFrames);
+    }
+    else if (ImGui::Button("Record Trace"))
+    {
+        m_capture.clear();
+        m_capturedFrames = 0;
+        m_capturing = true;
+    }
+    if (!m_lastTracePath.empty())
+        ImGui::TextWrapped("Trace: %s", m_lastTracePath.c_str());
+
+    if (m_lastFrame.empty())
+        return;
+
+    // Frame zone is the first one, GPU zones may end after it
+    Uint64 begin = m_lastFrame[0].start;
+    Uint64 end = m_lastFrame[0].end;
+    int maxDepth = 0;
+    for (const ProfileZone &zone : m_lastFrame)
+    {
+        end = std::max(end, zone.end);
+        if (!zone.gpu)
+            maxDepth = std::max(maxDepth, zone.depth);
+    }
+    ImGui::Text("Frame: %.3f ms", (m_lastFrame[0].end - m_lastFrame[0].start) / 1e6f);
+
+    // Timeline, CPU rows by depth then a GPU row
+    const float rowHeight = ImGui::GetTextLineHeight() + 4.f;
+    const int rows = maxDepth + 2;
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float width = std::max(ImGui::GetContentRegionAvail().x, 100.f);
+    float height = rowHeight * rows;
+    ImGui::InvisibleButton("##timeline", ImVec2(width, height));
+    bool hovered = ImGui::IsItemHovered();
+    ImVec2 mouse = ImGui::GetMousePos();
+
+    ImDrawList *drawList = ImGui::GetWindowDrawList();
+    drawList->AddRectFilled(origin, ImVec2(origin.x + width, origin.y + height), ImGui::GetColorU32(ImGuiCol_FrameBg));
+
+    float scale = width / (float)std::max<Uint64>(end - begin, 1);
+    for (const ProfileZone &zone : m_lastFrame)
+    {
+        int row = zone.gpu ? rows - 1 : zone.depth;
+        ImVec2 min(origin.x + (zone.start - begin) * scale, origin.y + row * rowHeight);
+        ImVec2 max(std::max(origin.x + (zone.end - begin) * scale, min.x + 1.f), min.y + rowHeight - 1.f);
+
+        std::string label = zoneLabel(zone);
+        drawList->AddRectFilled(min, max, zoneColor(zone.name, zone.gpu));
+        drawList->PushClipRect(min, max, true);
+        drawList->AddText(ImVec2(min.x + 2.f, min.y + 2.f), IM_COL32(0, 0, 0, 255), label.c_str());
+        drawList->PopClipRect();
+
+        if (hovered && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+            ImGui::SetTooltip("%s%s: %.3f ms", zone.gpu ? "GPU " : "", label.c_str(), (zone.end - zone.start) / 1e6f);
+    }
+
+    if (ImGui::TreeNode("Zones"))
+    {
+        for (const ProfileZone &zone : m_lastFrame)
+        {
+            ImGui::Indent(zone.depth * 10.f + 1.f);
+            ImGui::Text("%s%s: %.3f ms", zone.gpu ? "GPU " : "", zoneLabel(zone).c_str(), (zone.end - zone.start) / 1e6f);
+            ImGui::Unindent(zone.depth * 10.f + 1.f);
+        }
+        ImGui::TreePop();
+    }
+
+    if (!m_loadZones.empty() && ImGui::TreeNode("Loading"))
+    {
+        for (const ProfileZone &zone : m_loadZones)
+        {
+            ImGui::Indent(zone.depth * 10.f + 1.f);
+            ImGui::Text("%s: %.3f ms", zoneLabel(zone).c_str(), (zone.end - zone.start) / 1e6f);
+            ImGui::Unindent(zone.depth * 10.f + 1.f);
+        }
+        ImGui::TreePop();
+    }
+}
+
+void Profiler::beginFrame()
+{
+    m_frameEnabled = m_enabled;
+    m_inFrame = true;
+    m_zones.clear();
+    m_stack.clear();
+
+    beginZone("Frame");
+}
+
+void Profiler::endFrame()
+{
+    endZone();
+    m_inFrame = false;
+
+    if (!m_frameEnabled)
+        return;
+
+    if (!m_paused)
+        m_lastFrame = m_zones;
+
+    if (m_capturing)
+    {
+        m_capture.insert(m_capture.end(), m_zones.begin(), m_zones.end());
+        if (++m_capturedFrames >= m_captureFrames)
+        {
+            m_capturing = false;
+            std::string path = Utils::getExecutablePath() + "/profile_trace.json";
+            if (exportTrace(path))
+                m_lastTracePath = path;
+            m_capture.clear();
+        }
+    }
+}
+
+void Profiler::beginZone(const char *name, int index)
+{
+    if (!recording())
+        return;
+
+    std::vector<ProfileZone> &zones = m_inFrame ? m_zones : m_loadZones;
+
+    ProfileZone zone;
+    zone.name = name;
+    zone.index = index;
+    zone.depth = (int)m_stack.size();
+    zone.start = SDL_GetTicksNS();
+    zones.push_back(zone);
+    m_stack.push_back((int)zones.size() - 1);
+}
+
+void Profiler::endZone()
+{
+    if (!recording() || m_stack.empty())
+        return;
+
+    std::vector<ProfileZone> &zones = m_inFrame ? m_zones : m_loadZones;
+    zones[m_stack.back()].end = SDL_GetTicksNS();
+    m_stack.pop_back();
+}
+
+void Profiler::submitGPU(SDL_GPUCommandBuffer *cmd, const char *name, Uint64 start)
+{
+    Uint64 submitted = SDL_GetTicksNS();
+    SDL_GPUFence *fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmd);
+    if (!fence)
+    {
+        SDL_Log("Failed to submit profiled command buffer %s: %s", name, SDL_GetError());
+        return;
+    }
+
+    SDL_WaitForGPUFences(Utils::device, true, &fence, 1);
+    Uint64 finished = SDL_GetTicksNS();
+    SDL_ReleaseGPUFence(Utils::device, fence);
+
+    if (!recording() || !m_inFrame)
+        return;
+
+    ProfileZone zone;
+    zone.name = name;
+    zone.start = start ? start : submitted;
+    zone.end = finished;
+    zone.gpu = true;
+    m_zones.push_back(zone);
+}
+
+bool Profiler::exportTrace(const std::string &path)
+{
+    SDL_IOStream *io = SDL_IOFromFile(path.c_str(), "w");
+    if (!io)
+    {
+        SDL_Log("Failed to open trace file %s: %s", path.c_str(), SDL_GetError());
+        return false;
+    }
+
+    // Complete events in microseconds, CPU and GPU on separate tracks
+    SDL_IOprintf(io, "{\"traceEvents\":[\n");
+    SDL_IOprintf(io, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,\"args\":{\"name\":\"CPU\"}},\n");
+    SDL_IOprintf(io, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":1,\"args\":{\"name\":\"GPU\"}}");
+
+    auto writeZones = [&](const std::vector<ProfileZone> &zones) {
+        for (const ProfileZone &zone : zones)
+        {
+            SDL_IOprintf(io, ",\n{\"name\":\"");
+            writeEscaped(io, zoneLabel(zone));
+            SDL_IOprintf(io, "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%d}",
+                         zone.start / 1e3, (zone.end - zone.start) / 1e3, zone.gpu ? 1 : 0);
+        }
+    };
+    writeZones(m_loadZones);
+    writeZones(m_capture);
+
+    SDL_IOprintf(io, "\n]}\n");
+    SDL_CloseIO(io);
+
+    SDL_Log("Profiler trace written to %s", path.c_str());
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL_gpu.h>
+
+#include "../ui/base_ui.h"
+
+struct ProfileZone
+{
+    std::string name;
+    int index = -1; // appended to the name, e.g. the cascade
+    int depth = 0;
+    Uint64 start = 0; // ns, SDL_GetTicksNS
+    Uint64 end = 0;
+    bool gpu = false;
+};
+
+// Hierarchical CPU zones plus GPU zones bracketed by fences, main thread only.
+// Zones recorded outside of a frame (loading) are kept for the trace export.
+class Profiler : public BaseUI
+{
+public:
+    static Profiler &getInstance()
+    {
+        static Profiler instance;
+        return instance;
+    }
+
+    Profiler(const Profiler &) = delete;
+    Profiler &operator=(const Profiler &) = delete;
+
+    bool m_enabled = true;
+    bool m_paused = false;
+    // Every render graph pass gets its own command buffer and is waited on,
+    // this serializes CPU and GPU so CPU zones read high while it is on
+    bool m_gpuTimings = false;
+
+    std::vector<ProfileZone> m_zones;     // being recorded
+    std::vector<ProfileZone> m_lastFrame; // shown in the timeline
+    std::vector<ProfileZone> m_loadZones; // recorded before the first frame
+    std::vector<int> m_stack;             // open zones
+    bool m_inFrame = false;
+    bool m_frameEnabled = false; // m_enabled latched at beginFrame, keeps zones balanced when toggled mid frame
+
+    // Trace capture
+    std::vector<ProfileZone> m_capture;
+    int m_captureFrames = 120;
+    int m_capturedFrames = 0;
+    bool m_capturing = false;
+    std::string m_lastTracePath;
+
+    void renderUI() override;
+
+    void beginFrame();
+    void endFrame();
+    void beginZone(const char *name, int index = -1);
+    void endZone();
+
+    bool gpuTimingsActive() const { return m_gpuTimings && m_inFrame && m_frameEnabled; }
+    // Submits, waits for the fence and records the GPU time since start (0 means now)
+    void submitGPU(SDL_GPUCommandBuffer *cmd, const char *name, Uint64 start = 0);
+
+    // Chrome trace event format, load in chrome://tracing or Perfetto
+    bool exportTrace(const std::string &path);
+
+private:
+    Profiler() {};
+
+    bool recording() const { return m_inFrame ? m_frameEnabled : m_enabled; }
+};
+
+// Scoped CPU zone
+class ProfileScope
+{
+public:
+    ProfileScope(const char *name, int index = -1)
+    {
+        Profiler::getInstance().beginZone(name, index);
+    }
+
+    ~ProfileScope()
+    {
+        Profiler::getInstance().endZone();
+    }
+};
@@ -0,0 +1,428 @@
+#include "render_graph.h"
+
+#include <algorithm>
+
+#include <imgui.h>
+
+#include "../gpu/gpu.h"
+#include "../gpu/render_stats.h"
+#include "../profiler/profiler.h"
+#include "../utils/utils.h"
+
+static Uint32 bytesPerTexel(SDL_GPUTextureFormat format)
+{
+    switch (format)
+    {
+    case SDL_GPU_TEXTUREFORMAT_R8_UNORM:
+        return 1;
+    case SDL_GPU_TEXTUREFORMAT_R16_FLOAT:
+        return 2;
+    case SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT:
+    case SDL_GPU_TEXTUREFORMAT_R32G32_FLOAT:
+    case SDL_GPU_TEXTUREFORMAT_D32_FLOAT_S8_UINT:
+        return 8;
+    default:
+        return 4;
+    }
+}
+
+static Uint64 textureBytes(const RGTextureDesc &desc)
+{
+    Uint64 bytes = 0;
+    for (Uint32 i = 0; i < desc.numLevels; i++)
+    {
+        glm::ivec2 size = glm::max(desc.size >> (int)i, glm::ivec2(1));
+        bytes += (Uint64)size.x * size.y * bytesPerTexel(desc.format);
+    }
+    return bytes;
+}
+
+RGPassBuilder::RGPassBuilder(RenderGraph *graph, int pass)
+    : m_graph(graph),
+      m_pass(pass)
+{
+}
+
+RGPassBuilder &RGPassBuilder::read(RGTexture texture)
+{
+    if (texture.valid())
+        m_graph->m_passes[m_pass].reads.push_back(texture.index);
+    return *this;
+}
+
+RGPassBuilder &RGPassBuilder::write(RGTexture texture, bool clear)
+{
+    if (texture.valid())
+    {
+        m_graph->m_passes[m_pass].writes.push_back(texture.index);
+        if (clear)
+            m_graph->m_resources[texture.index].cleared = true;
+    }
+    return *this;
+}
+
+RGPassBuilder &RGPassBuilder::overwrite(RGTexture texture)
+{
+    if (texture.valid())
+    {
+        m_graph->m_passes[m_pass].writes.push_back(texture.index);
+        m_graph->m_resources[texture.index].overwritten = true;
+    }
+    return *this;
+}
+
+RGPassBuilder &RGPassBuilder::sideEffect()
+{
+    m_graph->m_passes[m_pass].sideEffect = true;
+    return *this;
+}
+
+RenderGraph::RenderGraph()
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+    for (PoolEntry &entry : m_pool)
+        GPU::releaseTexture(Utils::device, entry.texture);
+}
+
+void RenderGraph::renderUI()
+{
+    if (!ImGui::CollapsingHeader("Render Graph"))
+        return;
+
+    ImGui::Text("Passes: %d, culled: %d", (int)m_passes.size(), m_culledPasses);
+    ImGui::Text("Transients: %.1f MB", m_transientBytes / (1024.f * 1024.f));
+    ImGui::Text("Pool: %d textures, %.1f MB", (int)m_pool.size(), m_poolBytes / (1024.f * 1024.f));
+    ImGui::DragInt("Pool Keep Frames", &m_poolKeepFrames, 1, 0, 120);
+
+    if (ImGui::TreeNode("Passes"))
+    {
+        for (const Pass &pass : m_passes)
+        {
+            if (pass.culled)
+                ImGui::TextDisabled("%s (culled)", pass.name.c_str());
+            else
+                ImGui::Text("%s", pass.name.c_str());
+        }
+        ImGui::TreePop();
+    }
+
+    if (ImGui::TreeNode("Transients"))
+    {
+        for (const Resource &resource : m_resources)
+        {
+            if (resource.imported)
+                continue;
+
+            if (resource.poolIndex < 0)
+                ImGui::TextDisabled("%s (unused)", resource.name.c_str());
+            else
+                ImGui::Text("%s: passes %d-%d, pool %d", resource.name.c_str(), resource.firstPass, resource.lastPass, resource.poolIndex);
+        }
+        ImGui::TreePop();
+    }
+}
+
+void RenderGraph::begin()
+{
+    m_resources.clear();
+    m_passes.clear();
+    m_currentPass = -1;
+}
+
+RGTexture RenderGraph::createTexture(const char *name, const RGTextureDesc &desc)
+{
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    resource.desc.size = glm::max(desc.size, glm::ivec2(1));
+    m_resources.push_back(resource);
+
+    return RGTexture{(int)m_resources.size() - 1};
+}
+
+RGTexture RenderGraph::importTexture(const char *name, SDL_GPUTexture *texture, bool output)
+{
+    Resource resource;
+    resource.name = name;
+    resource.texture = texture;
+    resource.imported = true;
+    resource.output = output;
+    m_resources.push_back(resource);
+
+    return RGTexture{(int)m_resources.size() - 1};
+}
+
+RGTexture RenderGraph::importSwapchain(const char *name, SDL_GPUTexture *texture)
+{
+    RGTexture handle = importTexture(name, texture, true);
+    m_resources[handle.index].swapchain = true;
+    return handle;
+}
+
+RGPassBuilder RenderGraph::addPass(const char *name, RGExecute execute)
+{
+    Pass pass;
+    pass.name = name;
+    pass.execute = std::move(execute);
+    m_passes.push_back(std::move(pass));
+
+    return RGPassBuilder(this, (int)m_passes.size() - 1);
+}
+
+void RenderGraph::cull()
+{
+    // Walk back from the outputs, a pass survives if anything still needs one of its writes
+    std::vector<bool> needed(m_resources.size(), false);
+    for (size_t i = 0; i < m_resources.size(); i++)
+        needed[i] = m_resources[i].output;
+
+    m_culledPasses = 0;
+    for (int p = (int)m_passes.size() - 1; p >= 0; p--)
+    {
+        Pass &pass = m_passes[p];
+
+        bool alive = pass.sideEffect;
+        for (int index : pass.writes)
+            alive = alive || needed[index];
+
+        pass.culled = !alive;
+        if (!alive)
+        {
+            m_culledPasses++;
+            continue;
+        }
+
+        // Fully overwritten, earlier writers are not needed for it anymore
+        for (int index : pass.writes)
+        {
+            if (std::find(pass.reads.begin(), pass.reads.end(), index) == pass.reads.end())
+                needed[index] = false;
+        }
+        for (int index : pass.reads)
+            needed[index] = true;
+    }
+}
+
+void RenderGraph::computeLifetimes()
+{
+    for (int p = 0; p < (int)m_passes.size(); p++)
+    {
+        const Pass &pass = m_passes[p];
+        if (pass.culled)
+            continue;
+
+        for (int index : pass.writes)
+        {
+            Resource &resource = m_resources[index];
+            if (resource.firstPass < 0)
+                resource.firstPass = p;
+            resource.lastPass = p;
+        }
+        for (int index : pass.reads)
+        {
+            Resource &resource = m_resources[index];
+            if (resource.firstPass < 0)
+                resource.firstPass = p;
+            resource.lastPass = p;
+            resource.lastRead = p;
+        }
+    }
+}
+
+void RenderGraph::allocate(Resource &resource)
+{
+    // Transients are handed out in first use order, so any entry free before this one starts can be reused
+    for (size_t i = 0; i < m_pool.size(); i++)
+    {
+        PoolEntry &entry = m_pool[i];
+        if (entry.busyUntil < resource.firstPass && entry.desc == resource.desc)
+        {
+            entry.busyUntil = resource.lastPass;
+            entry.lastUsedFrame = m_frameIndex;
+            resource.texture = entry.texture;
+            resource.poolIndex = (int)i;
+            return;
+        }
+    }
+
+    SDL_GPUTextureCreateInfo info{};
+    info.type = SDL_GPU_TEXTURETYPE_2D;
+    info.format = resource.desc.format;
+    info.width = resource.desc.size.x;
+    info.height = resource.desc.size.y;
+    info.layer_count_or_depth = 1;
+    info.num_levels = resource.desc.numLevels;
+    info.usage = resource.desc.usage;
+    info.sample_count = SDL_GPU_SAMPLECOUNT_1;
+
+    PoolEntry entry;
+    entry.desc = resource.desc;
+    entry.texture = GPU::createTexture(Utils::device, &info, GPUMemoryCategory::RenderTarget);
+    entry.busyUntil = resource.lastPass;
+    entry.lastUsedFrame = m_frameIndex;
+    if (!entry.texture)
+    {
+        SDL_Log("Failed to create render graph texture %s: %s", resource.name.c_str(), SDL_GetError());
+        return;
+    }
+    SDL_SetGPUTextureName(Utils::device, entry.texture, resource.name.c_str());
+
+    m_pool.push_back(entry);
+    resource.texture = entry.texture;
+    resource.poolIndex = (int)m_pool.size() - 1;
+}
+
+void RenderGraph::releaseUnused()
+{
+    // Over the GPU memory budget only what this frame used is kept
+    Uint64 keepFrames = GPU::memory.overBudget() ? 0 : (Uint64)m_poolKeepFrames;
+
+    m_poolBytes = 0;
+    for (size_t i = 0; i < m_pool.size();)
+    {
+        PoolEntry &entry = m_pool[i];
+        if (m_frameIndex - entry.lastUsedFrame > keepFrames)
+        {
+            // Released once the GPU is done with it
+            GPU::releaseTexture(Utils::device, entry.texture);
+            m_pool.erase(m_pool.begin() + i);
+            continue;
+        }
+        m_poolBytes += textureBytes(entry.desc);
+        i++;
+    }
+}
+
+void RenderGraph::execute(SDL_GPUCommandBuffer *commandBuffer)
+{
+    m_frameIndex++;
+
+    cull();
+    computeLifetimes();
+
+    for (PoolEntry &entry : m_pool)
+        entry.busyUntil = -1;
+
+    m_transientBytes = 0;
+    for (const Resource &resource : m_resources)
+    {
+        if (!resource.imported && resource.firstPass >= 0)
+            m_transientBytes += textureBytes(resource.desc);
+    }
+
+    // For GPU timings every pass before the swapchain is used gets a command buffer of its own
+    Profiler &profiler = Profiler::getInstance();
+    int swapchainPass = (int)m_passes.size();
+    for (const Resource &resource : m_resources)
+    {
+        if (resource.swapchain && resource.firstPass >= 0)
+            swapchainPass = std::min(swapchainPass, resource.firstPass);
+    }
+
+    for (int p = 0; p < (int)m_passes.size(); p++)
+    {
+        Pass &pass = m_passes[p];
+        if (pass.culled)
+            continue;
+
+        ProfileScope zone(pass.name.c_str());
+
+        for (int index : pass.writes)
+        {
+            Resource &resource = m_resources[index];
+            if (!resource.imported && resource.firstPass == p && !resource.texture)
+                allocate(resource);
+        }
+        for (int index : pass.reads)
+        {
+            Resource &resource = m_resources[index];
+            if (!resource.imported && resource.firstPass == p && !resource.texture)
+                allocate(resource);
+        }
+
+        const GPUStats before = GPU::stats;
+
+        m_currentPass = p;
+        if (p < swapchainPass && profiler.gpuTimingsActive())
+        {
+            SDL_GPUCommandBuffer *passCommandBuffer = SDL_AcquireGPUCommandBuffer(Utils::device);
+            pass.execute(passCommandBuffer, *this);
+            profiler.submitGPU(passCommandBuffer, pass.name.c_str());
+        }
+        else
+        {
+            pass.execute(commandBuffer, *this);
+        }
+
+        // Per pass counters, the views of the culling are the passes. Names are only
+        // built when the pass at this index changed or first draws or culls
+        RenderStats &renderStats = RenderStats::getInstance();
+        if ((int)m_passCounters.size() <= p)
+            m_passCounters.resize(p + 1);
+        PassCounters &counters = m_passCounters[p];
+        if (counters.name != pass.name)
+            counters = {pass.name};
+
+        const GPUStats &after = GPU::stats;
+        if (after.drawCalls != before.drawCalls)
+        {
+            if (counters.draws < 0)
+                counters.draws = renderStats.registerCounter(pass.name + ": Draws");
+            renderStats.add(counters.draws, (float)(after.drawCalls - before.drawCalls));
+        }
+        if (after.primitivesVisible != before.primitivesVisible || after.primitivesCulled != before.primitivesCulled)
+        {
+            if (counters.visible < 0)
+            {
+                counters.visible = renderStats.registerCounter(pass.name + ": Visible");
+                counters.culled = renderStats.registerCounter(pass.name + ": Culled");
+            }
+            renderStats.add(counters.visible, (float)(after.primitivesVisible - before.primitivesVisible));
+            renderStats.add(counters.culled, (float)(after.primitivesCulled - before.primitivesCulled));
+        }
+    }
+    m_currentPass = -1;
+
+    releaseUnused();
+}
+
+SDL_GPUTexture *RenderGraph::get(RGTexture texture) const
+{
+    if (!texture.valid())
+        return nullptr;
+    return m_resources[texture.index].texture;
+}
+
+SDL_GPULoadOp RenderGraph::getLoadOp(RGTexture texture) const
+{
+    const Resource &resource = m_resources[texture.index];
+    bool firstUse = resource.firstPass == m_currentPass;
+
+    if (firstUse && resource.cleared)
+        return SDL_GPU_LOADOP_CLEAR;
+    if (firstUse && (!resource.imported || resource.overwritten))
+        return SDL_GPU_LOADOP_DONT_CARE;
+    return SDL_GPU_LOADOP_LOAD;
+}
+
+SDL_GPUStoreOp RenderGraph::getStoreOp(RGTexture texture) const
+{
+    // The current pass counts, it may read back what it wrote
+    const Resource &resource = m_resources[texture.index];
+    if (resource.imported || resource.lastRead >= m_currentPass)
+        return SDL_GPU_STOREOP_STORE;
+    return SDL_GPU_STOREOP_DONT_CARE;
+}
+
+SDL_GPUColorTargetInfo RenderGraph::colorTarget(RGTexture texture) const
+{
+    SDL_GPUColorTargetInfo target{};
+    target.texture = get(texture);
+    target.load_op = getLoadOp(texture);
+    target.store_op = getStoreOp(texture);
+    target.clear_color = {0.f, 0.f, 0.f, 0.f};
+    return target;
+}
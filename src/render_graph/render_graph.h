@@ -0,0 +1,144 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <SDL3/SDL_gpu.h>
+
+#include "../ui/base_ui.h"
+
+struct RGTextureDesc
+{
+    SDL_GPUTextureFormat format = SDL_GPU_TEXTUREFORMAT_INVALID;
+    glm::ivec2 size{0};
+    Uint32 numLevels = 1;
+    SDL_GPUTextureUsageFlags usage = 0;
+
+    bool operator==(const RGTextureDesc &other) const
+    {
+        return format == other.format && size == other.size && numLevels == other.numLevels && usage == other.usage;
+    }
+};
+
+// Index into the frame's resources, invalid after the next begin()
+struct RGTexture
+{
+    int index = -1;
+
+    bool valid() const { return index >= 0; }
+};
+
+class RenderGraph;
+
+using RGExecute = std::function<void(SDL_GPUCommandBuffer *commandBuffer, RenderGraph &graph)>;
+
+// Returned by addPass, declares what the pass touches
+class RGPassBuilder
+{
+public:
+    RGPassBuilder(RenderGraph *graph, int pass);
+
+    RGPassBuilder &read(RGTexture texture);
+    RGPassBuilder &write(RGTexture texture, bool clear = false);
+    // Write that covers every texel, imported textures then skip the load too
+    RGPassBuilder &overwrite(RGTexture texture);
+    // Keeps the pass alive without a consumer, for readbacks and presentation
+    RGPassBuilder &sideEffect();
+
+private:
+    RenderGraph *m_graph;
+    int m_pass;
+};
+
+// Frame graph rebuilt every frame. Passes nobody consumes are culled, transient
+// textures are only allocated for the passes that survive and are handed out
+// from a pool, so textures with disjoint lifetimes share the same allocation
+class RenderGraph : public BaseUI
+{
+public:
+    RenderGraph();
+    ~RenderGraph();
+
+    struct Resource
+    {
+        std::string name;
+        RGTextureDesc desc;
+        SDL_GPUTexture *texture = nullptr;
+        bool imported = false;
+        bool output = false; // imported, read after the graph ran
+        bool swapchain = false;
+        bool cleared = false;
+        bool overwritten = false;
+        int firstPass = -1;  // alive passes only
+        int lastPass = -1;
+        int lastRead = -1;
+        int poolIndex = -1;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        RGExecute execute;
+        std::vector<int> reads;
+        std::vector<int> writes;
+        bool sideEffect = false;
+        bool culled = false;
+    };
+
+    struct PoolEntry
+    {
+        RGTextureDesc desc;
+        SDL_GPUTexture *texture = nullptr;
+        int busyUntil = -1; // last pass of the current owner this frame
+        Uint64 lastUsedFrame = 0;
+    };
+
+    // RenderStats ids of the pass at the same index, registered on first use
+    struct PassCounters
+    {
+        std::string name;
+        int draws = -1;
+        int visible = -1;
+        int culled = -1;
+    };
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    std::vector<PoolEntry> m_pool;
+    std::vector<PassCounters> m_passCounters; // survives begin, passes are added in the same order every frame
+    int m_currentPass = -1;
+    Uint64 m_frameIndex = 0;
+    int m_poolKeepFrames = 4; // unused pool textures are released after this many frames
+
+    // Stats of the last execute
+    int m_culledPasses = 0;
+    Uint64 m_transientBytes = 0; // what the transients would take without aliasing
+    Uint64 m_poolBytes = 0;
+
+    void renderUI() override;
+
+    void begin();
+    RGTexture createTexture(const char *name, const RGTextureDesc &desc);
+    RGTexture importTexture(const char *name, SDL_GPUTexture *texture, bool output = false);
+    // Passes from the first one touching it on stay on the command buffer that acquired it
+    RGTexture importSwapchain(const char *name, SDL_GPUTexture *texture);
+    RGPassBuilder addPass(const char *name, RGExecute execute);
+    void execute(SDL_GPUCommandBuffer *commandBuffer);
+
+    // Only valid inside the execute callback of a pass that declared the texture
+    SDL_GPUTexture *get(RGTexture texture) const;
+    SDL_GPULoadOp getLoadOp(RGTexture texture) const;
+    SDL_GPUStoreOp getStoreOp(RGTexture texture) const;
+    SDL_GPUColorTargetInfo colorTarget(RGTexture texture) const;
+
+private:
+    void cull();
+    void computeLifetimes();
+    void allocate(Resource &resource);
+    void releaseUnused();
+
+    friend class RGPassBuilder;
+};
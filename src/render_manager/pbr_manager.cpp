@@ -5,6 +5,7 @@
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 
+#include "../gpu/gpu.h"
 #include "../resource_manager/resource_manager.h"
 #include "../utils/utils.h"
 
@@ -57,10 +58,10 @@ PbrManager::~PbrManager()
     SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_skyboxPipeline);
     SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_proceduralSkyboxPipeline);
 
-    SDL_ReleaseGPUTexture(Utils::device, m_brdfTexture);
-    SDL_ReleaseGPUTexture(Utils::device, m_cubemapTexture);
-    SDL_ReleaseGPUTexture(Utils::device, m_irradianceTexture);
-    SDL_ReleaseGPUTexture(Utils::device, m_prefilterTexture);
+    GPU::releaseTexture(Utils::device, m_brdfTexture);
+    GPU::releaseTexture(Utils::device, m_cubemapTexture);
+    GPU::releaseTexture(Utils::device, m_irradianceTexture);
+    GPU::releaseTexture(Utils::device, m_prefilterTexture);
 
     SDL_ReleaseGPUSampler(Utils::device, m_hdrSampler);
     SDL_ReleaseGPUSampler(Utils::device, m_brdfSampler);
@@ -187,13 +188,14 @@ void PbrManager::createSkyboxPipelines(SDL_GPUDevice *device)
     SDL_GPUMultisampleState multisampleState = {};
     multisampleState.sample_count = SDL_GPU_SAMPLECOUNT_1;
 
-    // Color target
-    SDL_GPUColorTargetDescription colorTarget = {};
-    colorTarget.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
+    // Color targets, the skybox draws in the opaque pass next to its motion vectors
+    SDL_GPUColorTargetDescription colorTargets[2] = {};
+    colorTargets[0].format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
+    colorTargets[1].format = SDL_GPU_TEXTUREFORMAT_R16G16_FLOAT;
 
     SDL_GPUGraphicsPipelineTargetInfo targetInfo = {};
-    targetInfo.color_target_descriptions = &colorTarget;
-    targetInfo.num_color_targets = 1;
+    targetInfo.color_target_descriptions = colorTargets;
+    targetInfo.num_color_targets = 2;
     targetInfo.depth_stencil_format = SDL_GPU_TEXTUREFORMAT_D32_FLOAT; // Or your depth format
     targetInfo.has_depth_stencil_target = true;
 
@@ -251,7 +253,7 @@ void PbrManager::init()
         brdfInfo.layer_count_or_depth = 1;
         brdfInfo.num_levels = 1;
         brdfInfo.sample_count = SDL_GPU_SAMPLECOUNT_1;
-        m_brdfTexture = SDL_CreateGPUTexture(Utils::device, &brdfInfo);
+        m_brdfTexture = GPU::createTexture(Utils::device, &brdfInfo, GPUMemoryCategory::IBL);
 
         // cubemap
         SDL_GPUTextureCreateInfo cubemapInfo = {};
@@ -263,18 +265,18 @@ void PbrManager::init()
         cubemapInfo.width = m_cubemapSize;
         cubemapInfo.height = m_cubemapSize;
         cubemapInfo.num_levels = 5;
-        m_cubemapTexture = SDL_CreateGPUTexture(Utils::device, &cubemapInfo);
+        m_cubemapTexture = GPU::createTexture(Utils::device, &cubemapInfo, GPUMemoryCategory::IBL);
 
         // irradiance
         cubemapInfo.width = m_irradianceSize;
         cubemapInfo.height = m_irradianceSize;
-        m_irradianceTexture = SDL_CreateGPUTexture(Utils::device, &cubemapInfo);
+        m_irradianceTexture = GPU::createTexture(Utils::device, &cubemapInfo, GPUMemoryCategory::IBL);
 
         // prefilter
         cubemapInfo.width = m_prefilterSize;
         cubemapInfo.height = m_prefilterSize;
         cubemapInfo.num_levels = m_prefilterMipLevels;
-        m_prefilterTexture = SDL_CreateGPUTexture(Utils::device, &cubemapInfo);
+        m_prefilterTexture = GPU::createTexture(Utils::device, &cubemapInfo, GPUMemoryCategory::IBL);
     }
 
     // samplers
@@ -338,24 +340,24 @@ void PbrManager::createBRDFTexture()
     colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
     colorTargetInfo.texture = m_brdfTexture;
 
-    SDL_GPURenderPass *renderPass = SDL_BeginGPURenderPass(commandBuffer, &colorTargetInfo, 1, nullptr);
+    SDL_GPURenderPass *renderPass = GPU::beginRenderPass(commandBuffer, &colorTargetInfo, 1, nullptr);
     if (!renderPass)
     {
         SDL_Log("Failed to begin render pass: %s", SDL_GetError());
         return;
     }
 
-    SDL_BindGPUGraphicsPipeline(renderPass, m_brdfPipeline);
+    GPU::bindGraphicsPipeline(renderPass, m_brdfPipeline);
 
     const PrimitiveData &prim = m_quadModel->meshes[0].primitives[0];
 
     SDL_GPUBufferBinding vertexBinding{prim.vertexBuffer, 0};
     SDL_GPUBufferBinding indexBinding = {prim.indexBuffer, 0};
 
-    SDL_BindGPUVertexBuffers(renderPass, 0, &vertexBinding, 1);
-    SDL_BindGPUIndexBuffer(renderPass, &indexBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+    GPU::bindVertexBuffers(renderPass, 0, &vertexBinding, 1);
+    GPU::bindIndexBuffer(renderPass, &indexBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
 
-    SDL_DrawGPUIndexedPrimitives(renderPass, (Uint32)prim.indices.size(), 1, 0, 0, 0);
+    GPU::drawIndexedPrimitives(renderPass, (Uint32)prim.indices.size(), 1, 0, 0, 0);
 
     SDL_EndGPURenderPass(renderPass);
 
@@ -397,18 +399,18 @@ void PbrManager::updateEnvironmentTexture(SDL_GPUTexture *environmentTexture)
             colorTargetInfo.layer_or_depth_plane = i;
             uniforms.view = m_captureViews[i];
 
-            SDL_GPURenderPass *pass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, nullptr);
+            SDL_GPURenderPass *pass = GPU::beginRenderPass(cmdbuf, &colorTargetInfo, 1, nullptr);
             {
-                SDL_BindGPUGraphicsPipeline(pass, m_cubemapPipeline);
-                SDL_SetGPUViewport(pass, &viewport);
+                GPU::bindGraphicsPipeline(pass, m_cubemapPipeline);
+                GPU::setViewport(pass, &viewport);
 
-                SDL_PushGPUVertexUniformData(cmdbuf, 0, &uniforms, sizeof(uniforms));
-                SDL_BindGPUFragmentSamplers(pass, 0, &hdrBinding, 1);
+                GPU::pushVertexUniformData(cmdbuf, 0, &uniforms, sizeof(uniforms));
+                GPU::bindFragmentSamplers(pass, 0, &hdrBinding, 1);
 
-                SDL_BindGPUVertexBuffers(pass, 0, &vtxBinding, 1);
-                SDL_BindGPUIndexBuffer(pass, &idxBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+                GPU::bindVertexBuffers(pass, 0, &vtxBinding, 1);
+                GPU::bindIndexBuffer(pass, &idxBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
 
-                SDL_DrawGPUIndexedPrimitives(pass, prim.indices.size(), 1, 0, 0, 0);
+                GPU::drawIndexedPrimitives(pass, prim.indices.size(), 1, 0, 0, 0);
             }
             SDL_EndGPURenderPass(pass);
         }
@@ -453,18 +455,18 @@ void PbrManager::updateIBL(SDL_GPUTexture *cubemapTexture)
             colorTargetInfo.layer_or_depth_plane = i;
             uniforms.view = m_captureViews[i];
 
-            SDL_GPURenderPass *pass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, nullptr);
+            SDL_GPURenderPass *pass = GPU::beginRenderPass(cmdbuf, &colorTargetInfo, 1, nullptr);
             {
-                SDL_BindGPUGraphicsPipeline(pass, m_irradiancePipeline);
-                SDL_SetGPUViewport(pass, &viewport);
+                GPU::bindGraphicsPipeline(pass, m_irradiancePipeline);
+                GPU::setViewport(pass, &viewport);
 
-                SDL_PushGPUVertexUniformData(cmdbuf, 0, &uniforms, sizeof(uniforms));
-                SDL_BindGPUFragmentSamplers(pass, 0, &hdrBinding, 1);
+                GPU::pushVertexUniformData(cmdbuf, 0, &uniforms, sizeof(uniforms));
+                GPU::bindFragmentSamplers(pass, 0, &hdrBinding, 1);
 
-                SDL_BindGPUVertexBuffers(pass, 0, &vtxBinding, 1);
-                SDL_BindGPUIndexBuffer(pass, &idxBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+                GPU::bindVertexBuffers(pass, 0, &vtxBinding, 1);
+                GPU::bindIndexBuffer(pass, &idxBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
 
-                SDL_DrawGPUIndexedPrimitives(pass, prim.indices.size(), 1, 0, 0, 0);
+                GPU::drawIndexedPrimitives(pass, prim.indices.size(), 1, 0, 0, 0);
             }
             SDL_EndGPURenderPass(pass);
         }
@@ -518,21 +520,21 @@ void PbrManager::updateIBL(SDL_GPUTexture *cubemapTexture)
                 colorTargetInfo.layer_or_depth_plane = i;
                 uniforms.view = m_captureViews[i];
 
-                SDL_GPURenderPass *pass = SDL_BeginGPURenderPass(cmdbuf, &colorTargetInfo, 1, nullptr);
+                SDL_GPURenderPass *pass = GPU::beginRenderPass(cmdbuf, &colorTargetInfo, 1, nullptr);
                 {
-                    SDL_BindGPUGraphicsPipeline(pass, m_prefilterPipeline);
-                    SDL_SetGPUViewport(pass, &viewport);
+                    GPU::bindGraphicsPipeline(pass, m_prefilterPipeline);
+                    GPU::setViewport(pass, &viewport);
 
                     // Push uniforms to both vertex and fragment stages
-                    SDL_PushGPUVertexUniformData(cmdbuf, 0, &uniforms, sizeof(uniforms));
-                    SDL_PushGPUFragmentUniformData(cmdbuf, 0, &fragmentUniform, sizeof(fragmentUniform));
+                    GPU::pushVertexUniformData(cmdbuf, 0, &uniforms, sizeof(uniforms));
+                    GPU::pushFragmentUniformData(cmdbuf, 0, &fragmentUniform, sizeof(fragmentUniform));
 
-                    SDL_BindGPUFragmentSamplers(pass, 0, &hdrBinding, 1);
+                    GPU::bindFragmentSamplers(pass, 0, &hdrBinding, 1);
 
-                    SDL_BindGPUVertexBuffers(pass, 0, &vtxBinding, 1);
-                    SDL_BindGPUIndexBuffer(pass, &idxBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+                    GPU::bindVertexBuffers(pass, 0, &vtxBinding, 1);
+                    GPU::bindIndexBuffer(pass, &idxBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
 
-                    SDL_DrawGPUIndexedPrimitives(pass, prim.indices.size(), 1, 0, 0, 0);
+                    GPU::drawIndexedPrimitives(pass, prim.indices.size(), 1, 0, 0, 0);
                 }
                 SDL_EndGPURenderPass(pass);
             }
@@ -556,40 +558,40 @@ void PbrManager::renderSkybox(
     vertUniforms.projection = projectionMatrix;
 
     // Push uniforms
-    SDL_PushGPUVertexUniformData(commandBuffer, 0, &vertUniforms, sizeof(vertUniforms));
+    GPU::pushVertexUniformData(commandBuffer, 0, &vertUniforms, sizeof(vertUniforms));
 
     if (m_proceduralSkyEnabled)
-        SDL_PushGPUFragmentUniformData(commandBuffer, 0, &m_sunUBO, sizeof(m_sunUBO));
+        GPU::pushFragmentUniformData(commandBuffer, 0, &m_sunUBO, sizeof(m_sunUBO));
     else
-        SDL_PushGPUFragmentUniformData(commandBuffer, 0, &m_skyUBO, sizeof(m_skyUBO));
+        GPU::pushFragmentUniformData(commandBuffer, 0, &m_skyUBO, sizeof(m_skyUBO));
 
     // Bind pipeline
     if (m_proceduralSkyEnabled)
-        SDL_BindGPUGraphicsPipeline(renderPass, m_proceduralSkyboxPipeline);
+        GPU::bindGraphicsPipeline(renderPass, m_proceduralSkyboxPipeline);
     else
-        SDL_BindGPUGraphicsPipeline(renderPass, m_skyboxPipeline);
+        GPU::bindGraphicsPipeline(renderPass, m_skyboxPipeline);
 
     if (m_proceduralSkyEnabled)
     {
         // Bind noise texture
         SDL_GPUTextureSamplerBinding textureSamplerBinding{m_cloudNoiseTexture.id, Utils::baseSampler};
-        SDL_BindGPUFragmentSamplers(renderPass, 0, &textureSamplerBinding, 1);
+        GPU::bindFragmentSamplers(renderPass, 0, &textureSamplerBinding, 1);
     }
     else
     {
         // Bind cubemap texture
         SDL_GPUTextureSamplerBinding textureSamplerBinding{m_cubemapTexture, m_cubeSampler};
-        SDL_BindGPUFragmentSamplers(renderPass, 0, &textureSamplerBinding, 1);
+        GPU::bindFragmentSamplers(renderPass, 0, &textureSamplerBinding, 1);
     }
 
     // Bind vertex buffer
     SDL_GPUBufferBinding vertexBinding{cubePrimitive.vertexBuffer, 0};
-    SDL_BindGPUVertexBuffers(renderPass, 0, &vertexBinding, 1);
+    GPU::bindVertexBuffers(renderPass, 0, &vertexBinding, 1);
 
     // Bind index buffer
     SDL_GPUBufferBinding indexBinding{cubePrimitive.indexBuffer, 0};
-    SDL_BindGPUIndexBuffer(renderPass, &indexBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+    GPU::bindIndexBuffer(renderPass, &indexBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
 
     // Draw the cube
-    SDL_DrawGPUIndexedPrimitives(renderPass, cubePrimitive.indices.size(), 1, 0, 0, 0);
+    GPU::drawIndexedPrimitives(renderPass, cubePrimitive.indices.size(), 1, 0, 0, 0);
 }
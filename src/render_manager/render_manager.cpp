@@ -6,6 +6,8 @@
 
 #include <imgui.h>
 
+#include "../animation/animation_manager.h"
+#include "../gpu/gpu.h"
 #include "../utils/utils.h"
 
 RenderManager::RenderManager(
@@ -23,6 +25,8 @@ RenderManager::RenderManager(
 {
     m_pbrManager = new PbrManager(m_resourceManager);
     m_shadowManager = new ShadowManager();
+    m_lightManager = new LightManager();
+    m_animationManager = new AnimationManager();
 
     createDefaultResources();
     createPipeline(sampleCount);
@@ -35,6 +39,8 @@ RenderManager::~RenderManager()
 {
     delete m_pbrManager;
     delete m_shadowManager;
+    delete m_lightManager;
+    delete m_animationManager;
 
     if (m_pbrPipeline)
         SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrPipeline);
@@ -44,11 +50,23 @@ RenderManager::~RenderManager()
         SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrWireframePipeline);
     if (m_pbrAnimation)
         SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrAnimation);
+    if (m_depthPrepassPipeline)
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_depthPrepassPipeline);
+    if (m_depthPrepassDoubleSided)
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_depthPrepassDoubleSided);
+    if (m_depthPrepassAnimation)
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_depthPrepassAnimation);
+    if (m_pbrDepthEqualPipeline)
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrDepthEqualPipeline);
+    if (m_pbrDepthEqualDoubleSided)
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrDepthEqualDoubleSided);
+    if (m_pbrDepthEqualAnimation)
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrDepthEqualAnimation);
 
     if (m_baseSampler)
         SDL_ReleaseGPUSampler(m_device, m_baseSampler);
     if (m_defaultTexture)
-        SDL_ReleaseGPUTexture(m_device, m_defaultTexture);
+        GPU::releaseTexture(m_device, m_defaultTexture);
 
     if (m_oitPipeline)
         SDL_ReleaseGPUGraphicsPipeline(m_device, m_oitPipeline);
@@ -56,9 +74,9 @@ RenderManager::~RenderManager()
         SDL_ReleaseGPUGraphicsPipeline(m_device, m_compositePipeline);
 
     if (m_accumTexture)
-        SDL_ReleaseGPUTexture(m_device, m_accumTexture);
+        GPU::releaseTexture(m_device, m_accumTexture);
     if (m_revealTexture)
-        SDL_ReleaseGPUTexture(m_device, m_revealTexture);
+        GPU::releaseTexture(m_device, m_revealTexture);
 }
 
 void RenderManager::renderUI()
@@ -68,6 +86,10 @@ void RenderManager::renderUI()
 
     ImGui::PushID(this);
 
+    ImGui::Checkbox("Depth Prepass", &m_depthPrepassEnabled);
+    if (m_depthPrepassActive)
+        ImGui::Text("Alpha Tested Draws: %d", m_alphaTestedDraws);
+
     if (ImGui::TreeNode("Light"))
     {
         if (ImGui::DragFloat3("Light Direction", &m_fragmentUniforms.lightDir.x, 0.01f, 0.f))
@@ -145,6 +167,12 @@ void RenderManager::updateResources(glm::ivec2 screenSize, SDL_GPUSampleCount sa
         SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrDoubleSided);
         SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrWireframePipeline);
         SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrAnimation);
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_depthPrepassPipeline);
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_depthPrepassDoubleSided);
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_depthPrepassAnimation);
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrDepthEqualPipeline);
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrDepthEqualDoubleSided);
+        SDL_ReleaseGPUGraphicsPipeline(m_device, m_pbrDepthEqualAnimation);
         createPipeline(sampleCount);
     }
 
@@ -182,13 +210,13 @@ void RenderManager::createDefaultResources()
     texInfo.height = 1;
     texInfo.layer_count_or_depth = 1;
     texInfo.num_levels = 1;
-    m_defaultTexture = SDL_CreateGPUTexture(m_device, &texInfo);
+    m_defaultTexture = GPU::createTexture(m_device, &texInfo, GPUMemoryCategory::MaterialTexture);
 
     // Upload white pixel
     SDL_GPUTransferBufferCreateInfo transferInfo{};
     transferInfo.size = 4;
     transferInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-    SDL_GPUTransferBuffer *transferBuffer = SDL_CreateGPUTransferBuffer(m_device, &transferInfo);
+    SDL_GPUTransferBuffer *transferBuffer = GPU::createTransferBuffer(m_device, &transferInfo);
     Uint8 *data = (Uint8 *)SDL_MapGPUTransferBuffer(m_device, transferBuffer, false);
     data[0] = 255;
     data[1] = 255;
@@ -205,10 +233,10 @@ void RenderManager::createDefaultResources()
     region.w = 1;
     region.h = 1;
     region.d = 1;
-    SDL_UploadToGPUTexture(copyPass, &tti, &region, 0);
+    GPU::uploadToTexture(copyPass, &tti, &region, false, texInfo.format);
     SDL_EndGPUCopyPass(copyPass);
     SDL_SubmitGPUCommandBuffer(cmd);
-    SDL_ReleaseGPUTransferBuffer(m_device, transferBuffer);
+    GPU::releaseTransferBuffer(m_device, transferBuffer);
 }
 
 void RenderManager::updateOitTextures(glm::ivec2 screenSize)
@@ -219,10 +247,10 @@ void RenderManager::updateOitTextures(glm::ivec2 screenSize)
     m_screenSize = screenSize;
 
     if (m_accumTexture)
-        SDL_ReleaseGPUTexture(m_device, m_accumTexture);
+        GPU::releaseTexture(m_device, m_accumTexture);
 
     if (m_revealTexture)
-        SDL_ReleaseGPUTexture(m_device, m_revealTexture);
+        GPU::releaseTexture(m_device, m_revealTexture);
 
     SDL_GPUTextureCreateInfo info{};
     info.type = SDL_GPU_TEXTURETYPE_2D;
@@ -234,11 +262,11 @@ void RenderManager::updateOitTextures(glm::ivec2 screenSize)
 
     // Accumulation
     info.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
-    m_accumTexture = SDL_CreateGPUTexture(m_device, &info);
+    m_accumTexture = GPU::createTexture(m_device, &info, GPUMemoryCategory::RenderTarget);
 
     // Revealage
     info.format = SDL_GPU_TEXTUREFORMAT_R8_UNORM;
-    m_revealTexture = SDL_CreateGPUTexture(m_device, &info);
+    m_revealTexture = GPU::createTexture(m_device, &info, GPUMemoryCategory::RenderTarget);
 }
 
 void RenderManager::createPipeline(SDL_GPUSampleCount sampleCount)
@@ -246,7 +274,7 @@ void RenderManager::createPipeline(SDL_GPUSampleCount sampleCount)
     m_sampleCount = sampleCount;
 
     SDL_GPUShader *vertexShader = Utils::loadShader("src/shaders/pbr.vert", 0, 1, SDL_GPU_SHADERSTAGE_VERTEX);
-    SDL_GPUShader *fragmentShader = Utils::loadShader("src/shaders/pbr.frag", 10, 4, SDL_GPU_SHADERSTAGE_FRAGMENT);
+    SDL_GPUShader *fragmentShader = Utils::loadShader("src/shaders/pbr.frag", 11, 4, SDL_GPU_SHADERSTAGE_FRAGMENT, 3);
 
     SDL_GPUGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.vertex_shader = vertexShader;
@@ -271,14 +299,15 @@ void RenderManager::createPipeline(SDL_GPUSampleCount sampleCount)
     pipelineInfo.multisample_state.sample_count = sampleCount;
     pipelineInfo.target_info.has_depth_stencil_target = true;
     pipelineInfo.target_info.depth_stencil_format = SDL_GPU_TEXTUREFORMAT_D32_FLOAT;
-    pipelineInfo.target_info.num_color_targets = 1;
+    pipelineInfo.target_info.num_color_targets = 2;
 
     // --- 1. Opaque Pipeline ---
-    SDL_GPUColorTargetDescription opaqueTargetDesc{};
-    opaqueTargetDesc.format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
-    opaqueTargetDesc.blend_state.enable_blend = false; // No blending for opaque
+    SDL_GPUColorTargetDescription opaqueTargetDescs[2]{};
+    opaqueTargetDescs[0].format = SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT;
+    opaqueTargetDescs[0].blend_state.enable_blend = false; // No blending for opaque
+    opaqueTargetDescs[1].format = SDL_GPU_TEXTUREFORMAT_R16G16_FLOAT; // Motion vectors
 
-    pipelineInfo.target_info.color_target_descriptions = &opaqueTargetDesc;
+    pipelineInfo.target_info.color_target_descriptions = opaqueTargetDescs;
 
     pipelineInfo.depth_stencil_state.compare_op = SDL_GPU_COMPAREOP_LESS;
     pipelineInfo.depth_stencil_state.enable_depth_test = true;
@@ -311,7 +340,7 @@ void RenderManager::createPipeline(SDL_GPUSampleCount sampleCount)
     }
 
     //
-    SDL_GPUShader *vertexAnimShader = Utils::loadShader("src/shaders/pbr_skinned.vert", 0, 2, SDL_GPU_SHADERSTAGE_VERTEX);
+    SDL_GPUShader *vertexAnimShader = Utils::loadShader("src/shaders/pbr_skinned.vert", 0, 3, SDL_GPU_SHADERSTAGE_VERTEX);
 
     pipelineInfo.vertex_shader = vertexAnimShader;
     pipelineInfo.fragment_shader = fragmentShader;
@@ -337,10 +366,88 @@ void RenderManager::createPipeline(SDL_GPUSampleCount sampleCount)
         return;
     }
 
+    // --- 1a. Opaque Pipelines Over Prepass Depth ---
+    // LESS_OR_EQUAL without writes, invariant gl_Position keeps both passes on the same depth
+    pipelineInfo.depth_stencil_state.compare_op = SDL_GPU_COMPAREOP_LESS_OR_EQUAL;
+    pipelineInfo.depth_stencil_state.enable_depth_write = false;
+
+    m_pbrDepthEqualAnimation = SDL_CreateGPUGraphicsPipeline(m_device, &pipelineInfo);
+    if (m_pbrDepthEqualAnimation == nullptr)
+        SDL_Log("Failed to create m_pbrDepthEqualAnimation: %s", SDL_GetError());
+
+    pipelineInfo.vertex_shader = vertexShader;
+    pipelineInfo.vertex_input_state.num_vertex_attributes = 4;
+    pipelineInfo.vertex_input_state.vertex_attributes = vertexAttributes;
+
+    m_pbrDepthEqualPipeline = SDL_CreateGPUGraphicsPipeline(m_device, &pipelineInfo);
+    if (m_pbrDepthEqualPipeline == nullptr)
+        SDL_Log("Failed to create m_pbrDepthEqualPipeline: %s", SDL_GetError());
+
+    pipelineInfo.rasterizer_state.cull_mode = SDL_GPU_CULLMODE_NONE;
+    m_pbrDepthEqualDoubleSided = SDL_CreateGPUGraphicsPipeline(m_device, &pipelineInfo);
+    if (m_pbrDepthEqualDoubleSided == nullptr)
+        SDL_Log("Failed to create m_pbrDepthEqualDoubleSided: %s", SDL_GetError());
+
     SDL_ReleaseGPUShader(m_device, fragmentShader);
+    SDL_ReleaseGPUShader(m_device, vertexAnimShader);
+
+    // --- 1b. Depth Prepass Pipelines (position only, no color targets) ---
+    {
+        SDL_GPUShader *depthVert = Utils::loadShader("src/shaders/depth_prepass.vert", 0, 1, SDL_GPU_SHADERSTAGE_VERTEX);
+        SDL_GPUShader *depthAnimVert = Utils::loadShader("src/shaders/depth_prepass_skinned.vert", 0, 2, SDL_GPU_SHADERSTAGE_VERTEX);
+        SDL_GPUShader *depthFrag = Utils::loadShader("src/shaders/depth_only.frag", 0, 0, SDL_GPU_SHADERSTAGE_FRAGMENT);
+
+        SDL_GPUGraphicsPipelineCreateInfo depthInfo{};
+        depthInfo.vertex_shader = depthVert;
+        depthInfo.fragment_shader = depthFrag;
+        depthInfo.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
+
+        SDL_GPUVertexAttribute depthAttributes[1]{};
+        depthAttributes[0] = {0, 0, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(Vertex, position)};
+        depthInfo.vertex_input_state.num_vertex_buffers = 1;
+        depthInfo.vertex_input_state.vertex_buffer_descriptions = vertexBufferDesc;
+        depthInfo.vertex_input_state.num_vertex_attributes = 1;
+        depthInfo.vertex_input_state.vertex_attributes = depthAttributes;
+
+        depthInfo.multisample_state.sample_count = sampleCount;
+        depthInfo.target_info.has_depth_stencil_target = true;
+        depthInfo.target_info.depth_stencil_format = SDL_GPU_TEXTUREFORMAT_D32_FLOAT;
+        depthInfo.target_info.num_color_targets = 0;
+
+        depthInfo.depth_stencil_state.compare_op = SDL_GPU_COMPAREOP_LESS;
+        depthInfo.depth_stencil_state.enable_depth_test = true;
+        depthInfo.depth_stencil_state.enable_depth_write = true;
+
+        depthInfo.rasterizer_state.cull_mode = SDL_GPU_CULLMODE_BACK;
+        m_depthPrepassPipeline = SDL_CreateGPUGraphicsPipeline(m_device, &depthInfo);
+        if (m_depthPrepassPipeline == nullptr)
+            SDL_Log("Failed to create m_depthPrepassPipeline: %s", SDL_GetError());
+
+        depthInfo.rasterizer_state.cull_mode = SDL_GPU_CULLMODE_NONE;
+        m_depthPrepassDoubleSided = SDL_CreateGPUGraphicsPipeline(m_device, &depthInfo);
+        if (m_depthPrepassDoubleSided == nullptr)
+            SDL_Log("Failed to create m_depthPrepassDoubleSided: %s", SDL_GetError());
+
+        SDL_GPUVertexAttribute depthAnimAttributes[3]{};
+        depthAnimAttributes[0] = {0, 0, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, offsetof(Vertex, position)};
+        depthAnimAttributes[1] = {4, 0, SDL_GPU_VERTEXELEMENTFORMAT_UINT4, offsetof(Vertex, joints)};
+        depthAnimAttributes[2] = {5, 0, SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, offsetof(Vertex, weights)};
+        depthInfo.vertex_shader = depthAnimVert;
+        depthInfo.vertex_input_state.num_vertex_attributes = 3;
+        depthInfo.vertex_input_state.vertex_attributes = depthAnimAttributes;
+        depthInfo.rasterizer_state.cull_mode = SDL_GPU_CULLMODE_BACK;
+
+        m_depthPrepassAnimation = SDL_CreateGPUGraphicsPipeline(m_device, &depthInfo);
+        if (m_depthPrepassAnimation == nullptr)
+            SDL_Log("Failed to create m_depthPrepassAnimation: %s", SDL_GetError());
+
+        SDL_ReleaseGPUShader(m_device, depthVert);
+        SDL_ReleaseGPUShader(m_device, depthAnimVert);
+        SDL_ReleaseGPUShader(m_device, depthFrag);
+    }
 
     // --- 2. OIT Geometry Pipeline ---
-    SDL_GPUShader *oitShader = Utils::loadShader("src/shaders/pbr_oit.frag", 10, 4, SDL_GPU_SHADERSTAGE_FRAGMENT);
+    SDL_GPUShader *oitShader = Utils::loadShader("src/shaders/pbr_oit.frag", 11, 4, SDL_GPU_SHADERSTAGE_FRAGMENT, 3);
 
     pipelineInfo = SDL_GPUGraphicsPipelineCreateInfo{};
     pipelineInfo.vertex_shader = vertexShader;
@@ -435,6 +542,63 @@ void RenderManager::createPipeline(SDL_GPUSampleCount sampleCount)
     SDL_ReleaseGPUShader(m_device, oitCompositeShader);
 }
 
+void RenderManager::renderDepth(
+    SDL_GPUCommandBuffer *cmd,
+    SDL_GPURenderPass *pass,
+    const glm::mat4 &view,
+    const glm::mat4 &projection)
+{
+    Frustum frustum = Frustum::fromMatrix(projection * view);
+
+    GPU::bindGraphicsPipeline(pass, m_depthPrepassPipeline);
+    for (Renderable *r : m_renderables)
+        r->renderDepth(cmd, pass, view, projection, frustum);
+
+    GPU::bindGraphicsPipeline(pass, m_depthPrepassDoubleSided);
+    for (Renderable *r : m_renderables)
+        r->renderDepthDoubleSided(cmd, pass, view, projection, frustum);
+
+    GPU::bindGraphicsPipeline(pass, m_depthPrepassAnimation);
+    for (Renderable *r : m_renderables)
+        r->renderAnimationDepth(cmd, pass, view, projection, frustum);
+}
+
+void RenderManager::bindOpaquePipeline(
+    SDL_GPUCommandBuffer *cmd,
+    SDL_GPURenderPass *pass,
+    SDL_GPUGraphicsPipeline *pipeline,
+    SDL_GPUGraphicsPipeline *depthEqualPipeline)
+{
+    m_opaquePipeline = pipeline;
+    m_opaqueDepthEqualPipeline = (m_depthPrepassActive && depthEqualPipeline) ? depthEqualPipeline : nullptr;
+    m_boundOpaquePipeline = m_opaqueDepthEqualPipeline ? m_opaqueDepthEqualPipeline : pipeline;
+
+    GPU::bindGraphicsPipeline(pass, m_boundOpaquePipeline);
+
+    GPU::pushFragmentUniformData(cmd, 0, &m_fragmentUniforms, sizeof(FragmentUniforms));
+    GPU::pushFragmentUniformData(cmd, 2, &m_shadowManager->m_shadowUniforms, sizeof(ShadowUniforms));
+    GPU::pushFragmentUniformData(cmd, 3, &m_fogUBO, sizeof(FogUniforms));
+    m_lightManager->bindBuffers(pass);
+}
+
+void RenderManager::selectOpaquePipeline(SDL_GPURenderPass *pass, bool alphaTested)
+{
+    if (!m_opaqueDepthEqualPipeline)
+        return;
+
+    // Alpha tested surfaces are not in the prepass, they test and write depth themselves
+    if (alphaTested)
+        m_alphaTestedDraws++;
+
+    SDL_GPUGraphicsPipeline *pipeline = alphaTested ? m_opaquePipeline : m_opaqueDepthEqualPipeline;
+    if (pipeline == m_boundOpaquePipeline)
+        return;
+
+    GPU::bindGraphicsPipeline(pass, pipeline);
+    m_lightManager->bindBuffers(pass);
+    m_boundOpaquePipeline = pipeline;
+}
+
 void RenderManager::renderOpaque(
     SDL_GPUCommandBuffer *cmd,
     SDL_GPURenderPass *pass,
@@ -442,11 +606,9 @@ void RenderManager::renderOpaque(
     const glm::mat4 &projection,
     const glm::vec3 &camPos)
 {
-    SDL_BindGPUGraphicsPipeline(pass, m_pbrPipeline);
+    m_alphaTestedDraws = 0;
 
-    SDL_PushGPUFragmentUniformData(cmd, 0, &m_fragmentUniforms, sizeof(FragmentUniforms));
-    SDL_PushGPUFragmentUniformData(cmd, 2, &m_shadowManager->m_shadowUniforms, sizeof(ShadowUniforms));
-    SDL_PushGPUFragmentUniformData(cmd, 3, &m_fogUBO, sizeof(FogUniforms));
+    bindOpaquePipeline(cmd, pass, m_pbrPipeline, m_pbrDepthEqualPipeline);
 
     Frustum frustum = Frustum::fromMatrix(projection * view);
 
@@ -455,25 +617,19 @@ void RenderManager::renderOpaque(
 
     // ---
 
-    SDL_BindGPUGraphicsPipeline(pass, m_pbrDoubleSided);
-
-    SDL_PushGPUFragmentUniformData(cmd, 0, &m_fragmentUniforms, sizeof(FragmentUniforms));
-    SDL_PushGPUFragmentUniformData(cmd, 2, &m_shadowManager->m_shadowUniforms, sizeof(ShadowUniforms));
-    SDL_PushGPUFragmentUniformData(cmd, 3, &m_fogUBO, sizeof(FogUniforms));
+    bindOpaquePipeline(cmd, pass, m_pbrDoubleSided, m_pbrDepthEqualDoubleSided);
 
     for (Renderable *r : m_renderables)
         r->renderOpaqueDoubleSided(cmd, pass, view, projection, frustum);
 
     // ---
 
-    SDL_BindGPUGraphicsPipeline(pass, m_pbrAnimation);
-
-    SDL_PushGPUFragmentUniformData(cmd, 0, &m_fragmentUniforms, sizeof(FragmentUniforms));
-    SDL_PushGPUFragmentUniformData(cmd, 2, &m_shadowManager->m_shadowUniforms, sizeof(ShadowUniforms));
-    SDL_PushGPUFragmentUniformData(cmd, 3, &m_fogUBO, sizeof(FogUniforms));
+    bindOpaquePipeline(cmd, pass, m_pbrAnimation, m_pbrDepthEqualAnimation);
 
     for (Renderable *r : m_renderables)
         r->renderAnimation(cmd, pass, view, projection, frustum);
+
+    m_opaqueDepthEqualPipeline = nullptr;
 }
 
 void RenderManager::renderTransparent(
@@ -486,12 +642,13 @@ void RenderManager::renderTransparent(
     Frustum frustum = Frustum::fromMatrix(projection * view);
 
     // --- PASS 3: TRANSPARENT ---
-    SDL_BindGPUGraphicsPipeline(pass, m_oitPipeline);
+    GPU::bindGraphicsPipeline(pass, m_oitPipeline);
 
     // TODO: ?
-    SDL_PushGPUFragmentUniformData(cmd, 0, &m_fragmentUniforms, sizeof(FragmentUniforms));
-    SDL_PushGPUFragmentUniformData(cmd, 2, &m_shadowManager->m_shadowUniforms, sizeof(ShadowUniforms));
-    SDL_PushGPUFragmentUniformData(cmd, 3, &m_fogUBO, sizeof(FogUniforms));
+    GPU::pushFragmentUniformData(cmd, 0, &m_fragmentUniforms, sizeof(FragmentUniforms));
+    GPU::pushFragmentUniformData(cmd, 2, &m_shadowManager->m_shadowUniforms, sizeof(ShadowUniforms));
+    GPU::pushFragmentUniformData(cmd, 3, &m_fogUBO, sizeof(FogUniforms));
+    m_lightManager->bindBuffers(pass);
 
     for (Renderable *r : m_renderables)
         r->renderTransparent(cmd, pass, view, projection, frustum);
@@ -501,13 +658,13 @@ void RenderManager::renderComposite(
     SDL_GPUCommandBuffer *cmd,
     SDL_GPURenderPass *pass)
 {
-    SDL_BindGPUGraphicsPipeline(pass, m_compositePipeline);
+    GPU::bindGraphicsPipeline(pass, m_compositePipeline);
 
     // TODO: clamped sampler?
     SDL_GPUTextureSamplerBinding bindings[2];
     bindings[0] = {m_accumTexture, m_baseSampler};  // Accum
     bindings[1] = {m_revealTexture, m_baseSampler}; // Reveal
 
-    SDL_BindGPUFragmentSamplers(pass, 0, bindings, 2);
-    SDL_DrawGPUPrimitives(pass, 3, 1, 0, 0); // Draw fullscreen triangle
+    GPU::bindFragmentSamplers(pass, 0, bindings, 2);
+    GPU::drawPrimitives(pass, 3, 1, 0, 0); // Draw fullscreen triangle
 }
@@ -7,17 +7,23 @@
 #include <glm/glm.hpp>
 
 #include "../frustum.h"
+#include "../light_manager/light_manager.h"
 #include "../resource_manager/resource_manager.h"
 #include "../shadow_manager/shadow_manager.h"
 
 #include "pbr_manager.h"
 
+class AnimationManager;
+
 struct VertexUniforms
 {
     glm::mat4 model;
     glm::mat4 view;
     glm::mat4 projection;
     glm::mat4 normalMatrix;
+    glm::mat4 prevModel;
+    glm::mat4 prevViewProjection;
+    glm::vec4 jitter; // xy = NDC offset in projection
 };
 
 struct FragmentUniforms
@@ -28,6 +34,7 @@ struct FragmentUniforms
     float padding2;
     glm::vec3 lightColor;
     float padding3;
+    ClusterUniforms cluster;
 };
 
 struct MaterialUniforms
@@ -94,6 +101,24 @@ public:
         const glm::mat4 &view,
         const glm::mat4 &projection,
         const Frustum &frustum) {};
+    virtual void renderDepth(
+        SDL_GPUCommandBuffer *cmd,
+        SDL_GPURenderPass *pass,
+        const glm::mat4 &view,
+        const glm::mat4 &projection,
+        const Frustum &frustum) {};
+    virtual void renderDepthDoubleSided(
+        SDL_GPUCommandBuffer *cmd,
+        SDL_GPURenderPass *pass,
+        const glm::mat4 &view,
+        const glm::mat4 &projection,
+        const Frustum &frustum) {};
+    virtual void renderAnimationDepth(
+        SDL_GPUCommandBuffer *cmd,
+        SDL_GPURenderPass *pass,
+        const glm::mat4 &view,
+        const glm::mat4 &projection,
+        const Frustum &frustum) {};
     virtual void renderShadow(
         SDL_GPUCommandBuffer *cmd,
         SDL_GPURenderPass *pass,
@@ -109,6 +134,9 @@ public:
         SDL_GPURenderPass *pass,
         const glm::mat4 &viewProj,
         const Frustum &frustum) {};
+
+    // Static casters are cached by the ShadowManager and only redrawn when a cascade moves
+    virtual bool isStaticShadowCaster() { return false; };
 };
 
 class RenderManager : public BaseUI
@@ -125,16 +153,39 @@ public:
     FogUniforms m_fogUBO;
     bool m_uiDefaultOpen = true;
 
+    // Opaque depth is laid down first, the main pass then shades only visible fragments
+    bool m_depthPrepassEnabled = false;
+    bool m_depthPrepassActive = false; // set per frame by the runner
+    int m_alphaTestedDraws = 0;        // masked draws write depth the prepass doesn't have
+
+    // Motion vectors, set per frame by the runner
+    Uint64 m_frameIndex = 0;
+    glm::vec2 m_jitter{0.f};                 // TAA sub-pixel offset baked into the projection
+    glm::mat4 m_prevViewProjection{1.f};     // unjittered
+
     SDL_GPUDevice *m_device;
     SDL_Window *m_window;
     ResourceManager *m_resourceManager;
     PbrManager *m_pbrManager;
     ShadowManager *m_shadowManager;
+    LightManager *m_lightManager;
+    AnimationManager *m_animationManager; // animators of the renderables, updated by the runner
 
     SDL_GPUGraphicsPipeline *m_pbrPipeline;
     SDL_GPUGraphicsPipeline *m_pbrDoubleSided;
     SDL_GPUGraphicsPipeline *m_pbrWireframePipeline;
     SDL_GPUGraphicsPipeline *m_pbrAnimation;
+    SDL_GPUGraphicsPipeline *m_depthPrepassPipeline = nullptr;
+    SDL_GPUGraphicsPipeline *m_depthPrepassDoubleSided = nullptr;
+    SDL_GPUGraphicsPipeline *m_depthPrepassAnimation = nullptr;
+    SDL_GPUGraphicsPipeline *m_pbrDepthEqualPipeline = nullptr;
+    SDL_GPUGraphicsPipeline *m_pbrDepthEqualDoubleSided = nullptr;
+    SDL_GPUGraphicsPipeline *m_pbrDepthEqualAnimation = nullptr;
+
+    // Opaque batch state, alpha tested primitives switch back to the depth writing pipeline
+    SDL_GPUGraphicsPipeline *m_opaquePipeline = nullptr;
+    SDL_GPUGraphicsPipeline *m_opaqueDepthEqualPipeline = nullptr;
+    SDL_GPUGraphicsPipeline *m_boundOpaquePipeline = nullptr;
     SDL_GPUSampler *m_baseSampler;
     SDL_GPUTexture *m_defaultTexture;
 
@@ -165,6 +216,17 @@ public:
     void createPipeline(SDL_GPUSampleCount sampleCount);
 
     // Rendering
+    void bindOpaquePipeline(
+        SDL_GPUCommandBuffer *cmd,
+        SDL_GPURenderPass *pass,
+        SDL_GPUGraphicsPipeline *pipeline,
+        SDL_GPUGraphicsPipeline *depthEqualPipeline);
+    void selectOpaquePipeline(SDL_GPURenderPass *pass, bool alphaTested);
+    void renderDepth(
+        SDL_GPUCommandBuffer *cmd,
+        SDL_GPURenderPass *pass,
+        const glm::mat4 &view,
+        const glm::mat4 &projection);
     void renderOpaque(
         SDL_GPUCommandBuffer *cmd,
         SDL_GPURenderPass *pass,
@@ -5,6 +5,8 @@
 #include <SDL3/SDL_log.h>
 #include <cstring>
 
+#include "../gpu/gpu.h"
+
 // DDS Format Constants
 const Uint32 DDS_MAGIC = 0x20534444; // "DDS "
 
@@ -198,7 +200,7 @@ public:
         texInfo.num_levels = mipLevels;
         texInfo.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER;
 
-        SDL_GPUTexture *texture = SDL_CreateGPUTexture(device, &texInfo);
+        SDL_GPUTexture *texture = GPU::createTexture(device, &texInfo, GPUMemoryCategory::Other);
         if (!texture)
         {
             SDL_Log("DDS: Failed to create GPU texture: %s", SDL_GetError());
@@ -209,7 +211,7 @@ public:
         if (!UploadTextureData(device, texture, ptr, width, height,
                                mipLevels, isCompressed, blockSize))
         {
-            SDL_ReleaseGPUTexture(device, texture);
+            GPU::releaseTexture(device, texture);
             return nullptr;
         }
 
@@ -231,7 +233,7 @@ public:
         {
             if (info->texture)
             {
-                SDL_ReleaseGPUTexture(device, info->texture);
+                GPU::releaseTexture(device, info->texture);
             }
             delete info;
         }
@@ -565,7 +567,7 @@ private:
             transferInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
 
             SDL_GPUTransferBuffer *transferBuffer =
-                SDL_CreateGPUTransferBuffer(device, &transferInfo);
+                GPU::createTransferBuffer(device, &transferInfo);
 
             if (!transferBuffer)
             {
@@ -601,7 +603,7 @@ private:
             SDL_EndGPUCopyPass(copyPass);
             SDL_SubmitGPUCommandBuffer(cmd);
 
-            SDL_ReleaseGPUTransferBuffer(device, transferBuffer);
+            GPU::releaseTransferBuffer(device, transferBuffer);
 
             srcPtr += mipSize;
         }
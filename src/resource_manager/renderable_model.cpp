@@ -1,5 +1,8 @@
 #include "renderable_model.h"
 
+#include "../animation/animation_manager.h"
+#include "../gpu/gpu.h"
+
 // Helper for Culling
 float ExtractMaxScale(const glm::mat4 &m)
 {
@@ -14,12 +17,15 @@ bool PrimitiveInFrustum(const PrimitiveData &prim, const glm::mat4 &worldTransfo
     glm::vec3 worldCenter = glm::vec3(worldTransform * glm::vec4(prim.sphereCenter, 1.0f));
     float maxScale = ExtractMaxScale(worldTransform);
     float worldRadius = prim.sphereRadius * maxScale;
-    return frustum.intersectsSphere(worldCenter, worldRadius);
+    bool visible = frustum.intersectsSphere(worldCenter, worldRadius);
+    GPU::countCulling(visible);
+    return visible;
 }
 
 void RenderableModel::renderPrimitive(
     const PrimitiveData &prim,
     const glm::mat4 &model,
+    const glm::mat4 &prevModel,
     const glm::mat4 &cullModel,
     bool blend,
     bool checkDoubleSide,
@@ -46,13 +52,19 @@ void RenderableModel::renderPrimitive(
     if (checkDoubleSide && mat->doubleSided != doubleSide)
         return;
 
+    if (!blend)
+        renderManager->selectOpaquePipeline(pass, mat->alphaMode == AlphaMode::Mask);
+
     // Update Model Matrix
     VertexUniforms vUniforms{};
     vUniforms.view = view;
     vUniforms.projection = projection;
     vUniforms.model = model;
     vUniforms.normalMatrix = glm::transpose(glm::inverse(model));
-    SDL_PushGPUVertexUniformData(cmd, 0, &vUniforms, sizeof(vUniforms));
+    vUniforms.prevModel = prevModel;
+    vUniforms.prevViewProjection = renderManager->m_prevViewProjection;
+    vUniforms.jitter = glm::vec4(renderManager->m_jitter, 0.f, 0.f);
+    GPU::pushVertexUniformData(cmd, 0, &vUniforms, sizeof(vUniforms));
 
     // Material Setup
     MaterialUniforms matUniforms{};
@@ -73,24 +85,24 @@ void RenderableModel::renderPrimitive(
     matUniforms.hasEmissiveTexture = (mat->emissiveTexture.id != nullptr);
     matUniforms.hasOpacityTexture = (mat->opacityTexture.id != nullptr);
 
-    SDL_PushGPUFragmentUniformData(cmd, 1, &matUniforms, sizeof(matUniforms));
+    GPU::pushFragmentUniformData(cmd, 1, &matUniforms, sizeof(matUniforms));
 
     // Bind Textures
     RenderableModel::bindTextures(renderManager, pass, mat);
 
     // Bind Buffers & Draw
     SDL_GPUBufferBinding vb{prim.vertexBuffer, 0};
-    SDL_BindGPUVertexBuffers(pass, 0, &vb, 1);
+    GPU::bindVertexBuffers(pass, 0, &vb, 1);
 
     if (!prim.indices.empty())
     {
         SDL_GPUBufferBinding ib{prim.indexBuffer, 0};
-        SDL_BindGPUIndexBuffer(pass, &ib, SDL_GPU_INDEXELEMENTSIZE_32BIT);
-        SDL_DrawGPUIndexedPrimitives(pass, (Uint32)prim.indices.size(), 1, 0, 0, 0);
+        GPU::bindIndexBuffer(pass, &ib, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+        GPU::drawIndexedPrimitives(pass, (Uint32)prim.indices.size(), 1, 0, 0, 0);
     }
     else
     {
-        SDL_DrawGPUPrimitives(pass, (Uint32)prim.vertices.size(), 1, 0, 0);
+        GPU::drawPrimitives(pass, (Uint32)prim.vertices.size(), 1, 0, 0);
     }
 }
 
@@ -104,22 +116,69 @@ void RenderableModel::renderModel(
     const glm::mat4 &projection,
     const Frustum &frustum)
 {
-    for (const auto &node : m_model->nodes)
+    updateMotion();
+
+    for (size_t i = 0; i < m_model->nodes.size(); ++i)
     {
+        const auto &node = m_model->nodes[i];
         if (node.meshIndex < 0 || node.meshIndex >= m_model->meshes.size())
             continue;
 
         const MeshData &mesh = m_model->meshes[node.meshIndex];
-        const glm::mat4 &world = node.offset * (m_animator ? m_animator->m_finalBoneMatrices[0] : node.worldTransform);
+        const glm::mat4 &world = m_nodeTransforms[i];
+        const glm::mat4 &prevWorld = m_prevNodeTransforms[i];
         const glm::mat4 cullWorld = m_cullOffset * world;
 
         for (const auto &prim : mesh.primitives)
         {
-            renderPrimitive(prim, world, cullWorld, blend, checkDoubleSide, doubleSide, m_manager, cmd, pass, view, projection, frustum);
+            renderPrimitive(prim, world, prevWorld, cullWorld, blend, checkDoubleSide, doubleSide, m_manager, cmd, pass, view, projection, frustum);
         }
     }
 }
 
+RenderableModel::~RenderableModel()
+{
+    setAnimator(nullptr);
+}
+
+void RenderableModel::setAnimator(Animator *animator)
+{
+    if (m_animator)
+        m_manager->m_animationManager->remove(m_animator);
+
+    m_animator = animator;
+    if (m_animator)
+        m_manager->m_animationManager->add(m_animator);
+}
+
+void RenderableModel::updateMotion()
+{
+    if (m_motionFrame == m_manager->m_frameIndex && !m_nodeTransforms.empty())
+        return;
+
+    bool firstFrame = m_nodeTransforms.size() != m_model->nodes.size();
+    m_motionFrame = m_manager->m_frameIndex;
+
+    m_prevNodeTransforms.swap(m_nodeTransforms);
+    m_nodeTransforms.resize(m_model->nodes.size());
+    for (size_t i = 0; i < m_model->nodes.size(); ++i)
+    {
+        const auto &node = m_model->nodes[i];
+        m_nodeTransforms[i] = node.offset * (m_animator ? m_animator->m_finalBoneMatrices[0] : node.worldTransform);
+    }
+
+    if (firstFrame)
+        m_prevNodeTransforms = m_nodeTransforms;
+
+    if (!m_animator)
+        return;
+
+    m_prevBoneMatrices.swap(m_boneMatrices);
+    m_boneMatrices = m_animator->m_finalBoneMatrices;
+    if (m_prevBoneMatrices.size() != m_boneMatrices.size())
+        m_prevBoneMatrices = m_boneMatrices;
+}
+
 void RenderableModel::renderOpaque(
     SDL_GPUCommandBuffer *cmd,
     SDL_GPURenderPass *pass,
@@ -169,13 +228,116 @@ void RenderableModel::renderAnimation(
     if (!m_animator)
         return;
 
-    size_t boneCount = m_animator->m_finalBoneMatrices.size();
+    updateMotion();
+
+    size_t boneCount = m_boneMatrices.size();
     size_t bytes = boneCount * sizeof(glm::mat4);
-    SDL_PushGPUVertexUniformData(cmd, 1, m_animator->m_finalBoneMatrices.data(), bytes);
+    GPU::pushVertexUniformData(cmd, 1, m_boneMatrices.data(), bytes);
+    GPU::pushVertexUniformData(cmd, 2, m_prevBoneMatrices.data(), bytes);
 
     renderModel(false, false, false, cmd, pass, view, projection, frustum);
 }
 
+void RenderableModel::renderModelDepth(
+    bool checkDoubleSide,
+    bool doubleSide,
+    SDL_GPUCommandBuffer *cmd,
+    SDL_GPURenderPass *pass,
+    const glm::mat4 &view,
+    const glm::mat4 &projection,
+    const Frustum &frustum)
+{
+    VertexUniforms vUniforms{};
+    vUniforms.view = view;
+    vUniforms.projection = projection;
+
+    for (const auto &node : m_model->nodes)
+    {
+        if (node.meshIndex < 0 || node.meshIndex >= m_model->meshes.size())
+            continue;
+
+        const MeshData &mesh = m_model->meshes[node.meshIndex];
+        const glm::mat4 &world = node.offset * (m_animator ? m_animator->m_finalBoneMatrices[0] : node.worldTransform);
+        const glm::mat4 cullWorld = m_cullOffset * world;
+
+        for (const auto &prim : mesh.primitives)
+        {
+            static Material defaultMaterial("default");
+            Material *mat = prim.material ? prim.material : &defaultMaterial;
+
+            // Alpha tested and blended surfaces need their textures, leave them to the main passes
+            if (mat->alphaMode != AlphaMode::Opaque)
+                continue;
+
+            if (checkDoubleSide && mat->doubleSided != doubleSide)
+                continue;
+
+            if (!PrimitiveInFrustum(prim, cullWorld, frustum))
+                continue;
+
+            vUniforms.model = world;
+            GPU::pushVertexUniformData(cmd, 0, &vUniforms, sizeof(vUniforms));
+
+            SDL_GPUBufferBinding vb{prim.vertexBuffer, 0};
+            GPU::bindVertexBuffers(pass, 0, &vb, 1);
+
+            if (!prim.indices.empty())
+            {
+                SDL_GPUBufferBinding ib{prim.indexBuffer, 0};
+                GPU::bindIndexBuffer(pass, &ib, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+                GPU::drawIndexedPrimitives(pass, (Uint32)prim.indices.size(), 1, 0, 0, 0);
+            }
+            else
+            {
+                GPU::drawPrimitives(pass, (Uint32)prim.vertices.size(), 1, 0, 0);
+            }
+        }
+    }
+}
+
+void RenderableModel::renderDepth(
+    SDL_GPUCommandBuffer *cmd,
+    SDL_GPURenderPass *pass,
+    const glm::mat4 &view,
+    const glm::mat4 &projection,
+    const Frustum &frustum)
+{
+    if (m_animator)
+        return;
+
+    renderModelDepth(true, false, cmd, pass, view, projection, frustum);
+}
+
+void RenderableModel::renderDepthDoubleSided(
+    SDL_GPUCommandBuffer *cmd,
+    SDL_GPURenderPass *pass,
+    const glm::mat4 &view,
+    const glm::mat4 &projection,
+    const Frustum &frustum)
+{
+    if (m_animator)
+        return;
+
+    renderModelDepth(true, true, cmd, pass, view, projection, frustum);
+}
+
+void RenderableModel::renderAnimationDepth(
+    SDL_GPUCommandBuffer *cmd,
+    SDL_GPURenderPass *pass,
+    const glm::mat4 &view,
+    const glm::mat4 &projection,
+    const Frustum &frustum)
+{
+    if (!m_animator)
+        return;
+
+    size_t boneCount = m_animator->m_finalBoneMatrices.size();
+    size_t bytes = boneCount * sizeof(glm::mat4);
+    GPU::pushVertexUniformData(cmd, 1, m_animator->m_finalBoneMatrices.data(), bytes);
+
+    renderModelDepth(false, false, cmd, pass, view, projection, frustum);
+}
+
 void RenderableModel::renderModelShadow(
     bool checkDoubleSide,
     bool doubleSide,
@@ -211,20 +373,20 @@ void RenderableModel::renderModelShadow(
                 continue;
 
             shadowUniforms.model = world;
-            SDL_PushGPUVertexUniformData(cmd, 0, &shadowUniforms, sizeof(shadowUniforms));
+            GPU::pushVertexUniformData(cmd, 0, &shadowUniforms, sizeof(shadowUniforms));
 
             SDL_GPUBufferBinding vb{prim.vertexBuffer, 0};
-            SDL_BindGPUVertexBuffers(pass, 0, &vb, 1);
+            GPU::bindVertexBuffers(pass, 0, &vb, 1);
 
             if (!prim.indices.empty())
             {
                 SDL_GPUBufferBinding ib{prim.indexBuffer, 0};
-                SDL_BindGPUIndexBuffer(pass, &ib, SDL_GPU_INDEXELEMENTSIZE_32BIT);
-                SDL_DrawGPUIndexedPrimitives(pass, (Uint32)prim.indices.size(), 1, 0, 0, 0);
+                GPU::bindIndexBuffer(pass, &ib, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+                GPU::drawIndexedPrimitives(pass, (Uint32)prim.indices.size(), 1, 0, 0, 0);
             }
             else
             {
-                SDL_DrawGPUPrimitives(pass, (Uint32)prim.vertices.size(), 1, 0, 0);
+                GPU::drawPrimitives(pass, (Uint32)prim.vertices.size(), 1, 0, 0);
             }
         }
     }
@@ -274,14 +436,19 @@ void RenderableModel::renderAnimationShadow(
 
     size_t boneCount = m_animator->m_finalBoneMatrices.size();
     size_t bytes = boneCount * sizeof(glm::mat4);
-    SDL_PushGPUVertexUniformData(cmd, 1, m_animator->m_finalBoneMatrices.data(), bytes);
+    GPU::pushVertexUniformData(cmd, 1, m_animator->m_finalBoneMatrices.data(), bytes);
 
     renderModelShadow(false, false, cmd, pass, viewProj, frustum);
 }
 
+bool RenderableModel::isStaticShadowCaster()
+{
+    return m_staticShadowCaster && !m_animator;
+}
+
 void RenderableModel::bindTextures(RenderManager *renderManager, SDL_GPURenderPass *pass, Material *mat)
 {
-    SDL_GPUTextureSamplerBinding bindings[10];
+    SDL_GPUTextureSamplerBinding bindings[11];
     SDL_GPUTexture *def = renderManager->m_defaultTexture;
     SDL_GPUSampler *samp = renderManager->m_baseSampler;
 
@@ -299,7 +466,11 @@ void RenderableModel::bindTextures(RenderManager *renderManager, SDL_GPURenderPa
     bindings[8] = {pbr->m_brdfTexture, pbr->m_brdfSampler};
 
     // Shadowmap
-    bindings[9] = {renderManager->m_shadowManager->m_shadowMapTexture, renderManager->m_shadowManager->m_shadowSampler};
+    bindings[9] = renderManager->m_shadowManager->getShadowMapBinding();
+
+    // Screen-space shadow mask, only read when ShadowUniforms::screenMask is set
+    SDL_GPUTexture *shadowMask = renderManager->m_shadowManager->m_shadowMaskTexture;
+    bindings[10] = {shadowMask ? shadowMask : def, renderManager->m_shadowManager->m_shadowSampler};
 
-    SDL_BindGPUFragmentSamplers(pass, 0, bindings, 10);
+    GPU::bindFragmentSamplers(pass, 0, bindings, 11);
 }
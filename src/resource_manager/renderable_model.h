@@ -16,6 +16,8 @@ public:
     ModelData *m_model;
     RenderManager *m_manager;
     bool m_castingShadow;
+    // Set when the model never moves, animated models are always dynamic
+    bool m_staticShadowCaster = false;
     glm::mat4 m_cullOffset{1.f};
 
     RenderableModel(ModelData *m, RenderManager *rm)
@@ -24,12 +26,26 @@ public:
           m_castingShadow(true)
     {
     }
+    ~RenderableModel();
 
-    Animator *m_animator = nullptr;
+    // The only way to attach an animator: it is handed to the render manager's AnimationManager,
+    // which updates it once per frame, owners must not update it themselves
+    void setAnimator(Animator *animator);
+    Animator *getAnimator() const { return m_animator; }
+
+    // Last frame's transforms for motion vectors, rolled over on the first draw of a frame
+    Uint64 m_motionFrame = 0;
+    std::vector<glm::mat4> m_nodeTransforms;
+    std::vector<glm::mat4> m_prevNodeTransforms;
+    std::vector<glm::mat4> m_boneMatrices;
+    std::vector<glm::mat4> m_prevBoneMatrices;
+
+    void updateMotion();
 
     static void renderPrimitive(
         const PrimitiveData &prim,
         const glm::mat4 &model,
+        const glm::mat4 &prevModel,
         const glm::mat4 &cullModel,
         bool blend,
         bool checkDoubleSide,
@@ -76,6 +92,34 @@ public:
         const glm::mat4 &projection,
         const Frustum &frustum) override;
 
+    void renderModelDepth(
+        bool checkDoubleSide,
+        bool doubleSide,
+        SDL_GPUCommandBuffer *cmd,
+        SDL_GPURenderPass *pass,
+        const glm::mat4 &view,
+        const glm::mat4 &projection,
+        const Frustum &frustum);
+
+    void renderDepth(
+        SDL_GPUCommandBuffer *cmd,
+        SDL_GPURenderPass *pass,
+        const glm::mat4 &view,
+        const glm::mat4 &projection,
+        const Frustum &frustum) override;
+    void renderDepthDoubleSided(
+        SDL_GPUCommandBuffer *cmd,
+        SDL_GPURenderPass *pass,
+        const glm::mat4 &view,
+        const glm::mat4 &projection,
+        const Frustum &frustum) override;
+    void renderAnimationDepth(
+        SDL_GPUCommandBuffer *cmd,
+        SDL_GPURenderPass *pass,
+        const glm::mat4 &view,
+        const glm::mat4 &projection,
+        const Frustum &frustum) override;
+
     void renderModelShadow(
         bool checkDoubleSide,
         bool doubleSide,
@@ -101,5 +145,10 @@ public:
         const glm::mat4 &viewProj,
         const Frustum &frustum) override;
 
+    bool isStaticShadowCaster() override;
+
     static void bindTextures(RenderManager *renderManager, SDL_GPURenderPass *pass, Material *mat);
+
+private:
+    Animator *m_animator = nullptr;
 };
@@ -12,6 +12,8 @@
 
 #include "stb_image.h"
 
+#include "../gpu/gpu.h"
+#include "../profiler/profiler.h"
 #include "../utils/utils.h"
 
 ResourceManager::ResourceManager(SDL_GPUDevice *device)
@@ -30,9 +32,9 @@ void ResourceManager::dispose(ModelData *model)
         for (auto &prim : mesh.primitives)
         {
             if (prim.vertexBuffer)
-                SDL_ReleaseGPUBuffer(Utils::device, prim.vertexBuffer);
+                GPU::releaseBuffer(Utils::device, prim.vertexBuffer);
             if (prim.indexBuffer)
-                SDL_ReleaseGPUBuffer(Utils::device, prim.indexBuffer);
+                GPU::releaseBuffer(Utils::device, prim.indexBuffer);
         }
     }
 
@@ -51,7 +53,7 @@ void ResourceManager::dispose(ModelData *model)
 void ResourceManager::dispose(const Texture &texture)
 {
     if (texture.id)
-        SDL_ReleaseGPUTexture(Utils::device, texture.id);
+        GPU::releaseTexture(Utils::device, texture.id);
 }
 
 glm::mat4 GetNodeTransform(const tinygltf::Node &node)
@@ -193,6 +195,7 @@ Uint32 CalcMipLevels(int w, int h)
 ModelData *ResourceManager::loadModel(const std::string &path)
 {
     const char *filename = path.c_str();
+    ProfileScope loadZone("Load Model");
 
     tinygltf::Model model;
     tinygltf::TinyGLTF loader;
@@ -206,12 +209,14 @@ ModelData *ResourceManager::loadModel(const std::string &path)
     {
         // Use LoadBinaryFromFile for .glb (binary) files
         SDL_Log("Loading GLB binary file: %s", filename);
+        ProfileScope zone("Parse");
         ret = loader.LoadBinaryFromFile(&model, &err, &warn, filename);
     }
     else if (extension == "gltf")
     {
         // Use LoadASCIIFromFile for .gltf (ASCII/JSON) files
         SDL_Log("Loading GLTF ASCII file: %s", filename);
+        ProfileScope zone("Parse");
         ret = loader.LoadASCIIFromFile(&model, &err, &warn, filename);
     }
     else
@@ -240,6 +245,8 @@ ModelData *ResourceManager::loadModel(const std::string &path)
     SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmd);
 
     // --- 1. Load Textures ---
+    Profiler &profiler = Profiler::getInstance();
+    profiler.beginZone("Textures");
     std::vector<SDL_GPUTransferBuffer *> textureTransferBuffers;
     std::string baseDir = Utils::getBasePath(filename); // Get base dir for external files
 
@@ -329,7 +336,10 @@ ModelData *ResourceManager::loadModel(const std::string &path)
         modelData->textures.push_back(texture);
     }
 
+    profiler.endZone();
+
     // --- 2. Load Materials ---
+    profiler.beginZone("Materials");
     for (size_t i = 0; i < model.materials.size(); ++i)
     {
         const auto &gltfMat = model.materials[i];
@@ -374,7 +384,10 @@ ModelData *ResourceManager::loadModel(const std::string &path)
         modelData->materials.push_back(mat);
     }
 
+    profiler.endZone();
+
     // --- 3. Process Nodes (Scene Hierarchy) ---
+    profiler.beginZone("Nodes");
     if (!model.scenes.empty())
     {
         const auto &scene = model.scenes[model.defaultScene >= 0 ? model.defaultScene : 0];
@@ -388,7 +401,10 @@ ModelData *ResourceManager::loadModel(const std::string &path)
         SDL_Log("Processed %zu nodes", modelData->nodes.size());
     }
 
+    profiler.endZone();
+
     // --- 4. Process Meshes and Primitives (Geometry) ---
+    profiler.beginZone("Meshes");
     for (size_t meshIdx = 0; meshIdx < model.meshes.size(); ++meshIdx)
     {
         const auto &mesh = model.meshes[meshIdx];
@@ -670,19 +686,19 @@ ModelData *ResourceManager::loadModel(const std::string &path)
             SDL_GPUBufferCreateInfo vertexBufferInfo{};
             vertexBufferInfo.size = primData.vertices.size() * sizeof(Vertex);
             vertexBufferInfo.usage = SDL_GPU_BUFFERUSAGE_VERTEX;
-            primData.vertexBuffer = SDL_CreateGPUBuffer(m_device, &vertexBufferInfo);
+            primData.vertexBuffer = GPU::createBuffer(m_device, &vertexBufferInfo, GPUMemoryCategory::Mesh);
 
             SDL_GPUTransferBufferCreateInfo vertexTransferInfo{};
             vertexTransferInfo.size = vertexBufferInfo.size;
             vertexTransferInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-            primData.vertexTransferBuffer = SDL_CreateGPUTransferBuffer(m_device, &vertexTransferInfo);
+            primData.vertexTransferBuffer = GPU::createTransferBuffer(m_device, &vertexTransferInfo);
             Vertex *data = (Vertex *)SDL_MapGPUTransferBuffer(m_device, primData.vertexTransferBuffer, false);
             SDL_memcpy(data, primData.vertices.data(), vertexBufferInfo.size);
             SDL_UnmapGPUTransferBuffer(m_device, primData.vertexTransferBuffer);
 
             SDL_GPUTransferBufferLocation vertexLocation = {primData.vertexTransferBuffer, 0};
             SDL_GPUBufferRegion vertexRegion = {primData.vertexBuffer, 0, vertexBufferInfo.size};
-            SDL_UploadToGPUBuffer(copyPass, &vertexLocation, &vertexRegion, true); // Release transfer buffer
+            GPU::uploadToBuffer(copyPass, &vertexLocation, &vertexRegion, true); // Release transfer buffer
 
             // --- Create GPU Buffers (Indices) ---
             if (!primData.indices.empty())
@@ -690,19 +706,19 @@ ModelData *ResourceManager::loadModel(const std::string &path)
                 SDL_GPUBufferCreateInfo indexBufferInfo{};
                 indexBufferInfo.size = primData.indices.size() * sizeof(uint32_t);
                 indexBufferInfo.usage = SDL_GPU_BUFFERUSAGE_INDEX;
-                primData.indexBuffer = SDL_CreateGPUBuffer(m_device, &indexBufferInfo);
+                primData.indexBuffer = GPU::createBuffer(m_device, &indexBufferInfo, GPUMemoryCategory::Mesh);
 
                 SDL_GPUTransferBufferCreateInfo indexTransferInfo{};
                 indexTransferInfo.size = indexBufferInfo.size;
                 indexTransferInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-                primData.indexTransferBuffer = SDL_CreateGPUTransferBuffer(m_device, &indexTransferInfo);
+                primData.indexTransferBuffer = GPU::createTransferBuffer(m_device, &indexTransferInfo);
                 uint32_t *indexMap = (uint32_t *)SDL_MapGPUTransferBuffer(m_device, primData.indexTransferBuffer, false);
                 SDL_memcpy(indexMap, primData.indices.data(), indexBufferInfo.size);
                 SDL_UnmapGPUTransferBuffer(m_device, primData.indexTransferBuffer);
 
                 SDL_GPUTransferBufferLocation indexLocation = {primData.indexTransferBuffer, 0};
                 SDL_GPUBufferRegion indexRegion = {primData.indexBuffer, 0, indexBufferInfo.size};
-                SDL_UploadToGPUBuffer(copyPass, &indexLocation, &indexRegion, true); // Release transfer buffer
+                GPU::uploadToBuffer(copyPass, &indexLocation, &indexRegion, true); // Release transfer buffer
             }
 
             meshData.primitives.push_back(std::move(primData));
@@ -711,15 +727,21 @@ ModelData *ResourceManager::loadModel(const std::string &path)
         modelData->meshes.push_back(meshData);
     }
 
+    profiler.endZone();
+
     // Load animations
+    profiler.beginZone("Animations");
     for (int i = 0; i < model.animations.size(); i++)
     {
         // TODO: skin index
-        Animation *animation = new Animation(model, i, 0);
+        Animation *animation = new Animation(model, i, 0, m_animationImport);
         modelData->animations.push_back(animation);
     }
 
+    profiler.endZone();
+
     // --- 5. Finalize Copy Pass ---
+    profiler.beginZone("Upload");
     SDL_EndGPUCopyPass(copyPass);
 
     // Generate mipmaps
@@ -737,9 +759,23 @@ ModelData *ResourceManager::loadModel(const std::string &path)
     // Release texture transfer buffers
     for (auto *transferBuffer : textureTransferBuffers)
     {
-        SDL_ReleaseGPUTransferBuffer(m_device, transferBuffer);
+        GPU::releaseTransferBuffer(m_device, transferBuffer);
     }
 
+    // Mesh transfer buffers too, SDL keeps them alive until the upload is done
+    for (MeshData &mesh : modelData->meshes)
+    {
+        for (PrimitiveData &prim : mesh.primitives)
+        {
+            GPU::releaseTransferBuffer(m_device, prim.vertexTransferBuffer);
+            GPU::releaseTransferBuffer(m_device, prim.indexTransferBuffer);
+            prim.vertexTransferBuffer = NULL;
+            prim.indexTransferBuffer = NULL;
+        }
+    }
+
+    profiler.endZone();
+
     SDL_Log("Total: %zu meshes, %zu materials, %zu textures loaded for this model",
             modelData->meshes.size(), model.materials.size(), model.textures.size());
 
@@ -989,7 +1025,7 @@ bool ResourceManager::loadTexture(Texture &texture, const TextureParams &params,
     SDL_GPUTransferBufferCreateInfo transferInfo{};
     transferInfo.size = bufferSize;
     transferInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-    SDL_GPUTransferBuffer *transferBuffer = SDL_CreateGPUTransferBuffer(m_device, &transferInfo);
+    SDL_GPUTransferBuffer *transferBuffer = GPU::createTransferBuffer(m_device, &transferInfo);
 
     if (!transferBuffer)
     {
@@ -1002,7 +1038,7 @@ bool ResourceManager::loadTexture(Texture &texture, const TextureParams &params,
     if (!dst)
     {
         SDL_LogError(0, "Failed to map GPU transfer buffer");
-        SDL_ReleaseGPUTransferBuffer(m_device, transferBuffer);
+        GPU::releaseTransferBuffer(m_device, transferBuffer);
         return false;
     }
 
@@ -1010,11 +1046,11 @@ bool ResourceManager::loadTexture(Texture &texture, const TextureParams &params,
     SDL_UnmapGPUTransferBuffer(m_device, transferBuffer);
 
     // Create GPU texture
-    SDL_GPUTexture *gpuTexture = SDL_CreateGPUTexture(m_device, &texInfo);
+    SDL_GPUTexture *gpuTexture = GPU::createTexture(m_device, &texInfo, GPUMemoryCategory::MaterialTexture);
     if (!gpuTexture)
     {
         SDL_LogError(0, "Failed to create GPU texture");
-        SDL_ReleaseGPUTransferBuffer(m_device, transferBuffer);
+        GPU::releaseTransferBuffer(m_device, transferBuffer);
         return false;
     }
 
@@ -1038,7 +1074,7 @@ bool ResourceManager::loadTexture(Texture &texture, const TextureParams &params,
     region.h = texture.height;
     region.d = 1;
 
-    SDL_UploadToGPUTexture(copyPass, &tti, &region, false);
+    GPU::uploadToTexture(copyPass, &tti, &region, false, texInfo.format);
     SDL_EndGPUCopyPass(copyPass);
 
     // Generate mipmaps if requested
@@ -1050,7 +1086,7 @@ bool ResourceManager::loadTexture(Texture &texture, const TextureParams &params,
     SDL_WaitForGPUFences(m_device, true, &initFence, 1);
     SDL_ReleaseGPUFence(m_device, initFence);
 
-    SDL_ReleaseGPUTransferBuffer(m_device, transferBuffer);
+    GPU::releaseTransferBuffer(m_device, transferBuffer);
 
     // Set final component count to 4 since we always use RGBA
     texture.component = 4;
@@ -149,6 +149,10 @@ struct TextureParams
     }
 };
 
+// Loading helpers, exposed for the benchmarks
+void CalculateTangents(std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices);
+std::vector<uint8_t> ConvertToRGBA(const void *data, int width, int height, int components);
+
 class ResourceManager
 {
 public:
@@ -156,6 +160,8 @@ public:
     ~ResourceManager();
 
     SDL_GPUDevice *m_device = nullptr;
+    // Applied to the animations of every model loaded after it is set
+    AnimationImportSettings m_animationImport;
 
     void dispose(ModelData *model);
     void dispose(const Texture &texture);
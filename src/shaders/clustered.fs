@@ -0,0 +1,54 @@
+// Clustered forward lighting, the light lists are binned by LightManager.
+// Requires ubo.clusterGrid/clusterParams, lights[], clusters[], lightIndices[] and pbr.fs
+
+uint getClusterIndex(vec3 worldPos) {
+    // same view depth the cascade selection uses
+    float viewDepth = -(shadowUBO.cameraView * vec4(worldPos, 1.0)).z;
+
+    uint slice = uint(max(log(max(viewDepth, 1e-4)) * ubo.clusterParams.z + ubo.clusterParams.w, 0.0));
+    slice = min(slice, ubo.clusterGrid.z - 1u);
+
+    uvec2 tile = uvec2(gl_FragCoord.xy / ubo.clusterParams.xy);
+    tile = min(tile, ubo.clusterGrid.xy - 1u);
+
+    return tile.x + ubo.clusterGrid.x * (tile.y + ubo.clusterGrid.y * slice);
+}
+
+float distanceAttenuation(float distanceSquared, float range) {
+    // inverse square with a smooth window to zero at range (Karis, "Real Shading in UE4")
+    float factor = distanceSquared / (range * range);
+    float window = clamp(1.0 - factor * factor, 0.0, 1.0);
+    return window * window / max(distanceSquared, 1e-4);
+}
+
+vec3 shadeLocalLights(vec3 fragPos, vec3 viewPos, vec3 N, vec3 albedo, float metallic, float roughness) {
+    vec3 Lo = vec3(0.0);
+    if (ubo.clusterGrid.w == 0u)
+        return Lo;
+
+    vec3 V = normalize(viewPos - fragPos);
+    vec3 F0 = mix(vec3(0.04), albedo, metallic);
+
+    uvec2 cluster = clusters[getClusterIndex(fragPos)];
+    for (uint i = 0u; i < cluster.y; i++) {
+        LocalLight light = lights[lightIndices[cluster.x + i]];
+
+        vec3 toLight = light.position - fragPos;
+        float distanceSquared = dot(toLight, toLight);
+        if (distanceSquared > light.range * light.range)
+            continue;
+
+        vec3 L = toLight * inversesqrt(max(distanceSquared, 1e-8));
+        float attenuation = distanceAttenuation(distanceSquared, light.range);
+
+        if (light.type == 1u) {
+            float cosAngle = dot(-L, light.direction);
+            attenuation *= smoothstep(light.outerConeCos, light.innerConeCos, cosAngle);
+        }
+
+        vec3 radiance = light.color * light.intensity * attenuation;
+        Lo += directLighting(N, V, L, radiance, albedo, metallic, roughness, F0);
+    }
+
+    return Lo;
+}
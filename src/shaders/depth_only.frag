@@ -0,0 +1,6 @@
+#version 450
+
+// Depth-only passes have no color targets, depth comes from the rasterizer
+void main()
+{
+}
@@ -0,0 +1,20 @@
+#version 450
+
+layout(location = 0) in vec3 inPosition;
+
+// Same block and transform order as pbr.vert so depth matches the main pass
+layout(binding = 0) uniform VertexUniformBlock {
+    mat4 model;
+    mat4 view;
+    mat4 projection;
+    mat4 normalMatrix;
+} ubo;
+
+// Must match pbr.vert bit for bit
+invariant gl_Position;
+
+void main()
+{
+    vec4 worldPos = ubo.model * vec4(inPosition, 1.0);
+    gl_Position = ubo.projection * ubo.view * worldPos;
+}
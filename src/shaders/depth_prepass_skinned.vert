@@ -0,0 +1,40 @@
+#version 450
+
+layout(location = 0) in vec3  inPosition;
+layout(location = 4) in uvec4 inJoints;   // JOINTS_0
+layout(location = 5) in vec4  inWeights;  // WEIGHTS_0
+
+// Same block and transform order as pbr_skinned.vert so depth matches the main pass
+layout(binding = 0) uniform VertexUniformBlock {
+    mat4 model;
+    mat4 view;
+    mat4 projection;
+    mat4 normalMatrix;
+} ubo;
+
+const int MAX_JOINTS = 128;
+layout(binding = 1) uniform SkinningBlock {
+    mat4 jointMatrices[MAX_JOINTS];
+} skin;
+
+mat4 getSkinMatrix()
+{
+    vec4 w = inWeights;
+
+    mat4 m0 = skin.jointMatrices[inJoints.x];
+    mat4 m1 = skin.jointMatrices[inJoints.y];
+    mat4 m2 = skin.jointMatrices[inJoints.z];
+    mat4 m3 = skin.jointMatrices[inJoints.w];
+
+    return w.x * m0 + w.y * m1 + w.z * m2 + w.w * m3;
+}
+
+// Must match pbr_skinned.vert bit for bit
+invariant gl_Position;
+
+void main()
+{
+    mat4 skinMat = getSkinMatrix();
+    vec4 worldPos = skinMat * vec4(inPosition, 1.0);
+    gl_Position = ubo.projection * ubo.view * worldPos;
+}
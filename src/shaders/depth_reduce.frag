@@ -0,0 +1,37 @@
+#version 450
+
+layout(location = 0) out vec2 outMinMax;
+
+layout(binding = 0) uniform DepthReduceBlock {
+    ivec2 sourceSize;
+    ivec2 padding;
+} ubo;
+
+layout(binding = 0) uniform sampler2D sourceTex;
+
+void main()
+{
+    // Each output texel covers a 4x4 block of the source
+    ivec2 base = ivec2(gl_FragCoord.xy) * 4;
+
+    float minDepth = 1.0;
+    float maxDepth = 0.0;
+
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            ivec2 coord = base + ivec2(x, y);
+            if (coord.x >= ubo.sourceSize.x || coord.y >= ubo.sourceSize.y)
+                continue;
+
+            // The first pass reads Hi-Z mip 0. Cleared depth (sky) never receives
+            // shadows, where a texel mixes it with geometry the closest depth stands in
+            vec2 minMax = texelFetch(sourceTex, coord, 0).rg;
+            if (minMax.x >= 1.0)
+                continue;
+            minDepth = min(minDepth, minMax.x);
+            maxDepth = max(maxDepth, minMax.y < 1.0 ? minMax.y : minMax.x);
+        }
+    }
+
+    outMinMax = vec2(minDepth, maxDepth);
+}
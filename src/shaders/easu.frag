@@ -0,0 +1,94 @@
+#version 450
+
+// Edge adaptive spatial upsampling, after AMD FidelityFX FSR1 EASU.
+// A 4x4 Lanczos2 style kernel is stretched along the local edge and
+// deringed against the nearest 2x2 texels.
+
+layout(location = 1) in vec2 vScreenUV;
+
+layout(location = 0) out vec4 outColor;
+
+layout(binding = 0) uniform UpscaleBlock {
+    vec4 sizes; // xy = source size, zw = output size
+    float sharpness;
+    vec3 padding;
+} ubo;
+
+layout(binding = 0) uniform sampler2D sourceTex;
+
+float luma(vec3 c) {
+    return dot(c, vec3(0.5, 1.0, 0.5));
+}
+
+vec3 fetch(ivec2 coord) {
+    return texelFetch(sourceTex, clamp(coord, ivec2(0), ivec2(ubo.sizes.xy) - 1), 0).rgb;
+}
+
+// Polynomial Lanczos2 approximation, w goes from 1/4 (wide) to 1/2 (sharp)
+float lanczos2(float d2, float w) {
+    d2 = min(d2, 4.0);
+    float base = 0.4 * d2 - 1.0;
+    float window = w * d2 - 1.0;
+    return (25.0 / 16.0 * base * base - (25.0 / 16.0 - 1.0)) * window * window;
+}
+
+void main()
+{
+    vec2 p = vScreenUV * ubo.sizes.xy - 0.5;
+    ivec2 base = ivec2(floor(p));
+    vec2 f = p - vec2(base);
+
+    vec3 taps[16];
+    float lumas[16];
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            vec3 c = fetch(base + ivec2(x - 1, y - 1));
+            taps[y * 4 + x] = c;
+            lumas[y * 4 + x] = luma(c);
+        }
+    }
+
+    // Luma gradient of the inner 2x2, bilinearly weighted
+    vec2 dir = vec2(0.0);
+    float edge = 0.0;
+    for (int y = 1; y <= 2; y++) {
+        for (int x = 1; x <= 2; x++) {
+            float weight = (x == 1 ? 1.0 - f.x : f.x) * (y == 1 ? 1.0 - f.y : f.y);
+            float l = lumas[y * 4 + x];
+            float dx = lumas[y * 4 + x + 1] - lumas[y * 4 + x - 1];
+            float dy = lumas[(y + 1) * 4 + x] - lumas[(y - 1) * 4 + x];
+            dir += vec2(dx, dy) * weight;
+
+            // Relative contrast, flat regions stay isotropic
+            float range = max(abs(dx), abs(dy));
+            edge += clamp(range / max(l, 1e-4), 0.0, 1.0) * weight;
+        }
+    }
+
+    float dirLength = dot(dir, dir);
+    dir = dirLength < 1e-10 ? vec2(1.0, 0.0) : dir * inversesqrt(dirLength);
+
+    // Narrow across the edge (up to sqrt(2) on diagonals) and widen along it
+    float stretch = 1.0 / max(abs(dir.x), abs(dir.y));
+    vec2 scale = vec2(1.0 + (stretch - 1.0) * edge, 1.0 - 0.5 * edge * edge);
+    float lobe = 0.5 - 0.25 * edge;
+
+    vec3 sum = vec3(0.0);
+    float weightSum = 0.0;
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            vec2 offset = vec2(x - 1, y - 1) - f;
+            vec2 rotated = vec2(dot(offset, dir), dot(offset, vec2(-dir.y, dir.x))) * scale;
+            float weight = lanczos2(dot(rotated, rotated), lobe);
+            sum += taps[y * 4 + x] * weight;
+            weightSum += weight;
+        }
+    }
+
+    vec3 color = sum / weightSum;
+
+    // Negative lobes can overshoot, keep the result inside the nearest texels
+    vec3 minColor = min(min(taps[5], taps[6]), min(taps[9], taps[10]));
+    vec3 maxColor = max(max(taps[5], taps[6]), max(taps[9], taps[10]));
+    outColor = vec4(clamp(color, minColor, maxColor), 1.0);
+}
@@ -0,0 +1,47 @@
+#version 450
+
+layout(location = 0) in vec2 vUV;
+
+layout(location = 0) out vec4 outMoments;
+
+layout(binding = 0) uniform EVSMBlurBlock {
+    ivec2 direction;  // (1, 0) or (0, 1)
+    vec2 exponents;   // positive, negative
+    int layer;        // source layer
+    int convertDepth; // source is the R16 shadow map, warp it into moments first
+    int radius;
+    int padding;
+} ubo;
+
+layout(binding = 0) uniform sampler2DArray sourceTex;
+
+vec4 computeMoments(float depth) {
+    // must match warpDepth() in shadowing.fs
+    depth = 2.0 * depth - 1.0;
+    float pos = exp(ubo.exponents.x * depth);
+    float neg = -exp(-ubo.exponents.y * depth);
+    return vec4(pos, pos * pos, neg, neg * neg);
+}
+
+vec4 fetchMoments(ivec2 coord) {
+    vec4 value = texelFetch(sourceTex, ivec3(coord, ubo.layer), 0);
+    return ubo.convertDepth != 0 ? computeMoments(value.r) : value;
+}
+
+void main()
+{
+    ivec2 size = textureSize(sourceTex, 0).xy;
+    ivec2 center = ivec2(gl_FragCoord.xy);
+
+    // Tent filter, moments are linear so the blur is the prefilter
+    vec4 sum = vec4(0.0);
+    float weightSum = 0.0;
+    for (int i = -ubo.radius; i <= ubo.radius; i++) {
+        ivec2 coord = clamp(center + ubo.direction * i, ivec2(0), size - 1);
+        float weight = float(ubo.radius + 1 - abs(i));
+        sum += fetchMoments(coord) * weight;
+        weightSum += weight;
+    }
+
+    outMoments = sum / weightSum;
+}
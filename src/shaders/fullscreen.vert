@@ -1,6 +1,12 @@
 #version 450
 
-layout(location = 0) out vec2 vUV;
+layout(location = 0) out vec2 vUV;       // texture uv of the rendered region
+layout(location = 1) out vec2 vScreenUV; // viewport uv, for position reconstruction
+
+layout(binding = 0) uniform FullscreenBlock {
+    vec2 uvScale; // render size / target size with dynamic resolution
+    vec2 padding;
+} ubo;
 
 vec2 positions[3] = vec2[](
     vec2(-1.0, -1.0),
@@ -10,8 +16,9 @@ vec2 positions[3] = vec2[](
 
 void main() {
     vec2 pos = positions[gl_VertexIndex];
-    vUV = pos * 0.5 + 0.5;     // full-screen UV
-    vUV.y *= -1.0;
-    vUV.y = vUV.y + 1.0;
+    vScreenUV = pos * 0.5 + 0.5;     // full-screen UV
+    vScreenUV.y *= -1.0;
+    vScreenUV.y = vScreenUV.y + 1.0;
+    vUV = vScreenUV * ubo.uvScale;
     gl_Position = vec4(pos, 0.0, 1.0);
-}
\ No newline at end of file
+}
@@ -6,9 +6,12 @@ layout(location = 1) in vec3 fragNormal;
 layout(location = 2) in vec2 fragUV;
 layout(location = 3) in vec3 fragTangent;
 layout(location = 4) in vec3 fragBitangent;
+layout(location = 5) in vec4 fragClipPos;
+layout(location = 6) in vec4 fragPrevClipPos;
 
 // Fragment shader output
 layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec2 outVelocity; // uv delta to the previous frame, for TAA
 
 // Scene-wide uniforms
 layout(binding = 0) uniform FragmentUniformBlock {
@@ -18,6 +21,8 @@ layout(binding = 0) uniform FragmentUniformBlock {
     float padding2;
     vec3 lightColor;
     float padding3;
+    uvec4 clusterGrid;  // cluster count x, y, z, local light count
+    vec4 clusterParams; // tile size in pixels (xy), depth slice scale, depth slice bias
 } ubo;
 
 // Per-Material uniforms
@@ -53,7 +58,9 @@ layout(binding = 2) uniform ShadowUniformBlock {
     vec4 cascadeBias;
     float shadowFar;
     float strength;
-    vec2 padding;
+    int screenMask;
+    int shadowMode; // 0: DPCF, 1: EVSM
+    vec4 evsmParams; // positive exponent, negative exponent, light bleeding reduction, variance bias
 } shadowUBO;
 
 layout(binding = 3) uniform FogUniformBlock {
@@ -75,7 +82,31 @@ layout(binding = 5) uniform sampler2D opacityMap;
 layout(binding = 6) uniform samplerCube irradianceMap;
 layout(binding = 7) uniform samplerCube prefilterMap;
 layout(binding = 8) uniform sampler2D brdfLUT;
-layout(binding = 9) uniform sampler2DArray shadowMap;
+layout(binding = 9) uniform sampler2DArray shadowMap; // depth, or EVSM moments when shadowMode == 1
+layout(binding = 10) uniform sampler2D shadowMask; // screen-space visibility, see shadow_mask.frag
+
+// Local lights, storage buffers follow the uniform blocks
+struct LocalLight {
+    vec3 position;
+    float range;
+    vec3 color;
+    float intensity;
+    vec3 direction;
+    float innerConeCos;
+    float outerConeCos;
+    uint type; // 0: point, 1: spot
+    vec2 padding;
+};
+
+layout(std430, binding = 4) readonly buffer LightBuffer {
+    LocalLight lights[];
+};
+layout(std430, binding = 5) readonly buffer ClusterBuffer {
+    uvec2 clusters[]; // offset, count into lightIndices
+};
+layout(std430, binding = 6) readonly buffer LightIndexBuffer {
+    uint lightIndices[];
+};
 
 vec3 getNormalFromMap(vec2 uv, vec3 T, vec3 B, vec3 N)
 {
@@ -91,6 +122,7 @@ vec3 getNormalFromMap(vec2 uv, vec3 T, vec3 B, vec3 N)
 
 #include "shadowing.fs"
 #include "pbr.fs"
+#include "clustered.fs"
 #include "fog.fs"
 
 void main()
@@ -173,7 +205,11 @@ void main()
 
     float visibility = 1.0;
     if (material.receiveShadow > 0 && NdotL > 0.0) {
-        visibility = shadow(fragPos, N, ubo.viewPos, ubo.lightDir, 2u);
+        // alpha tested surfaces are not in the prepass depth the mask was built from
+        if (shadowUBO.screenMask > 0 && material.alphaCutoff <= 0.0)
+            visibility = texelFetch(shadowMask, ivec2(gl_FragCoord.xy), 0).r;
+        else
+            visibility = shadow(fragPos, N, ubo.viewPos, ubo.lightDir, 2u);
     }
 
     ShadeResult shade = shadePBR(
@@ -199,12 +235,18 @@ void main()
 
     // --- Final Color ---
     vec3 color = shade.ambient + shade.Lo * visibility;
+    color += shadeLocalLights(fragPos, ubo.viewPos, N, albedo, metallic, roughness);
 
     // Fog
     float dist = distance(ubo.viewPos, fragPos);
     color = linearFog(color, dist);
 
     outColor = vec4(color, alpha);
+
+    // NDC y points up, screen uv y points down
+    vec2 ndc = fragClipPos.xy / fragClipPos.w;
+    vec2 prevNdc = fragPrevClipPos.xy / fragPrevClipPos.w;
+    outVelocity = (ndc - prevNdc) * vec2(0.5, -0.5);
     // outColor = vec4(vec3(material.alphaCutoff), alpha);
     // outColor = vec4(irradiance, 1.0);
     // outColor = vec4(diffuse, 1.0);
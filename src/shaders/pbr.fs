@@ -45,6 +45,39 @@ vec3 fresnelSchlickRoughness(float cosTheta, vec3 F0, float roughness)
     return F0 + (max(vec3(1.0 - roughness), F0) - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
 }
 
+// Cook-Torrance response of a single light, radiance already attenuated
+vec3 directLighting(
+    vec3 N,
+    vec3 V,
+    vec3 L,
+    vec3 radiance,
+    vec3 albedo,
+    float metallic,
+    float roughness,
+    vec3 F0)
+{
+    float NdotL = max(dot(N, L), 0.0);
+    if (NdotL <= 0.0)
+        return vec3(0.0);
+
+    vec3 H = normalize(V + L);
+
+    // Cook-Torrance BRDF
+    float NDF = DistributionGGX(N, H, roughness);
+    float G = GeometrySmith(N, V, L, roughness);
+    vec3 F = fresnelSchlick(clamp(dot(H, V), 0.0, 1.0), F0);
+
+    vec3 numerator = NDF * G * F;
+    float denominator = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001;
+    vec3 specular = numerator / denominator;
+
+    vec3 kS = F;
+    vec3 kD = vec3(1.0) - kS;
+    kD *= 1.0 - metallic;
+
+    return (kD * albedo / PI + specular) * radiance * NdotL;
+}
+
 struct ShadeResult
 {
     vec3 ambient;
@@ -69,30 +102,8 @@ ShadeResult shadePBR(
     F0 = mix(F0, albedo, metallic);
 
     // --- Direct Lighting ---
-    vec3 Lo = vec3(0.0);
     vec3 L = normalize(-lightDir);
-    float NdotL = max(dot(N, L), 0.0);
-
-    if (NdotL > 0.0)
-    {
-        vec3 H = normalize(V + L);
-        vec3 radiance = lightColor;
-
-        // Cook-Torrance BRDF
-        float NDF = DistributionGGX(N, H, roughness);
-        float G = GeometrySmith(N, V, L, roughness);
-        vec3 F = fresnelSchlick(clamp(dot(H, V), 0.0, 1.0), F0);
-
-        vec3 numerator = NDF * G * F;
-        float denominator = 4.0 * max(dot(N, V), 0.0) * max(dot(N, L), 0.0) + 0.0001;
-        vec3 specular = numerator / denominator;
-
-        vec3 kS = F;
-        vec3 kD = vec3(1.0) - kS;
-        kD *= 1.0 - metallic;
-
-        Lo += (kD * albedo / PI + specular) * radiance * NdotL;
-    }
+    vec3 Lo = directLighting(N, V, L, lightColor, albedo, metallic, roughness, F0);
 
     // --- Image-Based Lighting (IBL) ---
 
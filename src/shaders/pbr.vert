@@ -12,6 +12,8 @@ layout(location = 1) out vec3 fragNormal;
 layout(location = 2) out vec2 fragUV;
 layout(location = 3) out vec3 fragTangent;
 layout(location = 4) out vec3 fragBitangent;
+layout(location = 5) out vec4 fragClipPos;     // unjittered, current frame
+layout(location = 6) out vec4 fragPrevClipPos; // unjittered, previous frame
 
 // Uniform buffer for per-draw transforms
 layout(binding = 0) uniform VertexUniformBlock {
@@ -19,8 +21,14 @@ layout(binding = 0) uniform VertexUniformBlock {
     mat4 view;
     mat4 projection;
     mat4 normalMatrix;
+    mat4 prevModel;
+    mat4 prevViewProjection;
+    vec4 jitter; // xy = NDC offset baked into projection
 } ubo;
 
+// Bit-identical depth with the prepass, the opaque pass tests against it without writing
+invariant gl_Position;
+
 void main() {
     vec4 worldPos = ubo.model * vec4(inPosition, 1.0);
     fragPos = worldPos.xyz;
@@ -37,4 +45,8 @@ void main() {
     fragUV = inUV;
     
     gl_Position = ubo.projection * ubo.view * worldPos;
+
+    // Motion vectors ignore the TAA jitter, otherwise static pixels would swim
+    fragClipPos = gl_Position - vec4(ubo.jitter.xy * gl_Position.w, 0.0, 0.0);
+    fragPrevClipPos = ubo.prevViewProjection * ubo.prevModel * vec4(inPosition, 1.0);
 }
@@ -18,6 +18,8 @@ layout(binding = 0) uniform FragmentUniformBlock {
     float padding2;
     vec3 lightColor;
     float padding3;
+    uvec4 clusterGrid;  // cluster count x, y, z, local light count
+    vec4 clusterParams; // tile size in pixels (xy), depth slice scale, depth slice bias
 } ubo;
 
 // Per-Material uniforms
@@ -53,7 +55,9 @@ layout(binding = 2) uniform ShadowUniformBlock {
     vec4 cascadeBias;
     float shadowFar;
     float strength;
-    vec2 padding;
+    int screenMask;
+    int shadowMode; // 0: DPCF, 1: EVSM
+    vec4 evsmParams; // positive exponent, negative exponent, light bleeding reduction, variance bias
 } shadowUBO;
 
 layout(binding = 3) uniform FogUniformBlock {
@@ -75,7 +79,31 @@ layout(binding = 5) uniform sampler2D opacityMap;
 layout(binding = 6) uniform samplerCube irradianceMap;
 layout(binding = 7) uniform samplerCube prefilterMap;
 layout(binding = 8) uniform sampler2D brdfLUT;
-layout(binding = 9) uniform sampler2DArray shadowMap;
+layout(binding = 9) uniform sampler2DArray shadowMap; // depth, or EVSM moments when shadowMode == 1
+layout(binding = 10) uniform sampler2D shadowMask; // screen-space visibility, see shadow_mask.frag
+
+// Local lights, storage buffers follow the uniform blocks
+struct LocalLight {
+    vec3 position;
+    float range;
+    vec3 color;
+    float intensity;
+    vec3 direction;
+    float innerConeCos;
+    float outerConeCos;
+    uint type; // 0: point, 1: spot
+    vec2 padding;
+};
+
+layout(std430, binding = 4) readonly buffer LightBuffer {
+    LocalLight lights[];
+};
+layout(std430, binding = 5) readonly buffer ClusterBuffer {
+    uvec2 clusters[]; // offset, count into lightIndices
+};
+layout(std430, binding = 6) readonly buffer LightIndexBuffer {
+    uint lightIndices[];
+};
 
 vec3 getNormalFromMap(vec2 uv, vec3 T, vec3 B, vec3 N)
 {
@@ -91,6 +119,7 @@ vec3 getNormalFromMap(vec2 uv, vec3 T, vec3 B, vec3 N)
 
 #include "shadowing.fs"
 #include "pbr.fs"
+#include "clustered.fs"
 #include "fog.fs"
 
 void main()
@@ -195,6 +224,7 @@ void main()
 
     // --- Final Color ---
     vec3 color = shade.ambient + shade.Lo * visibility;
+    color += shadeLocalLights(fragPos, ubo.viewPos, N, albedo, metallic, roughness);
 
     // Fog
     float dist = distance(ubo.viewPos, fragPos);
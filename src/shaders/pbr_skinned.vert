@@ -15,6 +15,8 @@ layout(location = 1) out vec3 fragNormal;
 layout(location = 2) out vec2 fragUV;
 layout(location = 3) out vec3 fragTangent;
 layout(location = 4) out vec3 fragBitangent;
+layout(location = 5) out vec4 fragClipPos;
+layout(location = 6) out vec4 fragPrevClipPos;
 
 // Per-draw transforms
 layout(binding = 0) uniform VertexUniformBlock {
@@ -22,6 +24,9 @@ layout(binding = 0) uniform VertexUniformBlock {
     mat4 view;
     mat4 projection;
     mat4 normalMatrix;
+    mat4 prevModel;
+    mat4 prevViewProjection;
+    vec4 jitter;
 } ubo;
 
 const int MAX_JOINTS = 128;
@@ -29,6 +34,11 @@ layout(binding = 1) uniform SkinningBlock {
     mat4 jointMatrices[MAX_JOINTS];
 } skin;
 
+// Last frame's pose, for motion vectors
+layout(binding = 2) uniform PrevSkinningBlock {
+    mat4 jointMatrices[MAX_JOINTS];
+} prevSkin;
+
 // layout(binding = 2) uniform SkinningNormalBlock {
 //     mat3 jointNormalMatrices[MAX_JOINTS];
 // } skinNormal;
@@ -50,6 +60,15 @@ mat4 getSkinMatrix()
     return w.x * m0 + w.y * m1 + w.z * m2 + w.w * m3;
 }
 
+mat4 getPrevSkinMatrix()
+{
+    vec4 w = inWeights;
+    return w.x * prevSkin.jointMatrices[inJoints.x] +
+           w.y * prevSkin.jointMatrices[inJoints.y] +
+           w.z * prevSkin.jointMatrices[inJoints.z] +
+           w.w * prevSkin.jointMatrices[inJoints.w];
+}
+
 /* float getJointWeight(int joint)
 {
     float w = 0.0;
@@ -60,6 +79,9 @@ mat4 getSkinMatrix()
     return w;
 } */
 
+// Must match depth_prepass_skinned.vert exactly, see pbr.vert
+invariant gl_Position;
+
 void main()
 {
     mat4 skinMat = getSkinMatrix();
@@ -75,4 +97,7 @@ void main()
     fragUV = inUV;
 
     gl_Position = ubo.projection * ubo.view * worldPos;
+
+    fragClipPos = gl_Position - vec4(ubo.jitter.xy * gl_Position.w, 0.0, 0.0);
+    fragPrevClipPos = ubo.prevViewProjection * getPrevSkinMatrix() * vec4(inPosition, 1.0);
 }
@@ -1,6 +1,7 @@
 #version 450
 
 layout(location = 0) in vec2 inUV;
+layout(location = 1) in vec2 inScreenUV;
 
 layout(location = 0) out vec4 outColor;
 
@@ -13,6 +14,10 @@ layout(binding = 0) uniform PostProcessFragmentUBO {
     int fxaaEnabled;
     int lutEnabled;
     float lutIntensity;
+
+    vec2 uvMax;
+    int sceneFullRes; // scene is already at display resolution (TAA, EASU or RCAS)
+    int padding;
 } ubo;
 
 layout(binding = 0) uniform sampler2D sceneTex;
@@ -114,12 +119,17 @@ vec3 LookupLUT(vec3 color) {
 }
 
 void main() {
-    vec2 uv = inUV;
+    // keep the bilinear upscale from reading outside the render region
+    vec2 uv = min(inUV, ubo.uvMax);
 
     vec3 color;
 
     // FXAA / Base Sample
-    if (ubo.fxaaEnabled == 1) {
+    if (ubo.sceneFullRes == 1) {
+        color = ubo.fxaaEnabled == 1
+            ? fxaa(sceneTex, inScreenUV, vec2(textureSize(sceneTex, 0)))
+            : texture(sceneTex, inScreenUV).rgb;
+    } else if (ubo.fxaaEnabled == 1) {
         color = fxaa(sceneTex, uv, ubo.screenSize);
     } else {
         color = texture(sceneTex, uv).rgb;
@@ -130,7 +140,7 @@ void main() {
     color *= aoFactor; 
 
     // Bloom
-    vec3 bloomRaw = texture(bloomTex, uv).rgb;
+    vec3 bloomRaw = textureLod(bloomTex, uv, 0.0).rgb; // mip 0 holds the combined chain
     color += bloomRaw * ubo.bloomIntensity;
 
     // Exposure
@@ -0,0 +1,58 @@
+#version 450
+
+// Robust contrast adaptive sharpening, after AMD FidelityFX FSR1 RCAS.
+// Runs on HDR input, so the cross is compressed into [0, 1) first.
+
+layout(location = 1) in vec2 vScreenUV;
+
+layout(location = 0) out vec4 outColor;
+
+layout(binding = 0) uniform UpscaleBlock {
+    vec4 sizes; // xy = source size, zw = output size
+    float sharpness; // stops, 0 is the strongest
+    vec3 padding;
+} ubo;
+
+layout(binding = 0) uniform sampler2D sourceTex;
+
+// Reversible tonemap
+vec3 compress(vec3 c) {
+    return c / (1.0 + max(c.r, max(c.g, c.b)));
+}
+
+vec3 uncompress(vec3 c) {
+    return c / max(1.0 - max(c.r, max(c.g, c.b)), 1e-4);
+}
+
+vec3 fetch(ivec2 coord) {
+    return compress(texelFetch(sourceTex, clamp(coord, ivec2(0), ivec2(ubo.sizes.xy) - 1), 0).rgb);
+}
+
+void main()
+{
+    ivec2 coord = ivec2(gl_FragCoord.xy);
+
+    //    b
+    //  d e f
+    //    h
+    vec3 b = fetch(coord + ivec2(0, -1));
+    vec3 d = fetch(coord + ivec2(-1, 0));
+    vec3 e = fetch(coord);
+    vec3 f = fetch(coord + ivec2(1, 0));
+    vec3 h = fetch(coord + ivec2(0, 1));
+
+    vec3 minRing = min(min(b, d), min(f, h));
+    vec3 maxRing = max(max(b, d), max(f, h));
+
+    // Largest negative lobe that keeps the output inside [0, 1]
+    vec3 hitMin = min(minRing, e) / (4.0 * maxRing + 1e-5);
+    vec3 hitMax = (1.0 - max(maxRing, e)) / (4.0 * minRing - 4.0 - 1e-5);
+    vec3 lobeRGB = max(-hitMin, hitMax);
+
+    // 0.1875 is the 4 tap limit from the reference
+    float lobe = max(-0.1875, min(max(lobeRGB.r, max(lobeRGB.g, lobeRGB.b)), 0.0));
+    lobe *= exp2(-ubo.sharpness);
+
+    vec3 color = (lobe * (b + d + f + h) + e) / (4.0 * lobe + 1.0);
+    outColor = vec4(uncompress(color), 1.0);
+}
@@ -0,0 +1,52 @@
+#version 450
+
+layout(location = 1) in vec2 vScreenUV;
+
+layout(location = 0) out float outVisibility;
+
+const int MAX_CASCADES = 4;
+layout(binding = 0) uniform ShadowUniformBlock {
+    mat4 depthBiasVP[MAX_CASCADES];
+    mat4 cameraView;
+    vec4 cascadeSplits; // view-space far distance per cascade (x, y, z, w)
+    vec4 cascadeBias;
+    float shadowFar;
+    float strength;
+    int screenMask;
+    int shadowMode; // 0: DPCF, 1: EVSM
+    vec4 evsmParams; // positive exponent, negative exponent, light bleeding reduction, variance bias
+} shadowUBO;
+
+layout(binding = 1) uniform ShadowMaskBlock {
+    mat4 invViewProj;
+    vec3 viewPos;
+    uint tapCount;
+    vec3 lightDir;
+    float padding;
+} ubo;
+
+layout(binding = 0) uniform sampler2D depthTex;
+layout(binding = 1) uniform sampler2DArray shadowMap;
+
+#include "shadowing.fs"
+
+void main()
+{
+    float depth = texelFetch(depthTex, ivec2(gl_FragCoord.xy), 0).r;
+
+    // vScreenUV is flipped in fullscreen.vert, undo it to get NDC
+    vec2 ndc = vec2(vScreenUV.x * 2.0 - 1.0, 1.0 - vScreenUV.y * 2.0);
+    vec4 worldPos = ubo.invViewProj * vec4(ndc, depth, 1.0);
+    worldPos /= worldPos.w;
+
+    // Geometric normal for the normal offset bias, facing the camera
+    vec3 N = normalize(cross(dFdx(worldPos.xyz), dFdy(worldPos.xyz)));
+    if (dot(N, ubo.viewPos - worldPos.xyz) < 0.0)
+        N = -N;
+
+    // Evaluated for every pixel so derivatives inside shadow() stay in uniform control flow
+    float visibility = shadow(worldPos.xyz, N, ubo.viewPos, ubo.lightDir, ubo.tapCount);
+
+    // sky
+    outVisibility = depth >= 1.0 ? 1.0 : visibility;
+}
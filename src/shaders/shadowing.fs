@@ -214,6 +214,56 @@ float ShadowSample_DPCF(
     return 1.0 - percentageOccluded;
 }
 
+//------------------------------------------------------------------------------
+// EVSM Shadow Sampling
+//------------------------------------------------------------------------------
+
+/*
+ * Exponential variance shadow maps, the moments are pre-filtered by ShadowManager
+ * so a single trilinear/anisotropic fetch replaces the PCF taps.
+ * see "Layered Variance Shadow Maps" -- by Andrew Lauritzen and Michael McCool
+ */
+vec2 warpDepth(float depth, vec2 exponents) {
+    // rescale to [-1, 1] so both warps use the full float range
+    depth = 2.0 * depth - 1.0;
+    float pos = exp(exponents.x * depth);
+    float neg = -exp(-exponents.y * depth);
+    return vec2(pos, neg);
+}
+
+float reduceLightBleeding(float pMax, float amount) {
+    // remove the [0, amount] tail and linearly rescale (amount, 1]
+    return saturate((pMax - amount) / (1.0 - amount));
+}
+
+float chebyshevUpperBound(vec2 moments, float mean, float minVariance, float lightBleedingReduction) {
+    float variance = max(moments.y - moments.x * moments.x, minVariance);
+    float d = mean - moments.x;
+    float pMax = reduceLightBleeding(variance / (variance + d * d), lightBleedingReduction);
+
+    // one-tailed inequality, fully lit in front of the mean occluder
+    return mean <= moments.x ? 1.0 : pMax;
+}
+
+float ShadowSample_EVSM(const sampler2DArray map, const uint layer, const vec4 shadowPosition) {
+    vec3 position = shadowPosition.xyz * (1.0 / shadowPosition.w);
+    vec2 exponents = shadowUBO.evsmParams.xy;
+
+    vec4 moments = texture(map, vec3(position.xy, layer));
+    vec2 warped = warpDepth(position.z, exponents);
+
+    // variance bias scales with the derivative of the warp
+    vec2 depthScale = shadowUBO.evsmParams.w * 0.01 * exponents * warped;
+    vec2 minVariance = depthScale * depthScale;
+
+    float lightBleedingReduction = shadowUBO.evsmParams.z;
+    float posContrib = chebyshevUpperBound(moments.xy, warped.x, minVariance.x, lightBleedingReduction);
+    float negContrib = chebyshevUpperBound(moments.zw, warped.y, minVariance.y, lightBleedingReduction);
+
+    // shadowed fraction, same convention as ShadowSample_DPCF
+    return 1.0 - min(posContrib, negContrib);
+}
+
 /**
  * Computes the light space position of the specified world space point.
  * The returned point may contain a bias to attempt to eliminate common
@@ -262,16 +312,20 @@ float shadow(vec3 worldPos, vec3 normal, vec3 camPosition, vec3 lightDir, uint t
     float zLight = 0.0;
     float shadow = 0.0;
 
-    shadow = ShadowSample_DPCF(
-        tapCount,
-        true,
-        shadowMap,
-        scissorNormalized,
-        layer,
-        index,
-        ShadowCoord,
-        zLight
-    );
+    if (shadowUBO.shadowMode == 1) {
+        shadow = ShadowSample_EVSM(shadowMap, layer, ShadowCoord);
+    } else {
+        shadow = ShadowSample_DPCF(
+            tapCount,
+            true,
+            shadowMap,
+            scissorNormalized,
+            layer,
+            index,
+            ShadowCoord,
+            zLight
+        );
+    }
 
     float visibility = 1.0 - shadow * shadowUBO.strength;
 
@@ -3,6 +3,8 @@
 layout(location = 0) in vec3 fragTexCoord;
 
 layout(location = 0) out vec4 outColor;
+// Camera only motion, the TAA pass reprojects sky pixels from depth
+layout(location = 1) out vec2 outVelocity;
 
 layout(binding = 0) uniform SkyboxFragmentUBO {
     float lod;
@@ -14,4 +16,5 @@ void main() {
     vec3 dir = normalize(fragTexCoord);
     vec3 color = textureLod(environmentMap, dir, ubo.lod).rgb;
     outColor = vec4(color, 1.0);
+    outVelocity = vec2(0.0);
 }
@@ -3,6 +3,7 @@
 layout(location = 0) in vec3 fragTexCoord;
 
 layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec2 outVelocity; // see skybox.frag
 
 layout(binding = 0) uniform SkyboxFragmentUBO {
     vec3 sunPosition;
@@ -138,4 +139,5 @@ void main() {
     vec3 finalColor = mix(skyColor, cloudColor, cloudAlpha);
 
     outColor = vec4(finalColor, 1.0);
+    outVelocity = vec2(0.0);
 }
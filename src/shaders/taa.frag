@@ -0,0 +1,94 @@
+#version 450
+
+layout(location = 1) in vec2 vScreenUV;
+
+layout(location = 0) out vec4 outColor;
+
+layout(binding = 0) uniform TAABlock {
+    mat4 reprojection; // current to previous clip space, unjittered
+    vec4 renderSize;   // xy = render region size, zw = 1 / target size
+    vec2 uvScale;
+    vec2 jitter;       // uv offset of this frame's samples
+    float feedback;
+    uint historyValid;
+    vec2 padding;
+} ubo;
+
+layout(binding = 0) uniform sampler2D colorTex;
+layout(binding = 1) uniform sampler2D velocityTex;
+layout(binding = 2) uniform sampler2D depthTex;
+layout(binding = 3) uniform sampler2D historyTex;
+
+vec3 rgbToYCoCg(vec3 c) {
+    return vec3(
+        0.25 * c.r + 0.5 * c.g + 0.25 * c.b,
+        0.5 * c.r - 0.5 * c.b,
+        -0.25 * c.r + 0.5 * c.g - 0.25 * c.b);
+}
+
+vec3 yCoCgToRgb(vec3 c) {
+    return vec3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z);
+}
+
+// Karis, "High Quality Temporal Supersampling", tonemapped weights keep fireflies from ghosting
+float lumaWeight(vec3 c) {
+    return 1.0 / (1.0 + max(c.r, max(c.g, c.b)));
+}
+
+void main()
+{
+    // Screen uv with this frame's jitter removed, in render target space
+    vec2 uv = (vScreenUV + ubo.jitter) * ubo.uvScale;
+    ivec2 center = ivec2(uv / ubo.renderSize.zw);
+    ivec2 maxCoord = ivec2(ubo.renderSize.xy) - 1;
+    center = clamp(center, ivec2(0), maxCoord);
+
+    vec3 current = texture(colorTex, min(uv, (ubo.renderSize.xy - 0.5) * ubo.renderSize.zw)).rgb;
+
+    // Neighborhood bounds and the closest depth for velocity dilation
+    vec3 minColor = vec3(1e9);
+    vec3 maxColor = vec3(-1e9);
+    float closestDepth = 1.0;
+    ivec2 closestCoord = center;
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+            ivec2 coord = clamp(center + ivec2(x, y), ivec2(0), maxCoord);
+            vec3 c = rgbToYCoCg(texelFetch(colorTex, coord, 0).rgb);
+            minColor = min(minColor, c);
+            maxColor = max(maxColor, c);
+
+            float depth = texelFetch(depthTex, coord, 0).r;
+            if (depth < closestDepth) {
+                closestDepth = depth;
+                closestCoord = coord;
+            }
+        }
+    }
+
+    vec2 velocity;
+    if (closestDepth >= 1.0) {
+        // Sky has no motion vectors, reproject with the camera only
+        vec4 clip = vec4(vScreenUV.x * 2.0 - 1.0, 1.0 - vScreenUV.y * 2.0, 1.0, 1.0);
+        vec4 prevClip = ubo.reprojection * clip;
+        vec2 prevUV = vec2(prevClip.x, -prevClip.y) / prevClip.w * 0.5 + 0.5;
+        velocity = vScreenUV - prevUV;
+    } else {
+        velocity = texelFetch(velocityTex, closestCoord, 0).rg;
+    }
+
+    vec2 historyUV = vScreenUV - velocity;
+    bool offscreen = any(lessThan(historyUV, vec2(0.0))) || any(greaterThan(historyUV, vec2(1.0)));
+    if (ubo.historyValid == 0u || offscreen) {
+        outColor = vec4(current, 1.0);
+        return;
+    }
+
+    vec3 history = texture(historyTex, historyUV).rgb;
+    history = yCoCgToRgb(clamp(rgbToYCoCg(history), minColor, maxColor));
+
+    float currentWeight = (1.0 - ubo.feedback) * lumaWeight(current);
+    float historyWeight = ubo.feedback * lumaWeight(history);
+    vec3 result = (current * currentWeight + history * historyWeight) / max(currentWeight + historyWeight, 1e-5);
+
+    outColor = vec4(result, 1.0);
+}
@@ -1,13 +1,28 @@
 #include "shadow_manager.h"
 
+#include <cmath>
+#include <limits>
+
 #include <glm/ext/matrix_clip_space.hpp>
 #include <glm/ext/matrix_transform.hpp>
 
 #include <imgui.h>
 
+#include "../frustum.h"
+#include "../gpu/gpu.h"
+#include "../post_process/post_process.h"
+#include "../profiler/profiler.h"
+#include "../render_manager/render_manager.h"
 #include "../resource_manager/resource_manager.h"
 #include "../utils/utils.h"
 
+// fullscreen.vert reads its block even when the fragment shader ignores the uvs
+static void pushFullscreenUBO(SDL_GPUCommandBuffer *cmd, glm::vec2 uvScale)
+{
+    FullscreenVertexUBO ubo{uvScale, glm::vec2(0.f)};
+    GPU::pushVertexUniformData(cmd, 0, &ubo, sizeof(ubo));
+}
+
 // --- Cascaded shadow map texture (2D array) ---
 ShadowManager::ShadowManager()
 {
@@ -117,9 +132,97 @@ ShadowManager::ShadowManager()
         SDL_ReleaseGPUShader(Utils::device, shadowFrag);
     }
 
+    // --- Depth reduction pipeline (SDSM) ---
+    {
+        SDL_GPUShader *fullscreenVert = Utils::loadShader("src/shaders/fullscreen.vert", 0, 1, SDL_GPU_SHADERSTAGE_VERTEX);
+        SDL_GPUShader *reduceFrag = Utils::loadShader("src/shaders/depth_reduce.frag", 1, 1, SDL_GPU_SHADERSTAGE_FRAGMENT);
+
+        SDL_GPUColorTargetDescription colorTarget{};
+        colorTarget.format = SDL_GPU_TEXTUREFORMAT_R32G32_FLOAT;
+
+        SDL_GPUGraphicsPipelineCreateInfo reduceInfo{};
+        reduceInfo.vertex_shader = fullscreenVert;
+        reduceInfo.fragment_shader = reduceFrag;
+        reduceInfo.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
+        reduceInfo.target_info.num_color_targets = 1;
+        reduceInfo.target_info.color_target_descriptions = &colorTarget;
+
+        m_depthReducePipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &reduceInfo);
+        if (!m_depthReducePipeline)
+        {
+            SDL_Log("Failed to create m_depthReducePipeline: %s", SDL_GetError());
+        }
+
+        SDL_ReleaseGPUShader(Utils::device, fullscreenVert);
+        SDL_ReleaseGPUShader(Utils::device, reduceFrag);
+
+        SDL_GPUTransferBufferCreateInfo readbackInfo{};
+        readbackInfo.usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD;
+        readbackInfo.size = sizeof(glm::vec2);
+        m_depthReadbackBuffer = GPU::createTransferBuffer(Utils::device, &readbackInfo);
+        if (!m_depthReadbackBuffer)
+        {
+            SDL_Log("Failed to create depth readback buffer: %s", SDL_GetError());
+        }
+    }
+
+    // --- EVSM moment blur pipeline ---
+    {
+        SDL_GPUShader *fullscreenVert = Utils::loadShader("src/shaders/fullscreen.vert", 0, 1, SDL_GPU_SHADERSTAGE_VERTEX);
+        SDL_GPUShader *blurFrag = Utils::loadShader("src/shaders/evsm_blur.frag", 1, 1, SDL_GPU_SHADERSTAGE_FRAGMENT);
+
+        SDL_GPUColorTargetDescription colorTarget{};
+        colorTarget.format = SDL_GPU_TEXTUREFORMAT_R32G32B32A32_FLOAT;
+
+        SDL_GPUGraphicsPipelineCreateInfo blurInfo{};
+        blurInfo.vertex_shader = fullscreenVert;
+        blurInfo.fragment_shader = blurFrag;
+        blurInfo.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
+        blurInfo.target_info.num_color_targets = 1;
+        blurInfo.target_info.color_target_descriptions = &colorTarget;
+
+        m_evsmBlurPipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &blurInfo);
+        if (!m_evsmBlurPipeline)
+        {
+            SDL_Log("Failed to create m_evsmBlurPipeline: %s", SDL_GetError());
+        }
+
+        SDL_ReleaseGPUShader(Utils::device, fullscreenVert);
+        SDL_ReleaseGPUShader(Utils::device, blurFrag);
+
+        updateMomentSampler();
+    }
+
+    // --- Screen-space shadow mask pipeline ---
+    {
+        SDL_GPUShader *fullscreenVert = Utils::loadShader("src/shaders/fullscreen.vert", 0, 1, SDL_GPU_SHADERSTAGE_VERTEX);
+        SDL_GPUShader *maskFrag = Utils::loadShader("src/shaders/shadow_mask.frag", 2, 2, SDL_GPU_SHADERSTAGE_FRAGMENT);
+
+        SDL_GPUColorTargetDescription colorTarget{};
+        colorTarget.format = SDL_GPU_TEXTUREFORMAT_R8_UNORM;
+
+        SDL_GPUGraphicsPipelineCreateInfo maskInfo{};
+        maskInfo.vertex_shader = fullscreenVert;
+        maskInfo.fragment_shader = maskFrag;
+        maskInfo.primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST;
+        maskInfo.target_info.num_color_targets = 1;
+        maskInfo.target_info.color_target_descriptions = &colorTarget;
+
+        m_shadowMaskPipeline = SDL_CreateGPUGraphicsPipeline(Utils::device, &maskInfo);
+        if (!m_shadowMaskPipeline)
+        {
+            SDL_Log("Failed to create m_shadowMaskPipeline: %s", SDL_GetError());
+        }
+
+        SDL_ReleaseGPUShader(Utils::device, fullscreenVert);
+        SDL_ReleaseGPUShader(Utils::device, maskFrag);
+    }
+
     m_shadowUniforms.cascadeBias = {0.0005f, 0.0005f, 0.0005f, 0.0005f};
     m_shadowUniforms.shadowFar = 60.f;
     m_shadowUniforms.strength = 0.8f;
+    // exp(2 * 40) still fits in a 32-bit float
+    m_shadowUniforms.evsmParams = {40.f, 5.f, 0.2f, 0.01f};
     m_cascadeLambda = 0.8f;
 }
 
@@ -132,9 +235,31 @@ ShadowManager::~ShadowManager()
     if (m_shadowAnimationPipeline)
         SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_shadowAnimationPipeline);
     if (m_shadowMapTexture)
-        SDL_ReleaseGPUTexture(Utils::device, m_shadowMapTexture);
+        GPU::releaseTexture(Utils::device, m_shadowMapTexture);
+    if (m_staticShadowMapTexture)
+        GPU::releaseTexture(Utils::device, m_staticShadowMapTexture);
     if (m_shadowSampler)
         SDL_ReleaseGPUSampler(Utils::device, m_shadowSampler);
+    if (m_evsmBlurPipeline)
+        SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_evsmBlurPipeline);
+    if (m_evsmTexture)
+        GPU::releaseTexture(Utils::device, m_evsmTexture);
+    if (m_evsmBlurTexture)
+        GPU::releaseTexture(Utils::device, m_evsmBlurTexture);
+    if (m_evsmSampler)
+        SDL_ReleaseGPUSampler(Utils::device, m_evsmSampler);
+    if (m_shadowMaskPipeline)
+        SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_shadowMaskPipeline);
+    if (m_shadowMaskTexture)
+        GPU::releaseTexture(Utils::device, m_shadowMaskTexture);
+    if (m_depthReducePipeline)
+        SDL_ReleaseGPUGraphicsPipeline(Utils::device, m_depthReducePipeline);
+    for (SDL_GPUTexture *texture : m_depthReduceTextures)
+        GPU::releaseTexture(Utils::device, texture);
+    if (m_depthReadbackFence)
+        SDL_ReleaseGPUFence(Utils::device, m_depthReadbackFence);
+    if (m_depthReadbackBuffer)
+        GPU::releaseTransferBuffer(Utils::device, m_depthReadbackBuffer);
 }
 
 void ShadowManager::renderUI()
@@ -152,6 +277,42 @@ void ShadowManager::renderUI()
     ImGui::DragFloat("Shadow Strength", &m_shadowUniforms.strength, 0.01f, 0.f);
     ImGui::DragFloat4("Bias", &m_shadowUniforms.cascadeBias.x, 0.00001f, 0.f, 1.f, "%.5f");
 
+    const char *modeItems[] = {"DPCF", "EVSM"};
+    int shadowMode = m_shadowMode;
+    if (ImGui::Combo("Filtering", &shadowMode, modeItems, IM_ARRAYSIZE(modeItems)))
+        setShadowMode((ShadowMode)shadowMode);
+    if (m_shadowMode == Shadow_EVSM)
+    {
+        ImGui::DragFloat2("EVSM Exponents", &m_shadowUniforms.evsmParams.x, 0.1f, 0.f, 42.f);
+        ImGui::DragFloat("Light Bleeding Reduction", &m_shadowUniforms.evsmParams.z, 0.01f, 0.f, 0.99f);
+        ImGui::DragFloat("Variance Bias", &m_shadowUniforms.evsmParams.w, 0.001f, 0.f, 1.f, "%.4f");
+        if (ImGui::SliderInt("Blur Radius", &m_evsmBlurRadius, 0, 8))
+            invalidateCache();
+        if (ImGui::Checkbox("Mipmaps", &m_evsmMipmaps))
+            updateMomentTextures();
+        if (ImGui::SliderFloat("Anisotropy", &m_evsmAnisotropy, 1.f, 16.f))
+            updateMomentSampler();
+    }
+
+    ImGui::Checkbox("Screen-Space Mask", &m_screenSpaceMask);
+    if (m_screenSpaceMask)
+        ImGui::SliderInt("Mask Tap Count", &m_maskTapCount, 1, 64);
+    if (ImGui::SliderInt("Active Cascades", &m_activeCascades, 1, NUM_CASCADES))
+        invalidateCache();
+    ImGui::Checkbox("Sample Distribution (SDSM)", &m_sdsmEnabled);
+    if (m_sdsmEnabled)
+    {
+        ImGui::Checkbox("Fit To Receivers", &m_fitToReceivers);
+        ImGui::Text("Depth Bounds: %.4f - %.4f%s", m_depthBounds.x, m_depthBounds.y, m_depthBoundsValid ? "" : " (invalid)");
+    }
+
+    if (ImGui::Checkbox("Cache Static Casters", &m_cacheStaticCasters))
+        invalidateCache();
+    ImGui::DragInt("Cascade Update Interval", &m_cascadeUpdateInterval, 0.1f, 1, 16);
+    if (ImGui::Button("Invalidate Cache"))
+        invalidateCache();
+    ImGui::Text("Updated Cascades: %d (static: %d)", m_updatedCascades, m_updatedStaticCascades);
+
     // TODO:
     /* if (ImGui::TreeNodeEx("Camera", ImGuiTreeNodeFlags_DefaultOpen))
     {
@@ -167,6 +328,11 @@ void ShadowManager::renderUI()
         // TODO: layers
         ImGui::Text("Shadowmap");
         ImGui::Image((ImTextureID)(m_shadowMapTexture), ImVec2(256, 256));
+        if (m_evsmTexture)
+        {
+            ImGui::Text("EVSM Moments");
+            ImGui::Image((ImTextureID)(m_evsmTexture), ImVec2(256, 256));
+        }
 
         ImGui::TreePop();
     }
@@ -178,7 +344,7 @@ void ShadowManager::updateTexture()
 {
     if (m_shadowMapTexture)
     {
-        SDL_ReleaseGPUTexture(Utils::device, m_shadowMapTexture);
+        GPU::releaseTexture(Utils::device, m_shadowMapTexture);
         m_shadowMapTexture = nullptr;
     }
 
@@ -192,12 +358,124 @@ void ShadowManager::updateTexture()
     shadowInfo.num_levels = 1;
     shadowInfo.sample_count = SDL_GPU_SAMPLECOUNT_1;
 
-    m_shadowMapTexture = SDL_CreateGPUTexture(Utils::device, &shadowInfo);
+    m_shadowMapTexture = GPU::createTexture(Utils::device, &shadowInfo, GPUMemoryCategory::Shadow);
 
     if (!m_shadowMapTexture)
     {
         SDL_Log("Failed to create shadow map texture: %s", SDL_GetError());
     }
+
+    if (m_staticShadowMapTexture)
+    {
+        GPU::releaseTexture(Utils::device, m_staticShadowMapTexture);
+        m_staticShadowMapTexture = nullptr;
+    }
+
+    shadowInfo.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+    m_staticShadowMapTexture = GPU::createTexture(Utils::device, &shadowInfo, GPUMemoryCategory::Shadow);
+
+    if (!m_staticShadowMapTexture)
+    {
+        SDL_Log("Failed to create static shadow map texture: %s", SDL_GetError());
+    }
+
+    updateMomentTextures();
+    invalidateCache();
+}
+
+void ShadowManager::setShadowMode(ShadowMode mode)
+{
+    m_shadowMode = mode;
+    updateMomentTextures();
+}
+
+void ShadowManager::updateMomentTextures()
+{
+    if (m_evsmTexture)
+    {
+        GPU::releaseTexture(Utils::device, m_evsmTexture);
+        m_evsmTexture = nullptr;
+    }
+    if (m_evsmBlurTexture)
+    {
+        GPU::releaseTexture(Utils::device, m_evsmBlurTexture);
+        m_evsmBlurTexture = nullptr;
+    }
+
+    // Moments are only kept around while EVSM is selected
+    if (m_shadowMode != Shadow_EVSM)
+        return;
+
+    SDL_GPUTextureCreateInfo info{};
+    info.type = SDL_GPU_TEXTURETYPE_2D_ARRAY;
+    info.format = SDL_GPU_TEXTUREFORMAT_R32G32B32A32_FLOAT;
+    info.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
+    info.width = m_shadowMapResolution;
+    info.height = m_shadowMapResolution;
+    info.layer_count_or_depth = NUM_CASCADES;
+    info.num_levels = m_evsmMipmaps ? (int)std::floor(std::log2(m_shadowMapResolution)) + 1 : 1;
+    info.sample_count = SDL_GPU_SAMPLECOUNT_1;
+
+    m_evsmTexture = GPU::createTexture(Utils::device, &info, GPUMemoryCategory::Shadow);
+    if (!m_evsmTexture)
+    {
+        SDL_Log("Failed to create EVSM texture: %s", SDL_GetError());
+    }
+
+    info.layer_count_or_depth = 1;
+    info.num_levels = 1;
+    m_evsmBlurTexture = GPU::createTexture(Utils::device, &info, GPUMemoryCategory::Shadow);
+    if (!m_evsmBlurTexture)
+    {
+        SDL_Log("Failed to create EVSM blur texture: %s", SDL_GetError());
+    }
+
+    // Every layer has to be filtered again
+    invalidateCache();
+}
+
+void ShadowManager::updateMomentSampler()
+{
+    if (m_evsmSampler)
+    {
+        SDL_ReleaseGPUSampler(Utils::device, m_evsmSampler);
+        m_evsmSampler = nullptr;
+    }
+
+    SDL_GPUSamplerCreateInfo samplerInfo{};
+    samplerInfo.min_filter = SDL_GPU_FILTER_LINEAR;
+    samplerInfo.mag_filter = SDL_GPU_FILTER_LINEAR;
+    samplerInfo.mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR;
+    samplerInfo.address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+    samplerInfo.address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+    samplerInfo.address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE;
+    samplerInfo.enable_anisotropy = m_evsmAnisotropy > 1.f;
+    samplerInfo.max_anisotropy = m_evsmAnisotropy;
+    samplerInfo.min_lod = 0.0f;
+    samplerInfo.max_lod = 1000.0f;
+
+    m_evsmSampler = SDL_CreateGPUSampler(Utils::device, &samplerInfo);
+    if (!m_evsmSampler)
+    {
+        SDL_Log("Failed to create EVSM sampler: %s", SDL_GetError());
+    }
+}
+
+SDL_GPUTextureSamplerBinding ShadowManager::getShadowMapBinding() const
+{
+    if (m_shadowUniforms.shadowMode == Shadow_EVSM)
+        return {m_evsmTexture, m_evsmSampler};
+
+    return {m_shadowMapTexture, m_shadowSampler};
+}
+
+void ShadowManager::invalidateCache()
+{
+    for (int i = 0; i < NUM_CASCADES; ++i)
+    {
+        m_cascadeValid[i] = false;
+        m_staticCacheDirty[i] = true;
+    }
 }
 
 void ShadowManager::updateCascades(
@@ -206,8 +484,32 @@ void ShadowManager::updateCascades(
     const glm::vec3 &lightDir,
     float aspect)
 {
+    readDepthBounds();
+
     float nearClip = camera->near;
     float farClip = m_shadowUniforms.shadowFar;
+
+    // SDSM: tighten the split range to the visible depth of last frame
+    if (m_sdsmEnabled && m_depthBoundsValid)
+    {
+        // Stored depth is clip z / w, invert the projection to get view distance
+        const glm::mat4 invProj = glm::inverse(camera->projection);
+        auto linearize = [&invProj](float depth) {
+            glm::vec4 p = invProj * glm::vec4(0.0f, 0.0f, depth, 1.0f);
+            return -p.z / p.w;
+        };
+
+        // Quantize in ~9% steps so small depth changes don't move every cascade
+        const float steps = 8.f;
+        float minDepth = std::exp2(std::floor(std::log2(glm::max(linearize(m_depthBounds.x), camera->near)) * steps) / steps);
+        float maxDepth = std::exp2(std::ceil(std::log2(glm::max(linearize(m_depthBounds.y), camera->near)) * steps) / steps);
+
+        nearClip = glm::clamp(minDepth, camera->near, farClip);
+        farClip = glm::clamp(maxDepth, nearClip + 0.1f, farClip);
+    }
+
+    m_activeCascades = glm::clamp(m_activeCascades, 1, NUM_CASCADES);
+
     float clipRange = farClip - nearClip;
 
     float minZ = nearClip;
@@ -220,7 +522,7 @@ void ShadowManager::updateCascades(
     // 1. Calculate Split Distances
     for (int i = 0; i < NUM_CASCADES; ++i)
     {
-        float p = (i + 1) / static_cast<float>(NUM_CASCADES);
+        float p = glm::min((i + 1) / static_cast<float>(m_activeCascades), 1.f);
         float logSplit = minZ * std::pow(ratio, p);
         float uniSplit = minZ + range * p;
         float d = m_cascadeLambda * (logSplit - uniSplit) + uniSplit;
@@ -243,6 +545,35 @@ void ShadowManager::updateCascades(
         float nearDist = nearClip + prevSplitDist * clipRange;
         float farDist = nearClip + splitDist * clipRange;
 
+        // The shader picks this cascade past the previous cascade's stored split
+        float selectedFrom = (i == 0) ? nearClip : (&cascadeFarPlanes.x)[i - 1];
+        bool lastCascade = i == m_activeCascades - 1;
+
+        // Inactive cascades are never selected by the shader and never rendered
+        (&cascadeFarPlanes.x)[i] = std::numeric_limits<float>::max();
+        if (i >= m_activeCascades)
+        {
+            m_cascadeUpdate[i] = false;
+            continue;
+        }
+
+        // Time-slicing: far cascades keep last matrices and splits until their slot comes up,
+        // unless the moved splits send receivers to them that their old fit doesn't cover
+        int interval = glm::max(m_cascadeUpdateInterval, 1);
+        bool fitCovers = m_cascadeValid[i] && selectedFrom >= m_cascadeNear[i] && (!lastCascade || farDist <= m_cascadeFar[i]);
+        m_cascadeUpdate[i] = !fitCovers || i == 0 || ((m_frameIndex + i) % interval) == 0;
+        if (!m_cascadeUpdate[i])
+        {
+            if (!lastCascade)
+                (&cascadeFarPlanes.x)[i] = m_cascadeFar[i];
+            continue;
+        }
+
+        // Start where the shader starts selecting, a skipped neighbour may keep an older split
+        nearDist = glm::min(selectedFrom, farDist);
+        if (!lastCascade)
+            (&cascadeFarPlanes.x)[i] = farDist;
+
         // 2. Reconstruct Frustum Corners (View Space)
         float xn = nearDist * tanHalfFovX;
         float yn = nearDist * tanHalfFovY;
@@ -291,10 +622,29 @@ void ShadowManager::updateCascades(
         // 6. Texel Snapping
         // Transform center to Light Space
         glm::vec4 centerLS = lightView * glm::vec4(frustumCenter, 1.0f);
+        float extent = radius;
+
+        // Fit to the light-space bounds of the depth-tightened slice instead of its sphere
+        if (m_sdsmEnabled && m_depthBoundsValid && m_fitToReceivers)
+        {
+            glm::vec2 minLS(std::numeric_limits<float>::max());
+            glm::vec2 maxLS(std::numeric_limits<float>::lowest());
+            for (int j = 0; j < 8; ++j)
+            {
+                glm::vec2 cornerLS = glm::vec2(lightView * glm::vec4(frustumCornersVS[j], 1.0f));
+                minLS = glm::min(minLS, cornerLS);
+                maxLS = glm::max(maxLS, cornerLS);
+            }
+
+            float halfSize = glm::max(maxLS.x - minLS.x, maxLS.y - minLS.y) * 0.5f;
+            extent = glm::min(std::ceil(halfSize * 16.0f) / 16.0f, radius);
+            centerLS.x = (minLS.x + maxLS.x) * 0.5f;
+            centerLS.y = (minLS.y + maxLS.y) * 0.5f;
+        }
 
         // Calculate texel size
         float shadowMapSize = static_cast<float>(m_shadowMapResolution);
-        float texelsPerUnit = shadowMapSize / (radius * 2.0f);
+        float texelsPerUnit = shadowMapSize / (extent * 2.0f);
 
         // Snap to grid
         centerLS.x = glm::floor(centerLS.x * texelsPerUnit) / texelsPerUnit;
@@ -313,8 +663,8 @@ void ShadowManager::updateCascades(
         float zFarDist = zMargin + radius * 2.0f;
 
         glm::mat4 lightProj = glm::orthoRH_ZO(
-            -radius, radius,
-            -radius, radius,
+            -extent, extent,
+            -extent, extent,
             zFarDist,
             0.f);
 
@@ -327,10 +677,440 @@ void ShadowManager::updateCascades(
         m_shadowUniforms.depthBiasVP[i] = m_biasMatrix * lightProj * lightView;
         m_cascades[i].view = lightView;
         m_cascades[i].projection = lightProj;
+        m_cascadeNear[i] = nearDist;
+        m_cascadeFar[i] = farDist;
+        m_cascadeValid[i] = true;
 
-        (&cascadeFarPlanes.x)[i] = nearClip + splitDist * clipRange;
+        // Static content only needs a redraw when the snapped light matrix moved
+        if (m_staticViewProj[i] != lightProj * lightView)
+            m_staticCacheDirty[i] = true;
     }
 
     m_shadowUniforms.cameraView = view;
     m_shadowUniforms.cascadeSplits = cascadeFarPlanes;
+    m_shadowUniforms.screenMask = (m_screenSpaceMask && m_shadowMaskPipeline) ? 1 : 0;
+    m_shadowUniforms.shadowMode = (m_shadowMode == Shadow_EVSM && m_evsmTexture && m_evsmBlurTexture && m_evsmSampler && m_evsmBlurPipeline)
+                                      ? Shadow_EVSM
+                                      : Shadow_DPCF;
+    m_frameIndex++;
+}
+
+void ShadowManager::updateReduceTextures(glm::ivec2 size)
+{
+    for (SDL_GPUTexture *texture : m_depthReduceTextures)
+        GPU::releaseTexture(Utils::device, texture);
+    m_depthReduceTextures.clear();
+    m_depthReduceSizes.clear();
+
+    m_depthReduceSourceSize = size;
+
+    // Each pass reduces a 4x4 block, down to a single texel
+    glm::ivec2 reduceSize = size;
+    do
+    {
+        reduceSize = glm::max((reduceSize + 3) / 4, glm::ivec2(1));
+
+        SDL_GPUTextureCreateInfo info{};
+        info.type = SDL_GPU_TEXTURETYPE_2D;
+        info.format = SDL_GPU_TEXTUREFORMAT_R32G32_FLOAT;
+        info.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
+        info.width = reduceSize.x;
+        info.height = reduceSize.y;
+        info.layer_count_or_depth = 1;
+        info.num_levels = 1;
+        info.sample_count = SDL_GPU_SAMPLECOUNT_1;
+
+        SDL_GPUTexture *texture = GPU::createTexture(Utils::device, &info, GPUMemoryCategory::Shadow);
+        if (!texture)
+        {
+            SDL_Log("Failed to create depth reduce texture: %s", SDL_GetError());
+            break;
+        }
+
+        m_depthReduceTextures.push_back(texture);
+        m_depthReduceSizes.push_back(reduceSize);
+    } while (reduceSize.x > 1 || reduceSize.y > 1);
+}
+
+// Starts from mip 0 of the Hi-Z pyramid, the chain is sized for the whole
+// texture and only the first pass is limited to the render region
+void ShadowManager::reduceDepth(SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *hiZTexture, glm::ivec2 size, glm::ivec2 region)
+{
+    // Only one readback in flight, the previous result is still being waited on
+    if (!m_sdsmEnabled || m_depthReadbackFence || !m_depthReducePipeline || !m_depthReadbackBuffer)
+        return;
+
+    if (size != m_depthReduceSourceSize)
+        updateReduceTextures(size);
+
+    if (m_depthReduceTextures.empty() || m_depthReduceSizes.back() != glm::ivec2(1))
+        return;
+
+    SDL_GPUTexture *source = hiZTexture;
+    glm::ivec2 sourceSize = region;
+
+    for (size_t i = 0; i < m_depthReduceTextures.size(); ++i)
+    {
+        SDL_GPUColorTargetInfo target{};
+        target.texture = m_depthReduceTextures[i];
+        target.load_op = SDL_GPU_LOADOP_DONT_CARE;
+        target.store_op = SDL_GPU_STOREOP_STORE;
+
+        SDL_GPURenderPass *pass = GPU::beginRenderPass(cmd, &target, 1, nullptr);
+        GPU::bindGraphicsPipeline(pass, m_depthReducePipeline);
+        pushFullscreenUBO(cmd, glm::vec2(1.f));
+
+        DepthReduceUniforms uniforms{};
+        uniforms.sourceSize = sourceSize;
+        GPU::pushFragmentUniformData(cmd, 0, &uniforms, sizeof(uniforms));
+
+        SDL_GPUTextureSamplerBinding binding{source, m_shadowSampler};
+        GPU::bindFragmentSamplers(pass, 0, &binding, 1);
+
+        GPU::drawPrimitives(pass, 3, 1, 0, 0);
+        SDL_EndGPURenderPass(pass);
+
+        source = m_depthReduceTextures[i];
+        sourceSize = m_depthReduceSizes[i];
+    }
+
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmd);
+
+    SDL_GPUTextureRegion region{};
+    region.texture = source;
+    region.w = 1;
+    region.h = 1;
+    region.d = 1;
+
+    SDL_GPUTextureTransferInfo transfer{};
+    transfer.transfer_buffer = m_depthReadbackBuffer;
+
+    SDL_DownloadFromGPUTexture(copyPass, &region, &transfer);
+    SDL_EndGPUCopyPass(copyPass);
+
+    m_depthReadbackPending = true;
+}
+
+void ShadowManager::setReadbackFence(SDL_GPUFence *fence)
+{
+    m_depthReadbackFence = fence;
+    m_depthReadbackPending = false;
+}
+
+void ShadowManager::readDepthBounds()
+{
+    if (!m_sdsmEnabled)
+        m_depthBoundsValid = false;
+
+    if (!m_depthReadbackFence || !SDL_QueryGPUFence(Utils::device, m_depthReadbackFence))
+        return;
+
+    SDL_ReleaseGPUFence(Utils::device, m_depthReadbackFence);
+    m_depthReadbackFence = nullptr;
+
+    const float *data = (const float *)SDL_MapGPUTransferBuffer(Utils::device, m_depthReadbackBuffer, false);
+    if (!data)
+    {
+        SDL_Log("Failed to map depth readback buffer: %s", SDL_GetError());
+        return;
+    }
+
+    m_depthBounds = glm::vec2(data[0], data[1]);
+    SDL_UnmapGPUTransferBuffer(Utils::device, m_depthReadbackBuffer);
+
+    // min > max when only the sky was visible
+    m_depthBoundsValid = m_sdsmEnabled && m_depthBounds.x <= m_depthBounds.y;
+}
+
+void ShadowManager::updateShadowMaskTexture(glm::ivec2 size)
+{
+    if (m_shadowMaskTexture)
+    {
+        GPU::releaseTexture(Utils::device, m_shadowMaskTexture);
+        m_shadowMaskTexture = nullptr;
+    }
+
+    m_shadowMaskSize = size;
+
+    SDL_GPUTextureCreateInfo info{};
+    info.type = SDL_GPU_TEXTURETYPE_2D;
+    info.format = SDL_GPU_TEXTUREFORMAT_R8_UNORM;
+    info.usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER;
+    info.width = size.x;
+    info.height = size.y;
+    info.layer_count_or_depth = 1;
+    info.num_levels = 1;
+    info.sample_count = SDL_GPU_SAMPLECOUNT_1;
+
+    m_shadowMaskTexture = GPU::createTexture(Utils::device, &info, GPUMemoryCategory::Shadow);
+    if (!m_shadowMaskTexture)
+    {
+        SDL_Log("Failed to create shadow mask texture: %s", SDL_GetError());
+    }
+}
+
+void ShadowManager::renderScreenMask(
+    SDL_GPUCommandBuffer *cmd,
+    SDL_GPUTexture *depthTexture,
+    glm::ivec2 size,
+    glm::ivec2 renderSize,
+    const glm::mat4 &view,
+    const glm::mat4 &projection,
+    const glm::vec3 &viewPos,
+    const glm::vec3 &lightDir)
+{
+    if (size != m_shadowMaskSize)
+        updateShadowMaskTexture(size);
+
+    if (!m_shadowMaskTexture || !m_shadowMaskPipeline)
+        return;
+
+    SDL_GPUColorTargetInfo target{};
+    target.texture = m_shadowMaskTexture;
+    target.load_op = SDL_GPU_LOADOP_DONT_CARE;
+    target.store_op = SDL_GPU_STOREOP_STORE;
+
+    SDL_GPURenderPass *pass = GPU::beginRenderPass(cmd, &target, 1, nullptr);
+    GPU::bindGraphicsPipeline(pass, m_shadowMaskPipeline);
+
+    // Only the dynamic resolution region holds depth, pbr.frag fetches the mask at the same texels
+    SDL_GPUViewport viewport{};
+    viewport.w = static_cast<float>(renderSize.x);
+    viewport.h = static_cast<float>(renderSize.y);
+    viewport.min_depth = 0.0f;
+    viewport.max_depth = 1.0f;
+    GPU::setViewport(pass, &viewport);
+
+    SDL_Rect scissor{0, 0, renderSize.x, renderSize.y};
+    GPU::setScissor(pass, &scissor);
+    pushFullscreenUBO(cmd, glm::vec2(renderSize) / glm::vec2(glm::max(size, glm::ivec2(1))));
+
+    ShadowMaskUniforms uniforms{};
+    uniforms.invViewProj = glm::inverse(projection * view);
+    uniforms.viewPos = viewPos;
+    uniforms.tapCount = (Uint32)glm::clamp(m_maskTapCount, 1, 64);
+    uniforms.lightDir = lightDir;
+
+    GPU::pushFragmentUniformData(cmd, 0, &m_shadowUniforms, sizeof(ShadowUniforms));
+    GPU::pushFragmentUniformData(cmd, 1, &uniforms, sizeof(uniforms));
+
+    SDL_GPUTextureSamplerBinding bindings[2];
+    bindings[0] = {depthTexture, m_shadowSampler};
+    bindings[1] = getShadowMapBinding();
+    GPU::bindFragmentSamplers(pass, 0, bindings, 2);
+
+    GPU::drawPrimitives(pass, 3, 1, 0, 0);
+    SDL_EndGPURenderPass(pass);
+}
+
+void ShadowManager::renderCasters(
+    SDL_GPUCommandBuffer *cmd,
+    SDL_GPURenderPass *pass,
+    const std::vector<Renderable *> &renderables,
+    const glm::mat4 &lightViewProj,
+    int casterMask)
+{
+    SDL_GPUViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.w = static_cast<float>(m_shadowMapResolution);
+    viewport.h = static_cast<float>(m_shadowMapResolution);
+    viewport.min_depth = 0.0f;
+    viewport.max_depth = 1.0f;
+
+    const Frustum frustum = Frustum::fromMatrix(lightViewProj);
+
+    auto accepted = [casterMask](Renderable *r) {
+        int type = r->isStaticShadowCaster() ? ShadowCaster_Static : ShadowCaster_Dynamic;
+        return (casterMask & type) != 0;
+    };
+
+    GPU::bindGraphicsPipeline(pass, m_shadowPipeline);
+    GPU::setViewport(pass, &viewport);
+
+    for (Renderable *r : renderables)
+    {
+        if (accepted(r))
+            r->renderShadow(cmd, pass, lightViewProj, frustum);
+    }
+
+    GPU::bindGraphicsPipeline(pass, m_shadowDoubleSidedPipeline);
+    GPU::setViewport(pass, &viewport);
+
+    for (Renderable *r : renderables)
+    {
+        if (accepted(r))
+            r->renderShadowDoubleSided(cmd, pass, lightViewProj, frustum);
+    }
+
+    GPU::bindGraphicsPipeline(pass, m_shadowAnimationPipeline);
+    GPU::setViewport(pass, &viewport);
+
+    for (Renderable *r : renderables)
+    {
+        if (accepted(r))
+            r->renderAnimationShadow(cmd, pass, lightViewProj, frustum);
+    }
+}
+
+void ShadowManager::renderCascades(
+    SDL_GPUCommandBuffer *cmd,
+    const std::vector<Renderable *> &renderables)
+{
+    m_updatedCascades = 0;
+    m_updatedStaticCascades = 0;
+
+    SDL_GPUColorTargetInfo colorTargetInfo{};
+    colorTargetInfo.clear_color = {1.f, 0.f, 0.f, 0.0f};
+    colorTargetInfo.load_op = SDL_GPU_LOADOP_CLEAR;
+    colorTargetInfo.store_op = SDL_GPU_STOREOP_STORE;
+
+    // No cache: every due cascade gets all casters from scratch
+    if (!m_cacheStaticCasters || !m_staticShadowMapTexture)
+    {
+        colorTargetInfo.texture = m_shadowMapTexture;
+
+        for (int i = 0; i < NUM_CASCADES; ++i)
+        {
+            if (!m_cascadeUpdate[i])
+                continue;
+
+            ProfileScope zone("Cascade", i);
+            colorTargetInfo.layer_or_depth_plane = i;
+            SDL_GPURenderPass *pass = GPU::beginRenderPass(cmd, &colorTargetInfo, 1, nullptr);
+            renderCasters(cmd, pass, renderables, m_cascades[i].projection * m_cascades[i].view, ShadowCaster_All);
+            SDL_EndGPURenderPass(pass);
+
+            m_updatedCascades++;
+        }
+
+        filterMoments(cmd);
+        return;
+    }
+
+    // 1. Refresh static cache layers whose light matrix changed
+    colorTargetInfo.texture = m_staticShadowMapTexture;
+
+    for (int i = 0; i < NUM_CASCADES; ++i)
+    {
+        if (!m_cascadeUpdate[i] || !m_staticCacheDirty[i])
+            continue;
+
+        ProfileScope zone("Static Cascade", i);
+        const glm::mat4 lightViewProj = m_cascades[i].projection * m_cascades[i].view;
+
+        colorTargetInfo.layer_or_depth_plane = i;
+        SDL_GPURenderPass *pass = GPU::beginRenderPass(cmd, &colorTargetInfo, 1, nullptr);
+        renderCasters(cmd, pass, renderables, lightViewProj, ShadowCaster_Static);
+        SDL_EndGPURenderPass(pass);
+
+        m_staticViewProj[i] = lightViewProj;
+        m_staticCacheDirty[i] = false;
+        m_updatedStaticCascades++;
+    }
+
+    // 2. Restore static content into the live shadow map
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmd);
+    for (int i = 0; i < NUM_CASCADES; ++i)
+    {
+        if (!m_cascadeUpdate[i])
+            continue;
+
+        SDL_GPUTextureLocation src{};
+        src.texture = m_staticShadowMapTexture;
+        src.layer = i;
+
+        SDL_GPUTextureLocation dst{};
+        dst.texture = m_shadowMapTexture;
+        dst.layer = i;
+
+        SDL_CopyGPUTextureToTexture(copyPass, &src, &dst, m_shadowMapResolution, m_shadowMapResolution, 1, false);
+    }
+    SDL_EndGPUCopyPass(copyPass);
+
+    // 3. Dynamic casters on top of the cached content
+    colorTargetInfo.texture = m_shadowMapTexture;
+    colorTargetInfo.load_op = SDL_GPU_LOADOP_LOAD;
+
+    for (int i = 0; i < NUM_CASCADES; ++i)
+    {
+        if (!m_cascadeUpdate[i])
+            continue;
+
+        ProfileScope zone("Cascade", i);
+        colorTargetInfo.layer_or_depth_plane = i;
+        SDL_GPURenderPass *pass = GPU::beginRenderPass(cmd, &colorTargetInfo, 1, nullptr);
+        renderCasters(cmd, pass, renderables, m_cascades[i].projection * m_cascades[i].view, ShadowCaster_Dynamic);
+        SDL_EndGPURenderPass(pass);
+
+        m_updatedCascades++;
+    }
+
+    filterMoments(cmd);
+}
+
+void ShadowManager::filterMoments(SDL_GPUCommandBuffer *cmd)
+{
+    if (m_shadowUniforms.shadowMode != Shadow_EVSM || m_updatedCascades == 0)
+        return;
+
+    EVSMBlurUniforms uniforms{};
+    uniforms.exponents = glm::vec2(m_shadowUniforms.evsmParams);
+    uniforms.radius = glm::clamp(m_evsmBlurRadius, 0, 8);
+
+    for (int i = 0; i < NUM_CASCADES; ++i)
+    {
+        if (!m_cascadeUpdate[i])
+            continue;
+
+        // 1. Horizontal: warp the depth layer into moments
+        {
+            SDL_GPUColorTargetInfo target{};
+            target.texture = m_evsmBlurTexture;
+            target.load_op = SDL_GPU_LOADOP_DONT_CARE;
+            target.store_op = SDL_GPU_STOREOP_STORE;
+
+            SDL_GPURenderPass *pass = GPU::beginRenderPass(cmd, &target, 1, nullptr);
+            GPU::bindGraphicsPipeline(pass, m_evsmBlurPipeline);
+            pushFullscreenUBO(cmd, glm::vec2(1.f));
+
+            uniforms.direction = glm::ivec2(1, 0);
+            uniforms.layer = i;
+            uniforms.convertDepth = 1;
+            GPU::pushFragmentUniformData(cmd, 0, &uniforms, sizeof(uniforms));
+
+            SDL_GPUTextureSamplerBinding binding{m_shadowMapTexture, m_shadowSampler};
+            GPU::bindFragmentSamplers(pass, 0, &binding, 1);
+
+            GPU::drawPrimitives(pass, 3, 1, 0, 0);
+            SDL_EndGPURenderPass(pass);
+        }
+
+        // 2. Vertical: into the cascade's layer of the moment array
+        {
+            SDL_GPUColorTargetInfo target{};
+            target.texture = m_evsmTexture;
+            target.layer_or_depth_plane = i;
+            target.load_op = SDL_GPU_LOADOP_DONT_CARE;
+            target.store_op = SDL_GPU_STOREOP_STORE;
+
+            SDL_GPURenderPass *pass = GPU::beginRenderPass(cmd, &target, 1, nullptr);
+            GPU::bindGraphicsPipeline(pass, m_evsmBlurPipeline);
+            pushFullscreenUBO(cmd, glm::vec2(1.f));
+
+            uniforms.direction = glm::ivec2(0, 1);
+            uniforms.layer = 0;
+            uniforms.convertDepth = 0;
+            GPU::pushFragmentUniformData(cmd, 0, &uniforms, sizeof(uniforms));
+
+            SDL_GPUTextureSamplerBinding binding{m_evsmBlurTexture, m_shadowSampler};
+            GPU::bindFragmentSamplers(pass, 0, &binding, 1);
+
+            GPU::drawPrimitives(pass, 3, 1, 0, 0);
+            SDL_EndGPURenderPass(pass);
+        }
+    }
+
+    if (m_evsmMipmaps)
+        SDL_GenerateMipmapsForGPUTexture(cmd, m_evsmTexture);
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <glm/glm.hpp>
 
 #include <SDL3/SDL_gpu.h>
@@ -10,6 +12,21 @@
 const int MAX_CASCADES = 4;
 const int NUM_CASCADES = 4;
 
+class Renderable;
+
+enum ShadowCasterType
+{
+    ShadowCaster_Static = 1 << 0,
+    ShadowCaster_Dynamic = 1 << 1,
+    ShadowCaster_All = ShadowCaster_Static | ShadowCaster_Dynamic,
+};
+
+enum ShadowMode
+{
+    Shadow_DPCF = 0,
+    Shadow_EVSM = 1,
+};
+
 struct ShadowUniforms
 {
     glm::mat4 depthBiasVP[MAX_CASCADES]; // per-cascade light VP
@@ -18,7 +35,34 @@ struct ShadowUniforms
     glm::vec4 cascadeBias;
     float shadowFar;
     float strength;
-    float padding[2];
+    Uint32 screenMask; // opaque shading reads the screen-space mask instead of filtering
+    Uint32 shadowMode;
+    glm::vec4 evsmParams; // positive exponent, negative exponent, light bleeding reduction, variance bias
+};
+
+struct ShadowMaskUniforms
+{
+    glm::mat4 invViewProj;
+    glm::vec3 viewPos;
+    Uint32 tapCount;
+    glm::vec3 lightDir;
+    float padding;
+};
+
+struct DepthReduceUniforms
+{
+    glm::ivec2 sourceSize;
+    glm::ivec2 padding;
+};
+
+struct EVSMBlurUniforms
+{
+    glm::ivec2 direction;
+    glm::vec2 exponents;
+    int layer;
+    int convertDepth;
+    int radius;
+    int padding;
 };
 
 struct Cascade
@@ -36,22 +80,111 @@ public:
     int m_shadowMapResolution = 1024;
     float m_cascadeLambda = 0.5f;
 
+    // Static casters are rendered once per cascade into m_staticShadowMapTexture
+    // and copied into the live shadow map, dynamic casters are drawn on top.
+    bool m_cacheStaticCasters = true;
+    // Cascade 0 updates every frame, the farther ones round-robin every N frames
+    int m_cascadeUpdateInterval = 2;
+
+    // Resolve cascaded shadowing once per pixel from a depth prepass
+    bool m_screenSpaceMask = false;
+    int m_maskTapCount = 16;
+
+    // Cascades beyond this count are skipped and never selected
+    int m_activeCascades = NUM_CASCADES;
+
+    // Sample distribution shadow maps: splits follow last frame's min/max scene depth
+    bool m_sdsmEnabled = true;
+    bool m_fitToReceivers = true;
+    bool m_depthBoundsValid = false;
+    glm::vec2 m_depthBounds{0.f, 1.f}; // raw min/max depth, sky excluded
+
+    // EVSM: updated cascades are warped into moments and blurred, receivers take one filtered sample
+    ShadowMode m_shadowMode = Shadow_DPCF;
+    int m_evsmBlurRadius = 2;
+    bool m_evsmMipmaps = true;
+    float m_evsmAnisotropy = 8.f;
+
     // GPU objects
     SDL_GPUTexture *m_shadowMapTexture = nullptr;
+    SDL_GPUTexture *m_staticShadowMapTexture = nullptr;
     SDL_GPUSampler *m_shadowSampler = nullptr;
     SDL_GPUGraphicsPipeline *m_shadowPipeline = nullptr;
     SDL_GPUGraphicsPipeline *m_shadowDoubleSidedPipeline = nullptr;
     SDL_GPUGraphicsPipeline *m_shadowAnimationPipeline = nullptr;
 
+    // EVSM moments (RGBA32F array) and the horizontal blur intermediate
+    SDL_GPUGraphicsPipeline *m_evsmBlurPipeline = nullptr;
+    SDL_GPUTexture *m_evsmTexture = nullptr;
+    SDL_GPUTexture *m_evsmBlurTexture = nullptr;
+    SDL_GPUSampler *m_evsmSampler = nullptr;
+
+    // Screen-space shadow mask
+    SDL_GPUGraphicsPipeline *m_shadowMaskPipeline = nullptr;
+    SDL_GPUTexture *m_shadowMaskTexture = nullptr;
+    glm::ivec2 m_shadowMaskSize{0};
+
+    // Depth reduction chain and readback
+    SDL_GPUGraphicsPipeline *m_depthReducePipeline = nullptr;
+    std::vector<SDL_GPUTexture *> m_depthReduceTextures;
+    std::vector<glm::ivec2> m_depthReduceSizes;
+    glm::ivec2 m_depthReduceSourceSize{0};
+    SDL_GPUTransferBuffer *m_depthReadbackBuffer = nullptr;
+    SDL_GPUFence *m_depthReadbackFence = nullptr;
+    bool m_depthReadbackPending = false;
+
     // CPU-side uniform data
     ShadowUniforms m_shadowUniforms{};
     Cascade m_cascades[NUM_CASCADES];
 
+    // Cascade scheduling / static cache state
+    Uint64 m_frameIndex = 0;
+    bool m_cascadeValid[NUM_CASCADES] = {};
+    bool m_cascadeUpdate[NUM_CASCADES] = {};
+    // View-space depth range each cascade's matrix was fitted to
+    float m_cascadeNear[NUM_CASCADES] = {};
+    float m_cascadeFar[NUM_CASCADES] = {};
+    bool m_staticCacheDirty[NUM_CASCADES] = {};
+    glm::mat4 m_staticViewProj[NUM_CASCADES];
+
+    // Stats
+    int m_updatedCascades = 0;
+    int m_updatedStaticCascades = 0;
+
     void renderUI() override;
     void updateTexture();
+    void invalidateCache();
+    void setShadowMode(ShadowMode mode);
+    void updateMomentTextures();
+    void updateMomentSampler();
+    void filterMoments(SDL_GPUCommandBuffer *cmd);
+    SDL_GPUTextureSamplerBinding getShadowMapBinding() const;
+    void updateReduceTextures(glm::ivec2 size);
+    void reduceDepth(SDL_GPUCommandBuffer *cmd, SDL_GPUTexture *hiZTexture, glm::ivec2 size, glm::ivec2 region);
+    void setReadbackFence(SDL_GPUFence *fence);
+    void readDepthBounds();
+    void updateShadowMaskTexture(glm::ivec2 size);
+    void renderScreenMask(
+        SDL_GPUCommandBuffer *cmd,
+        SDL_GPUTexture *depthTexture,
+        glm::ivec2 size,
+        glm::ivec2 renderSize,
+        const glm::mat4 &view,
+        const glm::mat4 &projection,
+        const glm::vec3 &viewPos,
+        const glm::vec3 &lightDir);
     void updateCascades(
         Camera *camera,
         const glm::mat4 &view,
         const glm::vec3 &lightDir,
         float aspect);
+    void renderCascades(
+        SDL_GPUCommandBuffer *cmd,
+        const std::vector<Renderable *> &renderables);
+    void renderCasters(
+        SDL_GPUCommandBuffer *cmd,
+        SDL_GPURenderPass *pass,
+        const std::vector<Renderable *> &renderables,
+        const glm::mat4 &lightViewProj,
+        int casterMask);
 };
\ No newline at end of file
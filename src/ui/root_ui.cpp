@@ -5,6 +5,7 @@
 
 #include "../external/imgui/imgui_impl_sdl3.h"
 #include "../external/imgui/imgui_impl_sdlgpu3.h"
+#include "../gpu/gpu.h"
 
 RootUI::RootUI()
     : m_hidden(false)
@@ -84,7 +85,7 @@ void RootUI::render(SDL_GPUCommandBuffer *commandBuffer, SDL_GPUTexture *swapcha
         target_info.mip_level = 0;
         target_info.layer_or_depth_plane = 0;
         target_info.cycle = false;
-        SDL_GPURenderPass *render_pass = SDL_BeginGPURenderPass(commandBuffer, &target_info, 1, nullptr);
+        SDL_GPURenderPass *render_pass = GPU::beginRenderPass(commandBuffer, &target_info, 1, nullptr);
 
         // Render ImGui
         ImGui_ImplSDLGPU3_RenderDrawData(draw_data, commandBuffer, render_pass);
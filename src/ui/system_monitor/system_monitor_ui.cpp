@@ -2,6 +2,8 @@
 
 #include <imgui.h>
 
+#include "../../gpu/gpu.h"
+#include "../../gpu/render_stats.h"
 #include "../../utils/utils.h"
 
 void SystemMonitorUI::renderUI()
@@ -13,4 +15,80 @@ void SystemMonitorUI::renderUI()
     ImGui::Text("FPS: %.1f", io.Framerate);
     uint64_t m_ramUsage = Utils::getRamUsage();
     ImGui::Text("RAM: %.2f MB", static_cast<float>(m_ramUsage) / (1024.0f * 1024.0f));
+
+    const GPUStats &stats = GPU::stats;
+    ImGui::Text("Draws: %u, Pipeline Changes: %u", stats.drawCalls, stats.pipelineChanges);
+    ImGui::Text("Uniforms: %u pushes, %.1f KB", stats.uniformPushes, stats.uniformBytes / 1024.0f);
+
+    GPUMemory &memory = GPU::memory;
+    const float mb = 1024.0f * 1024.0f;
+    ImGui::Text("GPU Memory: %.1f MB, peak %.1f MB", memory.m_total / mb, memory.m_peak / mb);
+    if (ImGui::TreeNode("GPU Memory"))
+    {
+        float budget = memory.m_budget / mb;
+        if (ImGui::DragFloat("Budget MB", &budget, 8.0f, 0.0f, 65536.0f, budget > 0.0f ? "%.0f" : "unlimited", ImGuiSliderFlags_AlwaysClamp))
+            memory.m_budget = (Uint64)(budget * mb);
+        if (memory.overBudget())
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.3f, 1.0f), "Over budget");
+
+        if (ImGui::BeginTable("GPU Memory", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+        {
+            ImGui::TableSetupColumn("Category", ImGuiTableColumnFlags_WidthStretch, 3.0f);
+            ImGui::TableSetupColumn("Count");
+            ImGui::TableSetupColumn("MB");
+            ImGui::TableSetupColumn("Peak MB");
+            ImGui::TableHeadersRow();
+
+            for (int c = 0; c < GPUMemory::CategoryCount; c++)
+            {
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(getCategoryName((GPUMemoryCategory)c));
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", memory.m_counts[c]);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", memory.m_bytes[c] / mb);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", memory.m_peaks[c] / mb);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::TreePop();
+    }
+
+    RenderStats &renderStats = RenderStats::getInstance();
+    if (ImGui::TreeNode("Counters"))
+    {
+        ImGui::Checkbox("Pause", &renderStats.m_paused);
+        ImGui::SameLine();
+        ImGui::TextDisabled("last %d frames", CounterHistory::Size);
+
+        if (ImGui::BeginTable("Counters", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp))
+        {
+            ImGui::TableSetupColumn("Counter", ImGuiTableColumnFlags_WidthStretch, 3.0f);
+            ImGui::TableSetupColumn("Last");
+            ImGui::TableSetupColumn("Min");
+            ImGui::TableSetupColumn("Avg");
+            ImGui::TableSetupColumn("Max");
+            ImGui::TableHeadersRow();
+
+            for (const RenderStats::Counter &counter : renderStats.m_counters)
+            {
+                const CounterHistory &history = counter.history;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(counter.name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f", history.last());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f", history.min());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.1f", history.avg());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.0f", history.max());
+            }
+            ImGui::EndTable();
+        }
+        ImGui::TreePop();
+    }
 }
@@ -129,6 +129,14 @@ public:
     static SDL_Window *window;
     static SDL_GPUSampler *baseSampler;
 
+    // Headless runs have no window, they present into a BGRA8 offscreen target instead
+    static SDL_GPUTextureFormat getPresentFormat()
+    {
+        if (!window)
+            return SDL_GPU_TEXTUREFORMAT_B8G8R8A8_UNORM;
+        return SDL_GetGPUSwapchainTextureFormat(device, window);
+    }
+
     static SDL_GPUShader *loadShader(
         const char *filepath,
         Uint32 numSamplers,
@@ -173,10 +181,70 @@ public:
         return shader;
     }
 
-    static SDL_GPUSampleCount getHighestSupportedMSAA()
+    // Compute resources follow the Metal order: samplers, then read-write storage textures,
+    // uniform buffers, then read-only and read-write storage buffers
+    static SDL_GPUComputePipeline *loadComputePipeline(
+        const char *filepath,
+        Uint32 numSamplers,
+        Uint32 numReadWriteStorageTextures,
+        Uint32 numUniformBuffers,
+        Uint32 threadCountX,
+        Uint32 threadCountY,
+        Uint32 threadCountZ = 1,
+        Uint32 numReadOnlyStorageBuffers = 0,
+        Uint32 numReadWriteStorageBuffers = 0)
+    {
+#if defined(__APPLE__)
+        const SDL_GPUShaderFormat shaderFormat = SDL_GPU_SHADERFORMAT_METALLIB;
+        const char *entryPoint = "main0";
+        const char *extension = ".metallib";
+#else
+        const SDL_GPUShaderFormat shaderFormat = SDL_GPU_SHADERFORMAT_SPIRV;
+        const char *entryPoint = "main";
+        const char *extension = ".spv";
+#endif
+        std::string exePath = Utils::getExecutablePath();
+
+        size_t codeSize;
+        void *shaderCode = SDL_LoadFile(std::string(exePath + "/" + filepath + extension).c_str(), &codeSize);
+        if (!shaderCode)
+        {
+            SDL_Log("Failed to load compute shader!");
+            return NULL;
+        }
+
+        SDL_GPUComputePipelineCreateInfo pipelineInfo = {};
+        pipelineInfo.code_size = codeSize;
+        pipelineInfo.code = (Uint8 *)shaderCode;
+        pipelineInfo.entrypoint = entryPoint;
+        pipelineInfo.format = shaderFormat;
+        pipelineInfo.num_samplers = numSamplers;
+        pipelineInfo.num_readwrite_storage_textures = numReadWriteStorageTextures;
+        pipelineInfo.num_readonly_storage_buffers = numReadOnlyStorageBuffers;
+        pipelineInfo.num_readwrite_storage_buffers = numReadWriteStorageBuffers;
+        pipelineInfo.num_uniform_buffers = numUniformBuffers;
+        pipelineInfo.threadcount_x = threadCountX;
+        pipelineInfo.threadcount_y = threadCountY;
+        pipelineInfo.threadcount_z = threadCountZ;
+
+        SDL_GPUComputePipeline *pipeline = SDL_CreateGPUComputePipeline(device, &pipelineInfo);
+
+        SDL_free(shaderCode);
+
+        return pipeline;
+    }
+
+    // The MSAA targets are the scene color, TAA velocity and depth, the swapchain is never
+    // multisampled (and headless runs have none), so support is asked of those formats
+    static bool supportsSceneMSAA(SDL_GPUSampleCount count)
     {
-        SDL_GPUTextureFormat format = SDL_GetGPUSwapchainTextureFormat(device, window);
+        return SDL_GPUTextureSupportsSampleCount(device, SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT, count) &&
+               SDL_GPUTextureSupportsSampleCount(device, SDL_GPU_TEXTUREFORMAT_R16G16_FLOAT, count) &&
+               SDL_GPUTextureSupportsSampleCount(device, SDL_GPU_TEXTUREFORMAT_D32_FLOAT, count);
+    }
 
+    static SDL_GPUSampleCount getHighestSupportedMSAA()
+    {
         // Check from highest to lowest
         const SDL_GPUSampleCount sampleCounts[] = {
             SDL_GPU_SAMPLECOUNT_8,
@@ -186,7 +254,7 @@ public:
 
         for (SDL_GPUSampleCount count : sampleCounts)
         {
-            if (SDL_GPUTextureSupportsSampleCount(device, format, count))
+            if (supportsSceneMSAA(count))
             {
                 return count;
             }
@@ -198,8 +266,6 @@ public:
 
     static SDL_GPUSampleCount getClosestSupportedMSAA(SDL_GPUSampleCount desiredCount)
     {
-        SDL_GPUTextureFormat format = SDL_GetGPUSwapchainTextureFormat(device, window);
-
         const SDL_GPUSampleCount sampleCounts[] = {
             SDL_GPU_SAMPLECOUNT_8,
             SDL_GPU_SAMPLECOUNT_4,
@@ -210,7 +276,7 @@ public:
         {
             if (currentCount <= desiredCount)
             {
-                if (SDL_GPUTextureSupportsSampleCount(device, format, currentCount))
+                if (supportsSceneMSAA(currentCount))
                 {
                     return currentCount;
                 }